@@ -55,6 +55,16 @@ if(UHD_LOG_FASTPATH_DISABLE)
     add_definitions(-DUHD_LOG_FASTPATH_DISABLE)
 endif()
 
+set(UHD_LOG_BINARY_DISABLE "OFF" CACHE BOOL "Compile out the binary fast-path log statements (UHD_LOG_BINARY_*)")
+if(UHD_LOG_BINARY_DISABLE)
+    add_definitions(-DUHD_LOG_BINARY_DISABLE)
+endif()
+
+set(UHD_TRACE_ENABLE "OFF" CACHE BOOL "Compile in the streaming trace points (UHD_TRACE_*), see uhd/utils/trace.hpp")
+if(UHD_TRACE_ENABLE)
+    add_definitions(-DUHD_TRACE_ENABLE)
+endif()
+
 if(MSVC OR CYGWIN)
     set(UHD_LOG_CONSOLE_COLOR "OFF" CACHE BOOL "Enable color output on the terminal")
 else()
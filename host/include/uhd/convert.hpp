@@ -13,6 +13,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/operators.hpp>
+#include <functional>
 #include <string>
 
 namespace uhd{ namespace convert{
@@ -65,6 +66,9 @@ namespace uhd{ namespace convert{
     //! Implement equality_comparable interface
     UHD_API bool operator==(const id_type &, const id_type &);
 
+    //! Hash a conversion ID, usable with boost::hash and std::hash
+    UHD_API size_t hash_value(const id_type &id);
+
     /*!
      * Register a converter function.
      *
@@ -105,4 +109,15 @@ namespace uhd{ namespace convert{
 
 }} //namespace
 
+namespace std{
+
+    //! Allow conversion IDs as keys of unordered containers
+    template <> struct hash<uhd::convert::id_type>{
+        size_t operator()(const uhd::convert::id_type &id) const{
+            return uhd::convert::hash_value(id);
+        }
+    };
+
+} //namespace std
+
 #endif /* INCLUDED_UHD_CONVERT_HPP */
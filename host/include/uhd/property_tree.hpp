@@ -236,6 +236,59 @@ public:
     //! Get access to a property in the tree
     template <typename T> property<T> &access(const fs_path &path);
 
+    /*!
+     * Get a handle to a property in the tree.
+     *
+     * The path is only looked up once, so code that accesses the same
+     * property many times (e.g., on every tune) can hold on to the handle
+     * instead. The handle keeps the property alive even if it is removed
+     * from the tree.
+     */
+    template <typename T> boost::shared_ptr<property<T> > handle(const fs_path &path);
+
+    //! Subscriber for all properties set in one transaction (absolute paths)
+    typedef boost::function<void(const std::vector<fs_path> &)> batch_subscriber_type;
+
+    /*!
+     * Begin a transaction on the whole tree.
+     *
+     * Until the matching commit_transaction(), properties that are set
+     * from the calling thread store their desired value, but do not
+     * call their subscribers and coercer yet. Transactions may be nested,
+     * only the outermost commit takes effect.
+     */
+    virtual void begin_transaction(void) = 0;
+
+    /*!
+     * Commit a transaction.
+     *
+     * Batch subscribers are called first, once each, with all of their
+     * properties that were set. Then every property that was set is
+     * notified in the order it was first set: desired subscribers
+     * (unless the property has a batch subscriber), coercer and coerced
+     * subscribers, just like a regular set().
+     *
+     * \throws uhd::runtime_error if there is no transaction to commit
+     */
+    virtual void commit_transaction(void) = 0;
+
+    /*!
+     * Register a batch subscriber for the given properties.
+     *
+     * Within a transaction, the batch subscriber replaces the desired
+     * subscribers of these properties. This lets a driver apply many
+     * settings at once, e.g., in a single message to the device.
+     * Outside of transactions, the desired subscribers are called as usual.
+     *
+     * \param paths the properties handled by the batch subscriber
+     * \param subscriber the batch subscriber callback function
+     * \throws uhd::lookup_error if a path does not exist
+     * \throws uhd::runtime_error if a property already has a batch subscriber
+     */
+    virtual void add_batch_subscriber(
+        const std::vector<fs_path> &paths,
+        const batch_subscriber_type &subscriber) = 0;
+
 private:
     //! Internal create property with wild-card type
     virtual void _create(const fs_path &path, const boost::shared_ptr<void> &prop) = 0;
@@ -243,6 +296,10 @@ private:
     //! Internal access property with wild-card type
     virtual boost::shared_ptr<void> &_access(const fs_path &path) const = 0;
 
+    //! Internal make the callback a property uses to defer its notification
+    virtual boost::function<bool(const boost::function<void(bool)> &)>
+        _make_deferrer(const fs_path &path, const void *prop) = 0;
+
 };
 
 } //namespace uhd
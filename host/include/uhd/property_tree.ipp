@@ -20,6 +20,9 @@ namespace uhd{ namespace /*anon*/{
 
 template <typename T> class property_impl : public property<T>{
 public:
+    //! Takes the notification callback, returns true if it was deferred
+    typedef boost::function<bool(const boost::function<void(bool)> &)> deferrer_type;
+
     property_impl<T>(property_tree::coerce_mode_t mode) : _coerce_mode(mode){
         if (_coerce_mode == property_tree::AUTO_COERCE) {
             _coercer = DEFAULT_COERCER;
@@ -67,17 +70,30 @@ public:
         }
     }
 
+    void set_deferrer(const deferrer_type &deferrer){
+        _deferrer = deferrer;
+    }
+
     property<T> &set(const T &value){
         init_or_set_value(_value, value);
-        BOOST_FOREACH(typename property<T>::subscriber_type &dsub, _desired_subscribers){
-            dsub(get_value_ref(_value)); //let errors propagate
+        if (not _deferrer.empty() and _deferrer(notifier(this))) {
+            return *this; //notified when the transaction is committed
+        }
+        notify(true);
+        return *this;
+    }
+
+    void notify(const bool call_desired_subscribers){
+        if (call_desired_subscribers) {
+            BOOST_FOREACH(typename property<T>::subscriber_type &dsub, _desired_subscribers){
+                dsub(get_value_ref(_value)); //let errors propagate
+            }
         }
         if (not _coercer.empty()) {
             _set_coerced(_coercer(get_value_ref(_value)));
         } else {
             if (_coerce_mode == property_tree::AUTO_COERCE) uhd::assertion_error("coercer missing for an auto coerced property");
         }
-        return *this;
     }
 
     property<T> &set_coerced(const T &value){
@@ -110,6 +126,15 @@ public:
     }
 
 private:
+    //! Calls notify() on a property, passed to the deferrer
+    struct notifier{
+        notifier(property_impl<T> *prop): _prop(prop){}
+        void operator()(const bool call_desired_subscribers) const{
+            _prop->notify(call_desired_subscribers);
+        }
+        property_impl<T> *_prop;
+    };
+
     static T DEFAULT_COERCER(const T& value) {
         return value;
     }
@@ -132,6 +157,7 @@ private:
     std::vector<typename property<T>::subscriber_type>  _coerced_subscribers;
     typename property<T>::publisher_type                _publisher;
     typename property<T>::coercer_type                  _coercer;
+    deferrer_type                                       _deferrer;
     boost::scoped_ptr<T>                                _value;
     boost::scoped_ptr<T>                                _coerced_value;
 };
@@ -144,7 +170,10 @@ private:
 namespace uhd{
 
     template <typename T> property<T> &property_tree::create(const fs_path &path, coerce_mode_t coerce_mode){
-        this->_create(path, typename boost::shared_ptr<property<T> >(new property_impl<T>(coerce_mode)));
+        property_impl<T> *prop = new property_impl<T>(coerce_mode);
+        typename boost::shared_ptr<property<T> > sptr(prop);
+        prop->set_deferrer(this->_make_deferrer(path, prop));
+        this->_create(path, sptr);
         return this->access<T>(path);
     }
 
@@ -152,6 +181,10 @@ namespace uhd{
         return *boost::static_pointer_cast<property<T> >(this->_access(path));
     }
 
+    template <typename T> boost::shared_ptr<property<T> > property_tree::handle(const fs_path &path){
+        return boost::static_pointer_cast<property<T> >(this->_access(path));
+    }
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_PROPERTY_TREE_IPP */
@@ -131,6 +131,30 @@ public:
      */
     static sptr make(const make_args_t &make_args, uint64_t noc_id = ~0);
 
+    /*!
+     * \brief Create several block controller classes concurrently.
+     *
+     * Every block is created like with make(). Blocks with the same block
+     * name depend on each other, because their block IDs are counted up in
+     * the order in which they are created. Those blocks are created one
+     * after another, in the order given. Blocks with different names are
+     * created in parallel, on up to \p max_threads threads.
+     *
+     * Every entry in \p make_args needs its own control interfaces, they
+     * must not be shared between blocks.
+     *
+     * \param make_args Valid make args, one per block.
+     * \param noc_ids The 64-Bit NoC-IDs, one per block.
+     * \param max_threads The maximum number of threads. 1 creates all
+     *                    blocks sequentially in the calling thread.
+     * \return the block controllers, in the same order as \p make_args
+     */
+    static std::vector<sptr> make_blocks(
+            const std::vector<make_args_t> &make_args,
+            const std::vector<uint64_t> &noc_ids,
+            const size_t max_threads
+    );
+
     /***********************************************************************
      * Block Communication and Control
      *
@@ -12,6 +12,7 @@
 #include <uhd/types/metadata.hpp>
 #include <uhd/types/device_addr.hpp>
 #include <uhd/types/stream_cmd.hpp>
+#include <uhd/types/stream_stats.hpp>
 #include <uhd/types/ref_vector.hpp>
 #include <boost/utility.hpp>
 #include <boost/shared_ptr.hpp>
@@ -131,6 +132,11 @@ struct UHD_API stream_args_t{
      *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
+     * - recv_batch: (RX only) when set, recv() fills large buffers from
+     * consecutive packets without building per-packet metadata, as long as
+     * their timestamps are contiguous. A gap in time or a new burst ends
+     * the call early, so the next call reports the new time spec.
+     *
      * The following are not implemented, but are listed for conceptual purposes:
      * - function: magnitude or phase/magnitude
      * - units: numeric units like counts or dBm
@@ -224,6 +230,50 @@ public:
         const bool one_packet = false
     ) = 0;
 
+    //! Typedef for a collection of borrowed, read-only wire buffers
+    typedef std::vector<const void *> borrowed_buffs_type;
+
+    /*!
+     * Receive one packet per channel without any conversion or copy.
+     *
+     * Instead of copy-converting samples into user memory, this call
+     * hands out pointers to the payload of the received packets, in the
+     * over-the-wire format (e.g., sc16_item32_be). The pointers reference
+     * the transport's frame buffers directly. This allows applications that
+     * do their own vectorized processing (e.g., an FFT that byteswaps in its
+     * first pass) to skip the converter entirely.
+     *
+     * The buffers are borrowed from the transport and remain valid until
+     * release_borrowed() is called, or until the next call to recv() or
+     * recv_borrowed() (which implicitly release them). Transports only have
+     * a limited number of frames, so borrowed buffers should be released
+     * as soon as possible.
+     *
+     * If a previous call to recv() left a fragment of a packet behind, the
+     * remainder of that packet is returned first.
+     *
+     * Note on threading: Like recv(), this call is *not* thread-safe.
+     *
+     * \param buffs filled with one pointer to the wire payload per channel
+     * \param metadata data to fill describing the buffers
+     * \param timeout the timeout in seconds to wait for a packet
+     * \return the number of wire items available per buffer, or 0 on error
+     * \throws uhd::not_implemented_error if the streamer does not support
+     *         borrowing its buffers
+     */
+    virtual size_t recv_borrowed(
+        borrowed_buffs_type &buffs,
+        rx_metadata_t &metadata,
+        const double timeout = 0.1
+    );
+
+    /*!
+     * Release the buffers handed out by the last call to recv_borrowed().
+     * The pointers returned by recv_borrowed() are invalid afterwards.
+     * Calling this without any borrowed buffers is a no-op.
+     */
+    virtual void release_borrowed(void);
+
     /*!
      * Issue a stream command to the usrp device.
      * This tells the usrp to send samples into the host.
@@ -236,6 +286,15 @@ public:
      * \param stream_cmd the stream command to issue
      */
     virtual void issue_stream_cmd(const stream_cmd_t &stream_cmd) = 0;
+
+    /*!
+     * Get a snapshot of the performance counters of this streamer.
+     * Unlike recv(), this call is thread-safe, and it does not disturb
+     * the streaming thread.
+     * \return the counters accumulated since the streamer was created
+     * \throws uhd::not_implemented_error if the streamer has no counters
+     */
+    virtual stream_stats_t get_stats(void) const;
 };
 
 /*!
@@ -286,6 +345,49 @@ public:
         const double timeout = 0.1
     ) = 0;
 
+    //! Typedef for a collection of borrowed, writable wire buffers
+    typedef std::vector<void *> borrowed_buffs_type;
+
+    /*!
+     * Borrow the payload of the next packet of each channel, to fill it
+     * with samples in the over-the-wire format without any conversion.
+     *
+     * The pointers reference the transport's frame buffers directly. Each
+     * one has room for up to the returned number of wire items (e.g.,
+     * sc16_item32_be). Call send_borrowed() to send the packets once the
+     * payload is written.
+     *
+     * The packet header is written on send_borrowed(), but its length
+     * depends on \p metadata, so the metadata must be given here. Unlike
+     * send(), a start of burst without samples is not cached.
+     *
+     * A call to send() reuses the borrowed buffers, which invalidates the
+     * pointers. Note on threading: Like send(), this call is *not*
+     * thread-safe.
+     *
+     * \param buffs filled with one pointer to the wire payload per channel
+     * \param metadata data describing the contents of the next packets
+     * \param timeout the timeout in seconds to wait for buffers
+     * \return the number of wire items that fit per buffer, or 0 on timeout
+     * \throws uhd::not_implemented_error if the streamer does not support
+     *         borrowing its buffers
+     */
+    virtual size_t borrow_send_buffs(
+        borrowed_buffs_type &buffs,
+        const tx_metadata_t &metadata,
+        const double timeout = 0.1
+    );
+
+    /*!
+     * Send the packets borrowed by the last call to borrow_send_buffs().
+     * The pointers returned by borrow_send_buffs() are invalid afterwards.
+     *
+     * \param nsamps_per_buff the number of wire items written, per buffer
+     * \return the number of samples sent
+     * \throws uhd::runtime_error if there are no borrowed buffers
+     */
+    virtual size_t send_borrowed(const size_t nsamps_per_buff);
+
     /*!
      * Receive and asynchronous message from this TX stream.
      * \param async_metadata the metadata to be filled in
@@ -295,6 +397,15 @@ public:
     virtual bool recv_async_msg(
         async_metadata_t &async_metadata, double timeout = 0.1
     ) = 0;
+
+    /*!
+     * Get a snapshot of the performance counters of this streamer.
+     * Unlike send(), this call is thread-safe, and it does not disturb
+     * the streaming thread.
+     * \return the counters accumulated since the streamer was created
+     * \throws uhd::not_implemented_error if the streamer has no counters
+     */
+    virtual stream_stats_t get_stats(void) const;
 };
 
 } //namespace uhd
@@ -11,6 +11,7 @@
 #include <uhd/config.hpp>
 #include <stdint.h>
 #include <cstddef> //size_t
+#include <vector>
 
 namespace uhd{ namespace transport{
 
@@ -196,6 +197,117 @@ namespace vrt{
         if_packet_info_t &if_packet_info
     );
 
+    /*!
+     * A batch of vrt if packet headers that share one link layer type.
+     *
+     * Unpacking a batch fills in the per-packet `info` structs as well as
+     * struct-of-arrays copies of the fields that are inspected for every
+     * packet (stream ID, fractional timestamp and packet count). Checks that
+     * run over the whole batch, like find_sequence_error(), operate on these
+     * contiguous arrays rather than striding through the info structs.
+     */
+    struct UHD_API if_packet_batch_t
+    {
+        if_packet_batch_t(void);
+
+        //! Resize all arrays to hold the given number of packets
+        void resize(const size_t num_packets);
+
+        //! The number of packets in the batch
+        size_t size(void) const{
+            return info.size();
+        }
+
+        //! Link layer type of every packet in the batch
+        if_packet_info_t::link_type_t link_type;
+
+        //! Per-packet info (num_packet_words32 required in unpack)
+        std::vector<if_packet_info_t> info;
+
+        //! Stream IDs (derived in unpack, 0 when has_sid is false)
+        std::vector<uint32_t> sid;
+        //! Fractional timestamps (derived in unpack, 0 when has_tsf is false)
+        std::vector<uint64_t> tsf;
+        //! Packet counts (derived in unpack)
+        std::vector<uint32_t> packet_count;
+    };
+
+    /*!
+     * Unpack a batch of vrt headers (big endian format).
+     *
+     * This is equivalent to calling if_hdr_unpack_be() on every packet,
+     * except that the link layer is dispatched once for the whole batch and
+     * the struct-of-arrays fields of the batch are filled in as well.
+     *
+     * Requirements are the same as in \ref vrt_unpack_contract, with
+     * `batch.link_type` replacing the per-packet `link_type`.
+     *
+     * \param packet_buffs one pointer per packet to read the vrt header
+     * \param batch the batch of if packet infos (read/write)
+     * \throws uhd::value_error if any of the headers is invalid
+     */
+    UHD_API void if_hdr_unpack_batch_be(
+        const uint32_t *const *packet_buffs,
+        if_packet_batch_t &batch
+    );
+
+    /*!
+     * Unpack a batch of vrt headers (little endian format).
+     *
+     * See if_hdr_unpack_batch_be().
+     *
+     * \param packet_buffs one pointer per packet to read the vrt header
+     * \param batch the batch of if packet infos (read/write)
+     * \throws uhd::value_error if any of the headers is invalid
+     */
+    UHD_API void if_hdr_unpack_batch_le(
+        const uint32_t *const *packet_buffs,
+        if_packet_batch_t &batch
+    );
+
+    /*!
+     * Pack a batch of vrt headers (big endian format).
+     *
+     * This is equivalent to calling if_hdr_pack_be() on every packet, with
+     * the link layer dispatched once for the whole batch. The requirements
+     * of \ref vrt_pack_contract apply to every `batch.info` entry.
+     *
+     * \param packet_buffs one pointer per packet to write the vrt header
+     * \param batch the batch of if packet infos (read/write)
+     */
+    UHD_API void if_hdr_pack_batch_be(
+        uint32_t *const *packet_buffs,
+        if_packet_batch_t &batch
+    );
+
+    /*!
+     * Pack a batch of vrt headers (little endian format).
+     *
+     * See if_hdr_pack_batch_be().
+     *
+     * \param packet_buffs one pointer per packet to write the vrt header
+     * \param batch the batch of if packet infos (read/write)
+     */
+    UHD_API void if_hdr_pack_batch_le(
+        uint32_t *const *packet_buffs,
+        if_packet_batch_t &batch
+    );
+
+    /*!
+     * Find the first packet in an unpacked batch that is out of sequence.
+     *
+     * The packet count wraps according to the link layer of the batch
+     * (4 bits for plain VRT, 12 bits for CHDR and VRLP).
+     *
+     * \param batch an unpacked batch of packets
+     * \param expected_count the packet count expected for the first packet
+     * \return the index of the first bad packet, or batch.size() if none
+     */
+    UHD_API size_t find_sequence_error(
+        const if_packet_batch_t &batch,
+        const size_t expected_count
+    );
+
     UHD_INLINE if_packet_info_t::if_packet_info_t(void):
         link_type(LINK_TYPE_NONE),
 		tsi_type(TSI_TYPE_NONE),
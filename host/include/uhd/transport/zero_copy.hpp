@@ -13,6 +13,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/detail/atomic_count.hpp>
+#include <stdint.h>
 
 namespace uhd{ namespace transport{
 
@@ -200,6 +201,29 @@ namespace uhd{ namespace transport{
          */
         virtual size_t get_send_frame_size(void) const = 0;
 
+        //! Numbers of system calls made by a transport
+        struct syscall_counters_t {
+            syscall_counters_t(void): recv(0), send(0), poll(0) {}
+            //! Calls that receive a frame (recv(), recvfrom(), ...)
+            uint64_t recv;
+            //! Calls that send a frame
+            uint64_t send;
+            //! Calls that wait for a frame (poll(), select(), ...)
+            uint64_t poll;
+        };
+
+        /*!
+         * Get the number of system calls this transport made so far.
+         * This is meant for benchmarking the cost of a frame. Transports
+         * that do not count their system calls return zeros, transports
+         * that wrap another one return the counts of the wrapped one.
+         * \return the counters since the transport was made
+         */
+        virtual syscall_counters_t get_syscall_counters(void) const
+        {
+            return syscall_counters_t();
+        }
+
     };
 
 }} //namespace
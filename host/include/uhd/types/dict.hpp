@@ -9,6 +9,10 @@
 #define INCLUDED_UHD_TYPES_DICT_HPP
 
 #include <uhd/config.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <list>
 
@@ -17,13 +21,38 @@ namespace uhd{
     /*!
      * A templated dictionary class with a python-like interface.
      */
+    /*!
+     * A dictionary that keeps its keys in insertion order.
+     *
+     * Small dicts are searched linearly. Once a dict grows past
+     * INDEX_THRESHOLD entries, lookups go through a hash index instead,
+     * provided the key type can be hashed with boost::hash (strings,
+     * integers, enums, pointers, ...). Other key types only need to be
+     * equality comparable and are always searched linearly.
+     */
     template <typename Key, typename Val> class dict{
     public:
+        //! Number of entries above which lookups use the hash index
+        static const std::size_t INDEX_THRESHOLD = 8;
+
         /*!
          * Create a new empty dictionary.
          */
         dict(void);
 
+        /*!
+         * Copy constructor.
+         * \param other the dict to copy
+         */
+        dict(const dict<Key, Val> &other);
+
+        /*!
+         * Assignment operator.
+         * \param other the dict to copy
+         * \return a reference to this dict
+         */
+        dict<Key, Val> &operator=(const dict<Key, Val> &other);
+
         /*!
          * Input iterator constructor:
          * Makes boost::assign::map_list_of work.
@@ -140,7 +169,21 @@ namespace uhd{
 
     private:
         typedef std::pair<Key, Val> pair_t;
+        typedef typename std::list<pair_t>::iterator iterator_t;
+        typedef std::unordered_map<Key, iterator_t, boost::hash<Key> > index_t;
+        typedef std::integral_constant<bool, false> no_index_t;
+        typedef std::integral_constant<bool, true> has_index_t;
+
+        iterator_t _find(const Key &key) const;
+        iterator_t _find(const Key &key, has_index_t) const;
+        iterator_t _find(const Key &key, no_index_t) const;
+        void _update_index(has_index_t);
+        void _update_index(no_index_t){}
+        void _erase_index(const Key &key, has_index_t);
+        void _erase_index(const Key &, no_index_t){}
+
         std::list<pair_t> _map; //private container
+        boost::scoped_ptr<index_t> _index; //key lookup, once past the threshold
     };
 
 } //namespace uhd
@@ -13,6 +13,7 @@
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <typeinfo>
+#include <utility>
 
 namespace uhd{
 
@@ -29,6 +30,16 @@ namespace uhd{
                 /* NOP */
             }
         };
+
+        //! Check if boost::hash supports a key type (through hash_value)
+        using boost::hash_value;
+        template<typename Key>
+        struct key_is_hashable{
+            template<typename T> static std::true_type check(
+                decltype(hash_value(std::declval<const T &>())) *);
+            template<typename T> static std::false_type check(...);
+            typedef decltype(check<Key>(nullptr)) type;
+        };
     } // namespace /*anon*/
 
     template <typename Key, typename Val>
@@ -40,7 +51,24 @@ namespace uhd{
     dict<Key, Val>::dict(InputIterator first, InputIterator last):
         _map(first, last)
     {
-        /* NOP */
+        _update_index(typename key_is_hashable<Key>::type());
+    }
+
+    template <typename Key, typename Val>
+    dict<Key, Val>::dict(const dict<Key, Val> &other):
+        _map(other._map)
+    {
+        _update_index(typename key_is_hashable<Key>::type());
+    }
+
+    template <typename Key, typename Val>
+    dict<Key, Val> &dict<Key, Val>::operator=(const dict<Key, Val> &other){
+        if (this != &other){
+            _index.reset();
+            _map = other._map;
+            _update_index(typename key_is_hashable<Key>::type());
+        }
+        return *this;
     }
 
     template <typename Key, typename Val>
@@ -51,6 +79,7 @@ namespace uhd{
     template <typename Key, typename Val>
     std::vector<Key> dict<Key, Val>::keys(void) const{
         std::vector<Key> keys;
+        keys.reserve(_map.size());
         BOOST_FOREACH(const pair_t &p, _map){
             keys.push_back(p.first);
         }
@@ -60,6 +89,7 @@ namespace uhd{
     template <typename Key, typename Val>
     std::vector<Val> dict<Key, Val>::vals(void) const{
         std::vector<Val> vals;
+        vals.reserve(_map.size());
         BOOST_FOREACH(const pair_t &p, _map){
             vals.push_back(p.second);
         }
@@ -68,26 +98,21 @@ namespace uhd{
 
     template <typename Key, typename Val>
     bool dict<Key, Val>::has_key(const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return true;
-        }
-        return false;
+        return _find(key) != _map.end();
     }
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::get(const Key &key, const Val &other) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        return other;
+        const iterator_t it = _find(key);
+        if (it == _map.end()) return other;
+        return it->second;
     }
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::get(const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        throw key_not_found<Key, Val>(key);
+        const iterator_t it = _find(key);
+        if (it == _map.end()) throw key_not_found<Key, Val>(key);
+        return it->second;
     }
 
     template <typename Key, typename Val>
@@ -97,18 +122,15 @@ namespace uhd{
 
     template <typename Key, typename Val>
     const Val &dict<Key, Val>::operator[](const Key &key) const{
-        BOOST_FOREACH(const pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
-        throw key_not_found<Key, Val>(key);
+        return this->get(key);
     }
 
     template <typename Key, typename Val>
     Val &dict<Key, Val>::operator[](const Key &key){
-        BOOST_FOREACH(pair_t &p, _map){
-            if (p.first == key) return p.second;
-        }
+        const iterator_t it = _find(key);
+        if (it != _map.end()) return it->second;
         _map.push_back(std::make_pair(key, Val()));
+        _update_index(typename key_is_hashable<Key>::type());
         return _map.back().second;
     }
 
@@ -132,15 +154,12 @@ namespace uhd{
 
     template <typename Key, typename Val>
     Val dict<Key, Val>::pop(const Key &key){
-        typename std::list<pair_t>::iterator it;
-        for (it = _map.begin(); it != _map.end(); it++){
-            if (it->first == key){
-                Val val = it->second;
-                _map.erase(it);
-                return val;
-            }
-        }
-        throw key_not_found<Key, Val>(key);
+        const iterator_t it = _find(key);
+        if (it == _map.end()) throw key_not_found<Key, Val>(key);
+        Val val = it->second;
+        _erase_index(key, typename key_is_hashable<Key>::type());
+        _map.erase(it);
+        return val;
     }
 
     template <typename Key, typename Val>
@@ -157,6 +176,50 @@ namespace uhd{
         }
     }
 
+    template <typename Key, typename Val>
+    typename dict<Key, Val>::iterator_t dict<Key, Val>::_find(const Key &key) const{
+        return _find(key, typename key_is_hashable<Key>::type());
+    }
+
+    template <typename Key, typename Val>
+    typename dict<Key, Val>::iterator_t dict<Key, Val>::_find(const Key &key, has_index_t) const{
+        if (not _index) return _find(key, no_index_t());
+        const typename index_t::const_iterator it = _index->find(key);
+        if (it == _index->end()) return const_cast<std::list<pair_t> &>(_map).end();
+        return it->second;
+    }
+
+    template <typename Key, typename Val>
+    typename dict<Key, Val>::iterator_t dict<Key, Val>::_find(const Key &key, no_index_t) const{
+        //the iterator is only handed out as const by the const accessors
+        std::list<pair_t> &map = const_cast<std::list<pair_t> &>(_map);
+        for (iterator_t it = map.begin(); it != map.end(); ++it){
+            if (it->first == key) return it;
+        }
+        return map.end();
+    }
+
+    template <typename Key, typename Val>
+    void dict<Key, Val>::_update_index(has_index_t){
+        if (_index){
+            //a new key was appended at the back
+            iterator_t last = _map.end();
+            _index->insert(std::make_pair((--last)->first, last));
+            return;
+        }
+        if (_map.size() <= INDEX_THRESHOLD) return;
+        _index.reset(new index_t(_map.size()));
+        for (iterator_t it = _map.begin(); it != _map.end(); ++it){
+            //keep the first of any duplicate keys, like the linear search
+            _index->insert(std::make_pair(it->first, it));
+        }
+    }
+
+    template <typename Key, typename Val>
+    void dict<Key, Val>::_erase_index(const Key &key, has_index_t){
+        if (_index) _index->erase(key);
+    }
+
 } //namespace uhd
 
 #endif /* INCLUDED_UHD_TYPES_DICT_IPP */
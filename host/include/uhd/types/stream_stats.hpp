@@ -0,0 +1,141 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_TYPES_STREAM_STATS_HPP
+#define INCLUDED_UHD_TYPES_STREAM_STATS_HPP
+
+#include <uhd/config.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace uhd{
+
+    /*!
+     * Histogram of durations, in nanoseconds.
+     *
+     * The buckets are powers of two: bucket i counts the durations d with
+     * 2^i <= d < 2^(i+1) ns, bucket 0 also counts durations of 0 ns.
+     * The struct is plain data, so it can be copied into shared memory.
+     */
+    struct UHD_API duration_histogram_t{
+        //! Number of buckets, the last one ends at 2^40 ns (about 18 min)
+        static const size_t NUM_BUCKETS = 40;
+
+        //! Create an empty histogram
+        duration_histogram_t(void);
+
+        //! Number of durations recorded
+        uint64_t count;
+
+        //! Sum of all durations recorded, in ns
+        uint64_t total_ns;
+
+        //! Longest duration recorded, in ns
+        uint64_t max_ns;
+
+        //! Number of durations per bucket
+        uint64_t buckets[NUM_BUCKETS];
+
+        //! Get the bucket a duration falls into
+        static size_t get_bucket(const uint64_t ns);
+
+        //! Get the mean duration in ns, or 0 for an empty histogram
+        double get_mean_ns(void) const;
+
+        /*!
+         * Get an upper bound for a percentile of the durations.
+         * The result is the end of the bucket which holds the percentile,
+         * so it is exact to within a factor of two.
+         * \param percentile the percentile, from 0 to 100
+         * \return the upper bound in ns, or 0 for an empty histogram
+         */
+        uint64_t get_percentile_ns(const double percentile) const;
+
+        //! Convert the histogram to a one-line summary
+        std::string to_pp_string(void) const;
+    };
+
+    /*!
+     * Performance counters of a streamer.
+     *
+     * A streamer updates its counters from the streaming thread without
+     * locks, and get_stats() takes a snapshot of them. Each field of the
+     * snapshot is consistent on its own, but the fields may be off by the
+     * packet or call that was in flight while the snapshot was taken.
+     *
+     * The counters apply to both RX and TX streamers unless noted
+     * otherwise. They count from the creation of the streamer.
+     */
+    struct UHD_API stream_stats_t{
+        //! Create a snapshot with all counters at zero
+        stream_stats_t(void);
+
+        //! Number of data packets received or sent, over all channels
+        uint64_t packets;
+
+        //! Number of bytes on the wire, including headers, over all channels
+        uint64_t bytes;
+
+        //! Number of samples per channel returned by recv() or accepted by send()
+        uint64_t samples;
+
+        //! Number of recv() or send() calls which timed out
+        uint64_t timeouts;
+
+        //! RX: Number of overflows reported by the device
+        uint64_t overflows;
+
+        //! TX: Number of underflows, as reported through recv_async_msg()
+        uint64_t underflows;
+
+        /*!
+         * Number of sequence errors. RX: Packets which were dropped on the
+         * way to the host. TX: Sequence errors reported through
+         * recv_async_msg().
+         */
+        uint64_t sequence_errors;
+
+        /*!
+         * RX: Number of late stream commands. TX: Number of timed bursts
+         * which reached the transport after their time (counted when the
+         * streamer can read the device time), plus time errors reported
+         * through recv_async_msg().
+         */
+        uint64_t late;
+
+        //! Duration of recv() or send() calls
+        duration_histogram_t call_time;
+
+        //! Time spent in the converter, per packet over all channels
+        duration_histogram_t convert_time;
+
+        /*!
+         * TX: Time spent waiting for a transport buffer, per packet. This
+         * includes waiting for flow control credit.
+         */
+        duration_histogram_t fc_wait_time;
+
+        /*!
+         * Time spent in the transport, per packet. RX: Waiting for the
+         * transport to return a packet, which includes waiting for the
+         * device to send it. TX: Committing a packet to the transport.
+         */
+        duration_histogram_t xport_time;
+
+        /*!
+         * TX: For timed bursts, the time left from sending the first packet
+         * until the burst's time spec. Only recorded when the streamer can
+         * read the device time.
+         */
+        duration_histogram_t deadline_time;
+
+        //! Convert the counters to a printable multi-line summary
+        std::string to_pp_string(void) const;
+    };
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_TYPES_STREAM_STATS_HPP */
@@ -0,0 +1,90 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_STREAM_STATS_EXPORTER_HPP
+#define INCLUDED_UHD_UTILS_STREAM_STATS_EXPORTER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/stream_stats.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace uhd{
+
+    /*!
+     * Publishes the performance counters of a streamer in shared memory.
+     *
+     * The exporter creates a named shared memory segment, and copies the
+     * streamer's get_stats() snapshot into it periodically from its own
+     * thread. Other processes can read the segment with read() (or the
+     * uhd_stream_stats utility) at any time, without any locks, so neither
+     * the streaming thread nor the exporter ever waits for a reader.
+     *
+     * The segment is removed when the exporter is destroyed. The exporter
+     * only holds a weak reference to the streamer, and stops updating the
+     * segment once the streamer is gone.
+     *
+     * Example:
+     * \code{.cpp}
+     * uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
+     * uhd::stream_stats_exporter::sptr exporter =
+     *     uhd::stream_stats_exporter::make(rx_stream, "my_app_rx");
+     * // elsewhere: uhd_stream_stats --name my_app_rx
+     * \endcode
+     */
+    class UHD_API stream_stats_exporter : boost::noncopyable{
+    public:
+        typedef boost::shared_ptr<stream_stats_exporter> sptr;
+
+        virtual ~stream_stats_exporter(void) = 0;
+
+        /*!
+         * Export the counters of an RX streamer.
+         * \param streamer the streamer to export the counters of
+         * \param name the name of the shared memory segment
+         * \param interval the time between updates, in seconds
+         * \return a new exporter
+         * \throws uhd::runtime_error if the segment cannot be created
+         */
+        static sptr make(
+            rx_streamer::sptr streamer,
+            const std::string &name,
+            const double interval = 1.0
+        );
+
+        /*!
+         * Export the counters of a TX streamer.
+         * \param streamer the streamer to export the counters of
+         * \param name the name of the shared memory segment
+         * \param interval the time between updates, in seconds
+         * \return a new exporter
+         * \throws uhd::runtime_error if the segment cannot be created
+         */
+        static sptr make(
+            tx_streamer::sptr streamer,
+            const std::string &name,
+            const double interval = 1.0
+        );
+
+        //! Get the number of times the segment was updated
+        virtual uint64_t get_num_updates(void) = 0;
+
+        /*!
+         * Read the latest counters from a segment.
+         * \param name the name of the shared memory segment
+         * \param stats filled with the counters
+         * \return the number of updates of the segment so far, or 0 if
+         *         there is no segment by this name or it has no data yet
+         */
+        static uint64_t read(const std::string &name, stream_stats_t &stats);
+    };
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_STREAM_STATS_EXPORTER_HPP */
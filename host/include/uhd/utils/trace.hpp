@@ -0,0 +1,73 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_TRACE_HPP
+#define INCLUDED_UHD_UTILS_TRACE_HPP
+
+#include <uhd/config.hpp>
+#include <string>
+
+/*! \file trace.hpp
+ *
+ * Control of the streaming trace recorder.
+ *
+ * When UHD is built with UHD_TRACE_ENABLE, the streamers, the device flow
+ * control and the transports carry trace points. While tracing is enabled,
+ * every thread that passes a trace point records its events into its own
+ * ring buffer, which always holds the most recent events of that thread.
+ * dump() writes the contents of all rings as a Chrome trace (JSON), which
+ * can be opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Events carry the host time, and, where one is known, the device time in
+ * their arguments.
+ *
+ * Setting the environment variable UHD_TRACE_FILE enables tracing when the
+ * first trace point is passed, and arms the trigger with the given file.
+ */
+
+namespace uhd { namespace trace {
+
+    //! True if UHD was built with the trace points (UHD_TRACE_ENABLE)
+    UHD_API bool is_compiled_in(void);
+
+    //! Start or stop recording events
+    UHD_API void set_enabled(const bool enable);
+
+    //! True while events are recorded
+    UHD_API bool get_enabled(void);
+
+    /*!
+     * Write the recorded events to a file.
+     * \param path the file to write the Chrome trace JSON to
+     * \return the number of events written
+     * \throws uhd::runtime_error if the file cannot be written
+     */
+    UHD_API size_t dump(const std::string &path);
+
+    //! Discard all recorded events
+    UHD_API void clear(void);
+
+    /*!
+     * Arm the trigger: The next trigger event (e.g., a TX underflow) dumps
+     * the recorded events to the given file, from a background thread.
+     * Only the first trigger after arming writes the file, so it shows what
+     * led up to the first problem. An empty path disarms the trigger.
+     * \param path the file to dump to on the next trigger
+     */
+    UHD_API void set_trigger_file(const std::string &path);
+
+    /*!
+     * Fire the trigger. This is what the trace points call on underflow.
+     * \param reason a static string describing the cause
+     */
+    UHD_API void trigger(const char *reason);
+
+    //! Get the number of trigger dumps written since the process started
+    UHD_API size_t get_num_trigger_dumps(void);
+
+}} /* namespace uhd::trace */
+
+#endif /* INCLUDED_UHD_UTILS_TRACE_HPP */
@@ -12,7 +12,10 @@
 #include <uhd/exception.hpp>
 #include <stdint.h>
 #include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
 #include <complex>
+#include <map>
+#include <unordered_map>
 
 using namespace uhd;
 
@@ -29,6 +32,15 @@ bool convert::operator==(const convert::id_type &lhs, const convert::id_type &rh
     ;
 }
 
+size_t convert::hash_value(const convert::id_type &id){
+    size_t seed = 0;
+    boost::hash_combine(seed, id.input_format);
+    boost::hash_combine(seed, id.num_inputs);
+    boost::hash_combine(seed, id.output_format);
+    boost::hash_combine(seed, id.num_outputs);
+    return seed;
+}
+
 std::string convert::id_type::to_pp_string(void) const{
     return str(boost::format(
         "conversion ID\n"
@@ -55,8 +67,68 @@ std::string convert::id_type::to_string(void) const{
 
 /***********************************************************************
  * Setup the table registry
+ *
+ * Format strings are interned into small integers when converters are
+ * registered, so a conversion ID reduces to one 64-bit key. Every entry
+ * also caches its best priority, which makes a lookup two string hashes
+ * and one integer hash, independent of the number of registered routines.
  **********************************************************************/
-typedef uhd::dict<convert::id_type, uhd::dict<convert::priority_type, convert::function_type> > fcn_table_type;
+namespace {
+
+    typedef uint64_t fcn_key_type;
+
+    struct fcn_entry_type{
+        std::map<convert::priority_type, convert::function_type> prios;
+        convert::priority_type best_prio;
+    };
+
+    struct fcn_table_type{
+        std::unordered_map<std::string, uint16_t> formats;
+        std::unordered_map<fcn_key_type, fcn_entry_type> entries;
+
+        //! Look up (or intern) a format string, false if unknown
+        bool get_format_index(
+            const std::string &format, uint16_t &index, const bool intern
+        ){
+            auto it = formats.find(format);
+            if (it != formats.end()){
+                index = it->second;
+                return true;
+            }
+            if (not intern) return false;
+            if (formats.size() > 0xffff) throw uhd::runtime_error(
+                "Too many converter formats registered");
+            index = uint16_t(formats.size());
+            formats[format] = index;
+            return true;
+        }
+
+        //! Reduce a conversion ID to its table key, false if unknown
+        bool get_key(
+            const convert::id_type &id, fcn_key_type &key, const bool intern
+        ){
+            uint16_t in_index, out_index;
+            if (id.num_inputs > 0xffff or id.num_outputs > 0xffff) return false;
+            if (not get_format_index(id.input_format, in_index, intern)) return false;
+            if (not get_format_index(id.output_format, out_index, intern)) return false;
+            key = (fcn_key_type(in_index) << 48)
+                | (fcn_key_type(id.num_inputs) << 32)
+                | (fcn_key_type(out_index) << 16)
+                | (fcn_key_type(id.num_outputs));
+            return true;
+        }
+
+        //! Find the entry for a conversion ID, or nullptr
+        const fcn_entry_type *find(const convert::id_type &id){
+            fcn_key_type key;
+            if (not get_key(id, key, false)) return nullptr;
+            auto it = entries.find(key);
+            return (it == entries.end())? nullptr : &it->second;
+        }
+    };
+
+} // namespace
+
 UHD_SINGLETON_FCN(fcn_table_type, get_table);
 
 /***********************************************************************
@@ -67,7 +139,13 @@ void uhd::convert::register_converter(
     const function_type &fcn,
     const priority_type prio
 ){
-    get_table()[id][prio] = fcn;
+    fcn_key_type key;
+    if (not get_table().get_key(id, key, true)) throw uhd::value_error(
+        "Cannot register a conversion routine for " + id.to_pp_string());
+
+    fcn_entry_type &entry = get_table().entries[key];
+    entry.prios[prio] = fcn;
+    entry.best_prio = entry.prios.rbegin()->first;
 
     //----------------------------------------------------------------//
     //UHD_LOG_TRACE("CONVERT", boost::format("register_converter: %s prio: %s") % id.to_string() % prio)
@@ -81,34 +159,24 @@ convert::function_type convert::get_converter(
     const id_type &id,
     const priority_type prio
 ){
-    if (not get_table().has_key(id)) throw uhd::key_error(
+    const fcn_entry_type *entry = get_table().find(id);
+    if (entry == nullptr) throw uhd::key_error(
         "Cannot find a conversion routine for " + id.to_pp_string());
 
-    //find a matching priority
-    priority_type best_prio = -1;
-    for(priority_type prio_i:  get_table()[id].keys()){
-        if (prio_i == prio) {
-            //----------------------------------------------------------------//
-            UHD_LOGGER_DEBUG("CONVERT") << "get_converter: For converter ID: " << id.to_pp_string()
-                                        << " Using prio: " << prio;
-            ;
-            //----------------------------------------------------------------//
-            return get_table()[id][prio];
-        }
-        best_prio = std::max(best_prio, prio_i);
-    }
+    //use the best prio, unless a specific one was requested
+    const priority_type use_prio = (prio == -1)? entry->best_prio : prio;
+    auto it = entry->prios.find(use_prio);
 
     //wanted a specific prio, didnt find
-    if (prio != -1) throw uhd::key_error(
+    if (it == entry->prios.end()) throw uhd::key_error(
         "Cannot find a conversion routine [with prio] for " + id.to_pp_string());
 
     //----------------------------------------------------------------//
     UHD_LOGGER_DEBUG("CONVERT") << "get_converter: For converter ID: " << id.to_pp_string()
-                                << " Using prio: " << best_prio;
+                                << " Using prio: " << use_prio;
     //----------------------------------------------------------------//
 
-    //otherwise, return best prio
-    return get_table()[id][best_prio];
+    return it->second;
 }
 
 /***********************************************************************
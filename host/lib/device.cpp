@@ -13,6 +13,7 @@
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/algorithm.hpp>
 #include <uhdlib/utils/prefs.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 
 #include <boost/format.hpp>
 #include <boost/weak_ptr.hpp>
@@ -181,8 +182,10 @@ device::sptr device::make(const device_addr_t &hint, device_filter_t filter, siz
     else {
         // Add keys from the config files (note: the user-defined keys will
         // always be applied, see also get_usrp_args()
-        // Then, create and register a new device.
-        device::sptr dev = maker(prefs::get_usrp_args(dev_addr));
+        // Then, place the threads, and create and register a new device.
+        const device_addr_t usrp_args = prefs::get_usrp_args(dev_addr);
+        thread_policy::update(usrp_args);
+        device::sptr dev = maker(usrp_args);
         hash_to_device[dev_hash] = dev;
         return dev;
     }
@@ -19,6 +19,7 @@
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <vector>
 
 #ifdef UHD_EXPERT_LOGGING
 #define EX_LOG(depth, str) _log(depth, str)
@@ -40,6 +41,7 @@ typedef boost::adjacency_list<
 
 typedef std::map<std::string, expert_graph_t::vertex_descriptor> vertex_map_t;
 typedef std::list<expert_graph_t::vertex_descriptor>             node_queue_t;
+typedef std::vector<expert_graph_t::vertex_descriptor>           node_list_t;
 
 typedef boost::graph_traits<expert_graph_t>::edge_iterator       edge_iter;
 typedef boost::graph_traits<expert_graph_t>::vertex_iterator     vertex_iter;
@@ -62,7 +64,7 @@ private:    //Visitor class for cycle detection algorithm
 
 public:
     expert_container_impl(const std::string& name):
-        _name(name)
+        _name(name), _sorted_valid(false)
     {
     }
 
@@ -82,27 +84,39 @@ public:
         boost::lock_guard<boost::mutex> lock(_mutex);
         EX_LOG(0, str(boost::format("resolve_all(%s)") % (force?"force":"")));
         // Do a full resolve of the graph
-        _resolve_helper("", "", force);
+        _update_sorted_nodes();
+        _resolve_helper(_sorted_nodes, force);
     }
 
-    void resolve_from(const std::string&)
+    void resolve_from(const std::string& node_name)
     {
         boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
         boost::lock_guard<boost::mutex> lock(_mutex);
-        EX_LOG(0, "resolve_from (overridden to resolve_all)");
-        // Do a full resolve of the graph
-        // Not optimizing the traversal using node_name to reduce experts complexity
-        _resolve_helper("", "", false);
+        EX_LOG(0, str(boost::format("resolve_from(%s)") % node_name));
+        // Only the node and everything that depends on it can be affected.
+        // The dependencies of those nodes are included too, so that no
+        // worker consumes an input that is still waiting to be resolved.
+        _update_sorted_nodes();
+        const expert_graph_t::vertex_descriptor start = _lookup_vertex(node_name);
+        if (not _downstream_cache.count(start)) {
+            _downstream_cache[start] = _get_reachable(
+                _get_reachable(node_list_t(1, start), _children), _parents);
+        }
+        _resolve_helper(_downstream_cache[start], false);
     }
 
-    void resolve_to(const std::string&)
+    void resolve_to(const std::string& node_name)
     {
         boost::lock_guard<boost::recursive_mutex> resolve_lock(_resolve_mutex);
         boost::lock_guard<boost::mutex> lock(_mutex);
-        EX_LOG(0, "resolve_to (overridden to resolve_all)");
-        // Do a full resolve of the graph
-        // Not optimizing the traversal using node_name to reduce experts complexity
-        _resolve_helper("", "", false);
+        EX_LOG(0, str(boost::format("resolve_to(%s)") % node_name));
+        // Only the node and everything it depends on is needed
+        _update_sorted_nodes();
+        const expert_graph_t::vertex_descriptor stop = _lookup_vertex(node_name);
+        if (not _upstream_cache.count(stop)) {
+            _upstream_cache[stop] = _get_reachable(node_list_t(1, stop), _parents);
+        }
+        _resolve_helper(_upstream_cache[stop], false);
     }
 
     dag_vertex_t& retrieve(const std::string& name) const
@@ -292,6 +306,7 @@ protected:
 
         try {
             //Add a vertex in this graph for the data node
+            _invalidate_sorted_nodes();
             expert_graph_t::vertex_descriptor gr_node = boost::add_vertex(data_node, _expert_dag);
             EX_LOG(1, str(boost::format("added vertex %s") % data_node->get_name()));
             _datanode_map.insert(vertex_map_t::value_type(data_node->get_name(), gr_node));
@@ -331,6 +346,7 @@ protected:
 
         try {
             //Add a vertex in this graph for the worker node
+            _invalidate_sorted_nodes();
             expert_graph_t::vertex_descriptor gr_node = boost::add_vertex(worker, _expert_dag);
             EX_LOG(1, str(boost::format("added vertex %s") % worker->get_name()));
             _worker_map.insert(vertex_map_t::value_type(worker->get_name(), gr_node));
@@ -392,6 +408,7 @@ protected:
 
         // Release all vertices and edges in the DAG
         _expert_dag.clear();
+        _invalidate_sorted_nodes();
 
         // Release all nodes in the map
         _worker_map.clear();
@@ -399,8 +416,22 @@ protected:
     }
 
 private:
-    void _resolve_helper(std::string start, std::string stop, bool force)
+    //! Drop the cached sort order, must be called whenever the graph changes
+    void _invalidate_sorted_nodes()
+    {
+        _sorted_valid = false;
+        _sorted_nodes.clear();
+        _children.clear();
+        _parents.clear();
+        _downstream_cache.clear();
+        _upstream_cache.clear();
+    }
+
+    //! Sort the graph topologically, unless the cached order is still valid
+    void _update_sorted_nodes()
     {
+        if (_sorted_valid) return;
+
         //Sort the graph topologically. This ensures that for all dependencies, the dependant
         //is always after all of its dependencies.
         node_queue_t sorted_nodes;
@@ -419,44 +450,72 @@ private:
                                          "The following back-edges were found:" + edges);
             }
         }
-        if (sorted_nodes.empty()) return;
+        _sorted_nodes.assign(sorted_nodes.begin(), sorted_nodes.end());
+
+        //Store the edges in both directions, indexed by vertex, for finding
+        //the nodes that are affected by resolve_from() and resolve_to()
+        const size_t num_vertices = boost::num_vertices(_expert_dag);
+        _children.assign(num_vertices, node_list_t());
+        _parents.assign(num_vertices, node_list_t());
+        for (std::pair<edge_iter, edge_iter> ei = boost::edges(_expert_dag);
+             ei.first != ei.second;
+             ++ei.first
+        ) {
+            const expert_graph_t::vertex_descriptor src = boost::source(*ei.first, _expert_dag);
+            const expert_graph_t::vertex_descriptor dst = boost::target(*ei.first, _expert_dag);
+            _children[src].push_back(dst);
+            _parents[dst].push_back(src);
+        }
+        _sorted_valid = true;
+    }
+
+    //! Return all vertices reachable from \p starts through \p edges
+    //  (including \p starts themselves), in topological order
+    node_list_t _get_reachable(
+        const node_list_t& starts,
+        const std::vector<node_list_t>& edges
+    ) const {
+        std::vector<bool> reached(edges.size(), false);
+        node_list_t to_visit(starts);
+        for (const expert_graph_t::vertex_descriptor v : starts) {
+            reached[v] = true;
+        }
+        while (not to_visit.empty()) {
+            const expert_graph_t::vertex_descriptor v = to_visit.back();
+            to_visit.pop_back();
+            for (const expert_graph_t::vertex_descriptor next : edges[v]) {
+                if (not reached[next]) {
+                    reached[next] = true;
+                    to_visit.push_back(next);
+                }
+            }
+        }
 
-        //Determine the start and stop node. If one is not explicitly specified then
-        //resolve everything
-        expert_graph_t::vertex_descriptor start_vertex = sorted_nodes.front();
-        expert_graph_t::vertex_descriptor stop_vertex = sorted_nodes.back();
-        if (not start.empty()) start_vertex = _lookup_vertex(start);
-        if (not stop.empty()) stop_vertex = _lookup_vertex(stop);
+        node_list_t reachable;
+        for (const expert_graph_t::vertex_descriptor v : _sorted_nodes) {
+            if (reached[v]) reachable.push_back(v);
+        }
+        return reachable;
+    }
 
+    //! Resolve \p nodes (which must be in topological order)
+    void _resolve_helper(const node_list_t& nodes, bool force)
+    {
         //First Pass: Resolve all nodes if they are dirty, in a topological order
         std::list<dag_vertex_t*> resolved_workers;
-        bool start_node_encountered = false;
-        for (node_queue_t::iterator node_iter = sorted_nodes.begin();
-             node_iter != sorted_nodes.end();
-             ++node_iter
-        ) {
-            //Determine if we are at or beyond the starting node
-            if (*node_iter == start_vertex) start_node_encountered = true;
-
-            //Only resolve if the starting node has passed
-            if (start_node_encountered) {
-                dag_vertex_t& node = _get_vertex(*node_iter);
-                std::string node_val;
-                if (force or node.is_dirty()) {
-                    node.resolve();
-                    if (node.get_class() == CLASS_WORKER) {
-                        resolved_workers.push_back(&node);
-                    }
-                    EX_LOG(1, str(boost::format("resolved node %s (%s) [%s]") %
-                                    node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
-                } else {
-                    EX_LOG(1, str(boost::format("skipped node %s (%s) [%s]") %
-                                    node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
+        for (const expert_graph_t::vertex_descriptor vertex : nodes) {
+            dag_vertex_t& node = _get_vertex(vertex);
+            if (force or node.is_dirty()) {
+                node.resolve();
+                if (node.get_class() == CLASS_WORKER) {
+                    resolved_workers.push_back(&node);
                 }
+                EX_LOG(1, str(boost::format("resolved node %s (%s) [%s]") %
+                                node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
+            } else {
+                EX_LOG(1, str(boost::format("skipped node %s (%s) [%s]") %
+                                node.get_name() % (node.is_dirty()?"dirty":"clean") % node.to_string()));
             }
-
-            //Determine if we are beyond the stop node
-            if (*node_iter == stop_vertex) break;
         }
 
         //Second Pass: Mark all the workers clean. The policy is that a worker will mark all of
@@ -513,6 +572,13 @@ private:
     vertex_map_t            _datanode_map;      //A map from vertex name to vertex descriptor for data nodes
     boost::mutex            _mutex;
     boost::recursive_mutex  _resolve_mutex;
+    //Caches for resolution, only valid while the graph doesn't change
+    bool                    _sorted_valid;
+    node_list_t             _sorted_nodes;      //All vertices in topological order
+    std::vector<node_list_t> _children;         //Outgoing edges, by vertex
+    std::vector<node_list_t> _parents;          //Incoming edges, by vertex
+    std::map<expert_graph_t::vertex_descriptor, node_list_t> _downstream_cache; //For resolve_from
+    std::map<expert_graph_t::vertex_descriptor, node_list_t> _upstream_cache;   //For resolve_to
 };
 
 expert_container::sptr expert_container::make(const std::string& name)
@@ -11,6 +11,7 @@
 #include "xports.hpp"
 #include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 namespace uhd { namespace rfnoc {
 
@@ -23,6 +24,17 @@ public:
     typedef boost::shared_ptr<ctrl_iface> sptr;
     virtual ~ctrl_iface(void) {}
 
+    //! A command for send_cmd_pkts(). See send_cmd_pkt() for the fields.
+    struct cmd_t
+    {
+        cmd_t(const size_t addr_, const size_t data_, const uint64_t timestamp_=0)
+            : addr(addr_), data(data_), timestamp(timestamp_) {}
+        size_t addr;
+        size_t data;
+        uint64_t timestamp;
+    };
+    typedef std::vector<cmd_t> cmd_list_t;
+
     /*! Make a new control object
      *
      * \param xports Bidirectional transport object to the RFNoC block port.
@@ -59,6 +71,33 @@ public:
             const bool readback=false,
             const uint64_t timestamp=0
     ) = 0;
+
+    /*! Send a list of (non-readback) command packets back to back.
+     *
+     * Packets are sent without waiting for their ACKs for as long as the
+     * command FIFO on the block has space. The ACKs for all of the commands
+     * are checked before returning, so a sequence of register writes costs
+     * about one round trip rather than one per write.
+     *
+     * The default implementation calls send_cmd_pkt() for every command.
+     *
+     * \throws uhd::io_error if any of the ACKs is missing or malformed. The
+     *         message names the command the bad ACK belongs to.
+     */
+    virtual void send_cmd_pkts(const cmd_list_t &cmds)
+    {
+        for (const cmd_t &cmd : cmds) {
+            send_cmd_pkt(cmd.addr, cmd.data, false, cmd.timestamp);
+        }
+    }
+
+    /*! Wait for the ACKs of all outstanding command packets.
+     *
+     * Unlike a dummy readback, this does not send any packets.
+     *
+     * \throws uhd::io_error if any of the ACKs is missing or malformed.
+     */
+    virtual void flush(void) {}
 };
 
 }} /* namespace uhd::rfnoc */
@@ -129,6 +129,7 @@ namespace uhd{ namespace usrp{
         {
             return _xport->get_send_buff(timeout);
         }
+        syscall_counters_t get_syscall_counters(void) const {return _xport->get_syscall_counters();}
 
         recv_packet_demuxer_3000::sptr _demux;
         transport::zero_copy_if::sptr _xport;
@@ -0,0 +1,323 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_BINARY_LOG_HPP
+#define INCLUDED_UHDLIB_UTILS_BINARY_LOG_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/utils/log.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <stdint.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
+/*! \file binary_log.hpp
+ *
+ * Binary logging for the fast path.
+ *
+ * The UHD_LOG_* macros build strings and hand them to the logging thread
+ * through a locked queue, which allocates and can block. The
+ * UHD_LOG_BINARY_* macros instead write a fixed-size record -- a pointer to
+ * the static call site, a timestamp and up to MAX_ARGS arguments -- into a
+ * lock-free ring owned by the calling thread. The logging thread formats the
+ * records later, and passes them to the regular logging backends.
+ *
+ * The format string uses boost::format syntax. Arguments can be integers,
+ * floating point values or C strings; strings are stored by pointer, so they
+ * must outlive the record (string literals, component names, ...). If a
+ * thread's ring is full, its records are dropped, and the logging thread
+ * reports how many were lost.
+ *
+ * Example:
+ *     UHD_LOG_BINARY_DEBUG("STREAMER", "chan %d: %d samples late", chan, n);
+ */
+
+namespace uhd { namespace log { namespace binary {
+
+    //! Maximum number of arguments of a single record
+    static const size_t MAX_ARGS = 6;
+
+    //! Number of records in each thread's ring
+    static const size_t RING_SIZE = 1024;
+
+    //! Static description of a log statement, one per call site
+    struct call_site_t {
+        uhd::log::severity_level verbosity;
+        const char *component;
+        const char *file;
+        unsigned int line;
+        const char *format;
+    };
+
+    enum arg_type_t {
+        ARG_INT,
+        ARG_UINT,
+        ARG_DOUBLE,
+        ARG_STRING
+    };
+
+    //! One log statement, as written by the fast path
+    struct record_t {
+        const call_site_t *site;
+        uint64_t timestamp;
+        size_t num_args;
+        arg_type_t types[MAX_ARGS];
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char *s;
+        } args[MAX_ARGS];
+    };
+
+    /*! Get a timestamp for a record
+     *
+     * This reads the time stamp counter where there is one, and the steady
+     * clock otherwise. The logging thread calibrates it against the wall
+     * clock.
+     */
+    UHD_INLINE uint64_t get_timestamp(void)
+    {
+#if defined(__i386__) || defined(__x86_64__) || \
+    (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /*! Single producer, single consumer ring of records
+     *
+     * The owning thread writes with claim() and commit(), the logging thread
+     * reads with pop(). Neither side ever waits for the other.
+     */
+    class ring_t : boost::noncopyable {
+    public:
+        ring_t(void):
+            thread_id(boost::this_thread::get_id()),
+            orphaned(false),
+            _head(0),
+            _tail(0),
+            _dropped(0)
+        {
+            /* NOP */
+        }
+
+        //! Get the next free record, or NULL if the ring is full
+        UHD_INLINE record_t *claim(void)
+        {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) >= RING_SIZE) {
+                // only the owning thread writes this counter
+                _dropped.store(
+                    _dropped.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+                return NULL;
+            }
+            return &_records[head % RING_SIZE];
+        }
+
+        //! Publish the record returned by the last claim()
+        UHD_INLINE void commit(void)
+        {
+            _head.store(
+                _head.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+        }
+
+        //! Take the oldest record out of the ring (logging thread only)
+        UHD_INLINE bool pop(record_t &record)
+        {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            record = _records[tail % RING_SIZE];
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        //! True if there are no records in the ring
+        UHD_INLINE bool empty(void) const
+        {
+            return _tail.load(std::memory_order_acquire) ==
+                _head.load(std::memory_order_acquire);
+        }
+
+        //! Total number of records dropped because the ring was full
+        UHD_INLINE size_t get_dropped(void) const
+        {
+            return _dropped.load(std::memory_order_relaxed);
+        }
+
+        const boost::thread::id thread_id;
+        //! Set when the owning thread has exited
+        std::atomic<bool> orphaned;
+
+    private:
+        // keep the producer and consumer indices on separate cache lines
+        std::atomic<size_t> _head;
+        char _pad0[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> _tail;
+        char _pad1[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> _dropped;
+        record_t _records[RING_SIZE];
+    };
+
+    //! Get the least severe level that is logged
+    UHD_API uhd::log::severity_level get_level(void);
+
+    //! Create and register the ring of the calling thread
+    UHD_API ring_t *register_thread(void);
+
+    /*! Wait until the records logged so far have been passed to the logging
+     * backends
+     */
+    UHD_API void flush(void);
+
+    //! Get the ring of the calling thread
+    UHD_INLINE ring_t *get_thread_ring(void)
+    {
+        static thread_local ring_t *ring = NULL;
+        if (ring == NULL) {
+            ring = register_thread();
+        }
+        return ring;
+    }
+
+    namespace detail {
+
+        template <typename T>
+        UHD_INLINE typename std::enable_if<
+            std::is_integral<T>::value and std::is_signed<T>::value>::type
+        set_arg(record_t &record, const size_t i, const T arg)
+        {
+            record.types[i] = ARG_INT;
+            record.args[i].i = arg;
+        }
+
+        template <typename T>
+        UHD_INLINE typename std::enable_if<
+            std::is_integral<T>::value and not std::is_signed<T>::value>::type
+        set_arg(record_t &record, const size_t i, const T arg)
+        {
+            record.types[i] = ARG_UINT;
+            record.args[i].u = arg;
+        }
+
+        template <typename T>
+        UHD_INLINE typename std::enable_if<std::is_enum<T>::value>::type
+        set_arg(record_t &record, const size_t i, const T arg)
+        {
+            record.types[i] = ARG_INT;
+            record.args[i].i = int64_t(arg);
+        }
+
+        template <typename T>
+        UHD_INLINE typename std::enable_if<std::is_floating_point<T>::value>::type
+        set_arg(record_t &record, const size_t i, const T arg)
+        {
+            record.types[i] = ARG_DOUBLE;
+            record.args[i].d = arg;
+        }
+
+        UHD_INLINE void set_arg(record_t &record, const size_t i, const char *arg)
+        {
+            record.types[i] = ARG_STRING;
+            record.args[i].s = arg;
+        }
+
+        UHD_INLINE void pack_args(record_t &, const size_t)
+        {
+            /* NOP */
+        }
+
+        template <typename T, typename... Args>
+        UHD_INLINE void pack_args(
+            record_t &record, const size_t i, const T arg, const Args... args
+        ){
+            set_arg(record, i, arg);
+            pack_args(record, i + 1, args...);
+        }
+
+    } // namespace detail
+
+    //! Write a record into the ring of the calling thread
+    template <typename... Args>
+    UHD_INLINE void push(const call_site_t *site, const Args... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS,
+            "Too many arguments for a binary log record");
+        ring_t *ring = get_thread_ring();
+        record_t *record = ring->claim();
+        if (record == NULL) {
+            return;
+        }
+        record->site = site;
+        record->timestamp = get_timestamp();
+        record->num_args = sizeof...(Args);
+        detail::pack_args(*record, 0, args...);
+        ring->commit();
+    }
+
+}}} /* namespace uhd::log::binary */
+
+#ifndef UHD_LOG_BINARY_DISABLE
+#define UHD_LOG_BINARY(level, component, format, ...)                      \
+    do {                                                                   \
+        static const uhd::log::binary::call_site_t _uhd_log_site =        \
+            {level, component, __FILE__, __LINE__, format};                \
+        if (level >= uhd::log::binary::get_level()) {                     \
+            uhd::log::binary::push(&_uhd_log_site, ##__VA_ARGS__);         \
+        }                                                                  \
+    } while (0)
+#else
+#define UHD_LOG_BINARY(level, component, format, ...)
+#endif
+
+#if UHD_LOG_MIN_LEVEL < 1
+#define UHD_LOG_BINARY_TRACE(component, format, ...) \
+    UHD_LOG_BINARY(uhd::log::trace, component, format, ##__VA_ARGS__)
+#else
+#define UHD_LOG_BINARY_TRACE(component, format, ...)
+#endif
+
+#if UHD_LOG_MIN_LEVEL < 2
+#define UHD_LOG_BINARY_DEBUG(component, format, ...) \
+    UHD_LOG_BINARY(uhd::log::debug, component, format, ##__VA_ARGS__)
+#else
+#define UHD_LOG_BINARY_DEBUG(component, format, ...)
+#endif
+
+#if UHD_LOG_MIN_LEVEL < 3
+#define UHD_LOG_BINARY_INFO(component, format, ...) \
+    UHD_LOG_BINARY(uhd::log::info, component, format, ##__VA_ARGS__)
+#else
+#define UHD_LOG_BINARY_INFO(component, format, ...)
+#endif
+
+#if UHD_LOG_MIN_LEVEL < 4
+#define UHD_LOG_BINARY_WARNING(component, format, ...) \
+    UHD_LOG_BINARY(uhd::log::warning, component, format, ##__VA_ARGS__)
+#else
+#define UHD_LOG_BINARY_WARNING(component, format, ...)
+#endif
+
+#if UHD_LOG_MIN_LEVEL < 5
+#define UHD_LOG_BINARY_ERROR(component, format, ...) \
+    UHD_LOG_BINARY(uhd::log::error, component, format, ##__VA_ARGS__)
+#else
+#define UHD_LOG_BINARY_ERROR(component, format, ...)
+#endif
+
+#endif /* INCLUDED_UHDLIB_UTILS_BINARY_LOG_HPP */
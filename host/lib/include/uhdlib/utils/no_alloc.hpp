@@ -0,0 +1,51 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_NO_ALLOC_HPP
+#define INCLUDED_UHDLIB_UTILS_NO_ALLOC_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <boost/noncopyable.hpp>
+
+/*! \file no_alloc.hpp
+ *
+ * Real-time streaming without heap allocations.
+ *
+ * With the stream arg no_alloc=1, a streamer sets up everything it needs
+ * on the first recv() or send() (thread-local trace and log rings, lazily
+ * sized buffers, ...), and allocates nothing on later calls. Streamers mark
+ * the body of those calls with a no_alloc::scope.
+ *
+ * A scope only marks the calling thread; UHD does not replace the
+ * allocator. An allocation hook which checks in_scope() (such as the one in
+ * the unit tests, which replaces operator new) turns the marks into
+ * failures.
+ */
+
+namespace uhd { namespace no_alloc {
+
+    //! Check the stream args for no_alloc=1 (or true)
+    UHD_API bool is_enabled(const uhd::stream_args_t &args);
+
+    //! Whether the calling thread is in an active scope
+    UHD_API bool in_scope(void);
+
+    //! Marks the calling thread as not allocating, while it exists
+    class UHD_API scope : boost::noncopyable
+    {
+    public:
+        //! \param active false for a scope which marks nothing
+        explicit scope(const bool active);
+        ~scope(void);
+
+    private:
+        const bool _active;
+    };
+
+}} // namespace uhd::no_alloc
+
+#endif /* INCLUDED_UHDLIB_UTILS_NO_ALLOC_HPP */
@@ -0,0 +1,84 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_PARALLEL_HPP
+#define INCLUDED_UHDLIB_UTILS_PARALLEL_HPP
+
+#include <uhd/config.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace uhd {
+
+    /*!
+     * Call task(i) for every i in [0, num_tasks), on a bounded pool of
+     * worker threads.
+     *
+     * Tasks are handed out in index order, so a task never starts before
+     * all tasks with a lower index have started. Tasks that depend on each
+     * other must be combined into one task by the caller.
+     *
+     * If any task throws, the remaining tasks are not started, and the
+     * first exception is rethrown in the calling thread once all running
+     * tasks have finished.
+     *
+     * \param num_tasks the number of tasks to run
+     * \param max_threads the maximum number of threads to use. With 0 or 1,
+     *                    the tasks run sequentially in the calling thread.
+     * \param task the function to call with each task index
+     */
+    UHD_INLINE void run_parallel(
+        const size_t num_tasks,
+        const size_t max_threads,
+        const boost::function<void(size_t)> &task
+    ){
+        const size_t num_threads = std::min(num_tasks, max_threads);
+        if (num_threads <= 1) {
+            for (size_t i = 0; i < num_tasks; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next_task(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr first_error;
+        boost::mutex error_mutex;
+        auto worker = [&](){
+            while (not failed) {
+                const size_t i = next_task++;
+                if (i >= num_tasks) {
+                    return;
+                }
+                try {
+                    task(i);
+                } catch (...) {
+                    boost::lock_guard<boost::mutex> lock(error_mutex);
+                    if (not failed) {
+                        first_error = std::current_exception();
+                        failed = true;
+                    }
+                }
+            }
+        };
+
+        boost::thread_group workers;
+        for (size_t i = 0; i < num_threads; i++) {
+            workers.create_thread(worker);
+        }
+        workers.join_all();
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+    }
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHDLIB_UTILS_PARALLEL_HPP */
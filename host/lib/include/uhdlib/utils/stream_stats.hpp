@@ -0,0 +1,173 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_STREAM_STATS_HPP
+#define INCLUDED_UHDLIB_UTILS_STREAM_STATS_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/types/stream_stats.hpp>
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+namespace uhd {
+
+/*! Lock-free performance counters of a streamer
+ *
+ * The streaming thread updates the counters, and any other thread may take
+ * a snapshot with get() at any time. Each counter has a single writer, so
+ * most updates are a plain load and store, which costs no more than
+ * incrementing a regular integer. Only the counters of rare events, which
+ * may come from a different thread (e.g., recv_async_msg()), use atomic
+ * read-modify-write operations.
+ */
+class stream_stats_collector : boost::noncopyable
+{
+public:
+    //! A counter with a single writer
+    class counter_t
+    {
+    public:
+        counter_t(void) : _value(0) {}
+
+        UHD_INLINE void add(const uint64_t n)
+        {
+            _value.store(_value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+        }
+
+        UHD_INLINE void set(const uint64_t value)
+        {
+            _value.store(value, std::memory_order_relaxed);
+        }
+
+        UHD_INLINE uint64_t get(void) const
+        {
+            return _value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> _value;
+    };
+
+    //! A counter which may be incremented by several threads
+    class shared_counter_t
+    {
+    public:
+        shared_counter_t(void) : _value(0) {}
+
+        UHD_INLINE void add(const uint64_t n)
+        {
+            _value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        UHD_INLINE uint64_t get(void) const
+        {
+            return _value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> _value;
+    };
+
+    //! A duration histogram with a single writer
+    class histogram_t
+    {
+    public:
+        UHD_INLINE void add(const uint64_t ns)
+        {
+            _count.add(1);
+            _total_ns.add(ns);
+            if (ns > _max_ns.get()) {
+                _max_ns.set(ns);
+            }
+            _buckets[uhd::duration_histogram_t::get_bucket(ns)].add(1);
+        }
+
+        void get(uhd::duration_histogram_t &hist) const
+        {
+            hist.count = _count.get();
+            hist.total_ns = _total_ns.get();
+            hist.max_ns = _max_ns.get();
+            for (size_t i = 0; i < uhd::duration_histogram_t::NUM_BUCKETS; i++) {
+                hist.buckets[i] = _buckets[i].get();
+            }
+        }
+
+    private:
+        counter_t _count;
+        counter_t _total_ns;
+        counter_t _max_ns;
+        counter_t _buckets[uhd::duration_histogram_t::NUM_BUCKETS];
+    };
+
+    //! Get a timestamp in ns to measure durations with
+    static UHD_INLINE uint64_t now_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //! Count an async message of a TX stream by its event code
+    void count_async_msg(const uhd::async_metadata_t &metadata)
+    {
+        switch (metadata.event_code) {
+        case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
+        case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
+            underflows.add(1);
+            break;
+        case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR:
+        case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR_IN_BURST:
+            sequence_errors.add(1);
+            break;
+        case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+            late.add(1);
+            break;
+        default:
+            break;
+        }
+    }
+
+    //! Take a snapshot of all counters
+    uhd::stream_stats_t get(void) const
+    {
+        uhd::stream_stats_t stats;
+        stats.packets = packets.get();
+        stats.bytes = bytes.get();
+        stats.samples = samples.get();
+        stats.timeouts = timeouts.get();
+        stats.overflows = overflows.get();
+        stats.underflows = underflows.get();
+        stats.sequence_errors = sequence_errors.get();
+        stats.late = late.get();
+        call_time.get(stats.call_time);
+        convert_time.get(stats.convert_time);
+        fc_wait_time.get(stats.fc_wait_time);
+        xport_time.get(stats.xport_time);
+        deadline_time.get(stats.deadline_time);
+        return stats;
+    }
+
+    counter_t packets;
+    counter_t bytes;
+    counter_t samples;
+    shared_counter_t timeouts;
+    shared_counter_t overflows;
+    shared_counter_t underflows;
+    shared_counter_t sequence_errors;
+    shared_counter_t late;
+    histogram_t call_time;
+    histogram_t convert_time;
+    histogram_t fc_wait_time;
+    histogram_t xport_time;
+    histogram_t deadline_time;
+};
+
+} /* namespace uhd */
+
+#endif /* INCLUDED_UHDLIB_UTILS_STREAM_STATS_HPP */
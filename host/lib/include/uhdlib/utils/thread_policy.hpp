@@ -0,0 +1,111 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_THREAD_POLICY_HPP
+#define INCLUDED_UHDLIB_UTILS_THREAD_POLICY_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/device_addr.hpp>
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <vector>
+
+/*! \file thread_policy.hpp
+ *
+ * Placement of the threads UHD starts on its own.
+ *
+ * Every internal thread belongs to a thread class, and runs in a
+ * thread_policy::scope of that class. The policy of a class sets the CPUs
+ * its threads may run on, their scheduling policy and their priority. The
+ * classes are:
+ *
+ * - crimson_bm: the Crimson TNG buffer monitor and clock sync thread
+ * - crimson_fc: the Crimson TNG flow control threads, one per TX streamer
+ * - recv_offload: the receive threads of zero_copy_recv_offload
+ * - msg_task: the threads of uhd::msg_task (async messages)
+ * - task: the threads of uhd::task (claimers, sensor pollers, ...)
+ * - log: the threads of the logger
+ * - gpsd: the gpsd poller
+ *
+ * The class "default" applies to any class without a policy of its own.
+ * Policies come from the [threads] section of the UHD config file, and from
+ * the device args, where the keys get a "thread_" prefix:
+ *
+ *     thread_default_cpus=0-1,thread_crimson_fc_cpus=2,thread_crimson_fc_sched=fifo
+ *
+ * Threads which are already running are moved when the policies change.
+ */
+
+namespace uhd { namespace thread_policy {
+
+    //! Placement of the threads of one class
+    struct policy_t
+    {
+        enum sched_t {
+            //! Keep the scheduling policy of the creating thread
+            POLICY_INHERIT,
+            POLICY_OTHER,
+            POLICY_BATCH,
+            POLICY_IDLE,
+            POLICY_FIFO,
+            POLICY_RR
+        };
+
+        //! The CPUs the threads may run on, any CPU if empty
+        std::vector<size_t> cpus;
+
+        //! The scheduling policy
+        sched_t sched;
+
+        /*!
+         * The priority, between -1 and 1. For POLICY_FIFO and POLICY_RR,
+         * 0 to 1 spans the real-time priorities. For POLICY_OTHER and
+         * POLICY_BATCH, -1 to 1 spans the nice values from 19 to -20.
+         */
+        float priority;
+
+        policy_t(void) : sched(POLICY_INHERIT), priority(0.0) {}
+    };
+
+    /*!
+     * Set the policy of a thread class, and apply it to its threads
+     * \throw uhd::value_error if the priority is out of range
+     */
+    UHD_API void set_policy(const std::string &thread_class, const policy_t &policy);
+
+    /*!
+     * Get the policy of a thread class, with the fields it does not set
+     * taken from the "default" class
+     */
+    UHD_API policy_t get_policy(const std::string &thread_class);
+
+    /*!
+     * Update the policies from the thread_<class>_cpus, thread_<class>_sched
+     * and thread_<class>_priority keys of the device args, and apply them.
+     * The first call also reads the [threads] section of the UHD config file.
+     *
+     * CPUs are given as a list of numbers and ranges ("0-3,6", or "0-3;6" where
+     * commas separate the device args). The scheduling policies are other,
+     * batch, idle, fifo and rr.
+     *
+     * \throw uhd::value_error on malformed values
+     */
+    UHD_API void update(const uhd::device_addr_t &args);
+
+    //! Applies the policy of a thread class to the calling thread, while it exists
+    class UHD_API scope : boost::noncopyable
+    {
+    public:
+        explicit scope(const std::string &thread_class);
+        ~scope(void);
+
+    private:
+        const size_t _id;
+    };
+
+}} // namespace uhd::thread_policy
+
+#endif /* INCLUDED_UHDLIB_UTILS_THREAD_POLICY_HPP */
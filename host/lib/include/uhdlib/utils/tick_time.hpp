@@ -0,0 +1,106 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_TICK_TIME_HPP
+#define INCLUDED_UHDLIB_UTILS_TICK_TIME_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/operators.hpp>
+#include <stdint.h>
+
+namespace uhd {
+
+    /*!
+     * A timestamp in the tick domain: an integer tick count at a fixed rate.
+     *
+     * Where uhd::time_spec_t needs floating-point division and normalization
+     * for every operation, offsets and differences of tick_time_t values are
+     * plain integer math. This makes it suitable for per-packet timestamp
+     * arithmetic, and sums of differences never drift from rounding.
+     *
+     * Converting from a time_spec_t rounds to the nearest tick. Converting
+     * back is exact for every time that falls on a tick, so a round trip
+     * does not lose any information.
+     *
+     * Only timestamps with the same tick rate may be combined.
+     */
+    class tick_time_t :
+        boost::additive<tick_time_t, int64_t>,
+        boost::totally_ordered<tick_time_t>{
+    public:
+        /*!
+         * Create a tick_time_t from a tick count.
+         * \param ticks the integer count of ticks
+         * \param tick_rate the number of ticks per second
+         */
+        tick_time_t(const int64_t ticks = 0, const double tick_rate = 1.0):
+            _ticks(ticks), _tick_rate(tick_rate)
+        {
+            /* NOP */
+        }
+
+        /*!
+         * Create a tick_time_t from a time_spec_t.
+         * \param time the time to convert, rounded to the nearest tick
+         * \param tick_rate the number of ticks per second
+         */
+        static tick_time_t from_time_spec(
+            const time_spec_t &time, const double tick_rate
+        ){
+            return tick_time_t(time.to_ticks(tick_rate), tick_rate);
+        }
+
+        //! Convert back into a time_spec_t
+        time_spec_t to_time_spec(void) const{
+            return time_spec_t::from_ticks(_ticks, _tick_rate);
+        }
+
+        //! Get the integer tick count
+        int64_t get_ticks(void) const{
+            return _ticks;
+        }
+
+        //! Get the number of ticks per second
+        double get_tick_rate(void) const{
+            return _tick_rate;
+        }
+
+        //! Implement addable interface (offset in ticks)
+        tick_time_t &operator+=(const int64_t ticks){
+            _ticks += ticks;
+            return *this;
+        }
+
+        //! Implement subtractable interface (offset in ticks)
+        tick_time_t &operator-=(const int64_t ticks){
+            _ticks -= ticks;
+            return *this;
+        }
+
+        //! Get the number of ticks from rhs to this time
+        int64_t operator-(const tick_time_t &rhs) const{
+            return _ticks - rhs._ticks;
+        }
+
+    private:
+        int64_t _ticks;
+        double _tick_rate;
+    };
+
+    //! Implement equality_comparable interface
+    UHD_INLINE bool operator==(const tick_time_t &lhs, const tick_time_t &rhs){
+        return lhs.get_ticks() == rhs.get_ticks();
+    }
+
+    //! Implement less_than_comparable interface
+    UHD_INLINE bool operator<(const tick_time_t &lhs, const tick_time_t &rhs){
+        return lhs.get_ticks() < rhs.get_ticks();
+    }
+
+} //namespace uhd
+
+#endif /* INCLUDED_UHDLIB_UTILS_TICK_TIME_HPP */
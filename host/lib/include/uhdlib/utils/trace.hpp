@@ -0,0 +1,231 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_TRACE_HPP
+#define INCLUDED_UHDLIB_UTILS_TRACE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/utils/trace.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/preprocessor/cat.hpp>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <stdint.h>
+
+/*! \file trace.hpp
+ *
+ * Trace points for the fast path.
+ *
+ * UHD_TRACE_SCOPE records the time spent in the enclosing scope,
+ * UHD_TRACE_INSTANT records a point in time, UHD_TRACE_COUNTER records a
+ * value (e.g., a buffer level) and UHD_TRACE_TRIGGER fires the dump trigger.
+ * Instants and counters belong to a channel; each channel of a counter is
+ * shown as a separate track. All of them take an optional device time in
+ * seconds, which is shown next to the host time in the trace.
+ *
+ * Each event is a fixed-size record in a ring owned by the calling thread.
+ * The ring never blocks and never allocates: when it is full, the oldest
+ * events are overwritten. Category and name must be string literals.
+ *
+ * The trace points are compiled out unless UHD_TRACE_ENABLE is defined
+ * (the UHD_TRACE_ENABLE CMake option), so they cost nothing in a regular
+ * build. See uhd/utils/trace.hpp for the user-facing controls.
+ *
+ * Example:
+ *     UHD_TRACE_SCOPE("crimson", "check_fc_condition");
+ *     UHD_TRACE_COUNTER("crimson", "buffer_level", chan, level, now.get_real_secs());
+ */
+
+namespace uhd { namespace trace {
+
+    //! Number of events in each thread's ring
+    static const size_t RING_SIZE = 8192;
+
+    enum phase_t {
+        PHASE_COMPLETE,
+        PHASE_INSTANT,
+        PHASE_COUNTER
+    };
+
+    //! Static description of a trace point, one per call site
+    struct site_t {
+        const char *category;
+        const char *name;
+        phase_t phase;
+    };
+
+    //! One event, as written by the fast path
+    struct event_t {
+        const site_t *site;
+        //! Host time (steady clock) in ns
+        uint64_t host_ns;
+        //! The duration in ns for complete events, the value of counters
+        int64_t value;
+        //! Device time in seconds, NaN if unknown
+        double device_time;
+        //! Channel of instant and counter events
+        uint32_t chan;
+    };
+
+    //! Value of event_t::device_time when there is no device time
+    UHD_INLINE double no_device_time(void)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    //! Get the host time of an event in ns
+    UHD_INLINE uint64_t now_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /*! Flight recorder ring of events
+     *
+     * Only the owning thread writes. A reader may copy the ring at any time;
+     * see read() for how it deals with events overwritten while copying.
+     */
+    class UHD_API ring_t : boost::noncopyable {
+    public:
+        ring_t(const std::string &thread_name):
+            thread_name(thread_name),
+            orphaned(false),
+            _head(0),
+            _start(0)
+        {
+            /* NOP */
+        }
+
+        //! Add an event, overwriting the oldest one if the ring is full
+        UHD_INLINE void push(
+            const site_t *site,
+            const uint64_t host_ns,
+            const int64_t value,
+            const double device_time,
+            const uint32_t chan = 0
+        ){
+            const uint64_t head = _head.load(std::memory_order_relaxed);
+            event_t &event = _events[head % RING_SIZE];
+            event.site = site;
+            event.host_ns = host_ns;
+            event.value = value;
+            event.device_time = device_time;
+            event.chan = chan;
+            _head.store(head + 1, std::memory_order_release);
+        }
+
+        /*!
+         * Copy the events in the ring, oldest first.
+         * \param events buffer for up to RING_SIZE events
+         * \return the number of events copied
+         */
+        size_t read(event_t *events) const;
+
+        //! Discard the events recorded so far
+        void clear(void);
+
+        const std::string thread_name;
+        //! Set when the owning thread has exited
+        std::atomic<bool> orphaned;
+
+    private:
+        std::atomic<uint64_t> _head;
+        //! Events before this index were cleared
+        std::atomic<uint64_t> _start;
+        event_t _events[RING_SIZE];
+    };
+
+    //! Create and register the ring of the calling thread
+    UHD_API ring_t *register_thread(void);
+
+    //! Get the ring of the calling thread
+    UHD_INLINE ring_t *get_thread_ring(void)
+    {
+        static thread_local ring_t *ring = NULL;
+        if (ring == NULL) {
+            ring = register_thread();
+        }
+        return ring;
+    }
+
+    //! Record an instant or counter event, if tracing is enabled
+    UHD_INLINE void record(
+        const site_t *site,
+        const size_t chan,
+        const int64_t value,
+        const double device_time = no_device_time()
+    ){
+        if (get_enabled()) {
+            get_thread_ring()->push(
+                site, now_ns(), value, device_time, uint32_t(chan));
+        }
+    }
+
+    //! Records a complete event when it goes out of scope
+    class scope_t : boost::noncopyable {
+    public:
+        UHD_INLINE scope_t(
+            const site_t *site,
+            const double device_time = no_device_time()
+        ):
+            _site(site),
+            _ring(get_enabled() ? get_thread_ring() : NULL),
+            _start_ns(_ring ? now_ns() : 0),
+            _device_time(device_time)
+        {
+            /* NOP */
+        }
+
+        UHD_INLINE ~scope_t(void)
+        {
+            if (_ring) {
+                _ring->push(_site, _start_ns,
+                    int64_t(now_ns() - _start_ns), _device_time);
+            }
+        }
+
+    private:
+        const site_t *_site;
+        ring_t *_ring;
+        const uint64_t _start_ns;
+        const double _device_time;
+    };
+
+}} /* namespace uhd::trace */
+
+#ifdef UHD_TRACE_ENABLE
+#define UHD_TRACE_SCOPE(category, name, ...)                                 \
+    static const uhd::trace::site_t BOOST_PP_CAT(_uhd_trace_site_, __LINE__) = \
+        {category, name, uhd::trace::PHASE_COMPLETE};                        \
+    const uhd::trace::scope_t BOOST_PP_CAT(_uhd_trace_scope_, __LINE__)(     \
+        &BOOST_PP_CAT(_uhd_trace_site_, __LINE__), ##__VA_ARGS__)
+
+#define UHD_TRACE_INSTANT(category, name, chan, ...)                         \
+    do {                                                                     \
+        static const uhd::trace::site_t _uhd_trace_site =                    \
+            {category, name, uhd::trace::PHASE_INSTANT};                     \
+        uhd::trace::record(&_uhd_trace_site, chan, 0, ##__VA_ARGS__);        \
+    } while (0)
+
+#define UHD_TRACE_COUNTER(category, name, chan, value, ...)                  \
+    do {                                                                     \
+        static const uhd::trace::site_t _uhd_trace_site =                    \
+            {category, name, uhd::trace::PHASE_COUNTER};                     \
+        uhd::trace::record(                                                  \
+            &_uhd_trace_site, chan, int64_t(value), ##__VA_ARGS__);          \
+    } while (0)
+
+#define UHD_TRACE_TRIGGER(reason) uhd::trace::trigger(reason)
+#else
+#define UHD_TRACE_SCOPE(category, name, ...)
+#define UHD_TRACE_INSTANT(category, name, chan, ...)
+#define UHD_TRACE_COUNTER(category, name, chan, value, ...)
+#define UHD_TRACE_TRIGGER(reason)
+#endif
+
+#endif /* INCLUDED_UHDLIB_UTILS_TRACE_HPP */
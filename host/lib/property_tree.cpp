@@ -7,20 +7,47 @@
 
 #include <uhd/property_tree.hpp>
 #include <uhd/types/dict.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace uhd;
 
 /***********************************************************************
- * Helper function to iterate through paths
+ * Helper functions to iterate through paths
  **********************************************************************/
 #include <boost/tokenizer.hpp>
 #define path_tokenizer(path) \
     boost::tokenizer<boost::char_separator<char> > \
     (path, boost::char_separator<char>("/"))
 
+/*!
+ * Append the normalized form of path to key: every path element is
+ * prefixed with a single slash, empty elements are dropped.
+ * The normalized form is used as the key of the tree's path index,
+ * so that "a/b", "/a/b/" and "/a//b" all refer to the same node.
+ */
+static void append_path_key(std::string &key, const std::string &path){
+    const size_t n = path.size();
+    size_t i = 0;
+    while (i < n){
+        if (path[i] == '/'){ i++; continue; }
+        const size_t end = std::min(path.find('/', i), n);
+        key.push_back('/');
+        key.append(path, i, end - i);
+        i = end;
+    }
+}
+
 /***********************************************************************
  * Property path implementation wrapper
  **********************************************************************/
@@ -62,6 +89,15 @@ fs_path uhd::operator/(const fs_path &lhs, size_t rhs)
 
 /***********************************************************************
  * Property tree implementation
+ *
+ * The nodes of the tree are stored in nested dicts, which keep the
+ * insertion order for list(). In addition, every node is indexed by its
+ * normalized path, so lookups are a single hash instead of a walk from the
+ * root. Lookups only need a shared lock, only create and remove serialize.
+ *
+ * While a transaction is open, properties hand their notification to the
+ * tree (through the deferrer made in _make_deferrer()) instead of calling
+ * their subscribers, and the tree calls them on commit.
  **********************************************************************/
 class property_tree_impl : public uhd::property_tree{
 public:
@@ -69,12 +105,14 @@ public:
     property_tree_impl(const fs_path &root = fs_path()):
         _root(root)
     {
+        append_path_key(_root_key, _root);
         _guts = boost::make_shared<tree_guts_type>();
+        _guts->index[""] = &_guts->root;
     }
 
     sptr subtree(const fs_path &path_) const{
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
         property_tree_impl *subtree = new property_tree_impl(path);
         subtree->_guts = this->_guts; //copy the guts sptr
@@ -82,52 +120,60 @@ public:
     }
 
     void remove(const fs_path &path_){
-        const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path_);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *parent = NULL;
-        node_type *node = &_guts->root;
-        for(const std::string &name:  path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            parent = node;
-            node = &(*node)[name];
+        if (find_node(key) == NULL) throw_path_not_found(_root / path_);
+        if (key.empty()) throw uhd::runtime_error("Cannot uproot");
+        const size_t leaf_pos = key.rfind('/');
+        node_type *parent = find_node(key.substr(0, leaf_pos));
+
+        //drop the node and everything below it from the index,
+        //and forget about any of its properties set in a transaction
+        erase_below(_guts->index, key);
+        erase_below(_guts->batch_index, key);
+        {
+            boost::mutex::scoped_lock tx_lock(_guts->transaction_mutex);
+            pending_list_type &pending = _guts->pending;
+            for (pending_list_type::iterator it = pending.begin(); it != pending.end();){
+                if (is_below(it->first, key)){
+                    _guts->pending_keys.erase(it->first);
+                    it = pending.erase(it);
+                }
+                else ++it;
+            }
         }
-        if (parent == NULL) throw uhd::runtime_error("Cannot uproot");
-        parent->pop(fs_path(path.leaf()));
+        parent->pop(key.substr(leaf_pos+1));
     }
 
     bool exists(const fs_path &path_) const{
-        const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path_);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        for(const std::string &name:  path_tokenizer(path)){
-            if (not node->has_key(name)) return false;
-            node = &(*node)[name];
-        }
-        return true;
+        return find_node(key) != NULL;
     }
 
     std::vector<std::string> list(const fs_path &path_) const{
-        const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
-
-        node_type *node = &_guts->root;
-        for(const std::string &name:  path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
+        const std::string key = make_key(path_);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
+        node_type *node = find_node(key);
+        if (node == NULL) throw_path_not_found(_root / path_);
         return node->keys();
     }
 
     void _create(const fs_path &path_, const boost::shared_ptr<void> &prop){
         const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
 
         node_type *node = &_guts->root;
+        std::string key;
         for(const std::string &name:  path_tokenizer(path)){
-            if (not node->has_key(name)) (*node)[name] = node_type();
+            key += "/" + name;
+            if (not node->has_key(name)){
+                (*node)[name] = node_type();
+                _guts->index[key] = &(*node)[name];
+            }
             node = &(*node)[name];
         }
         if (node->prop.get() != NULL) throw uhd::runtime_error("Cannot create! Property already exists at: " + path);
@@ -135,37 +181,189 @@ public:
     }
 
     boost::shared_ptr<void> &_access(const fs_path &path_) const{
-        const fs_path path = _root / path_;
-        boost::mutex::scoped_lock lock(_guts->mutex);
+        const std::string key = make_key(path_);
+        boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
 
-        node_type *node = &_guts->root;
-        for(const std::string &name:  path_tokenizer(path)){
-            if (not node->has_key(name)) throw_path_not_found(path);
-            node = &(*node)[name];
-        }
-        if (node->prop.get() == NULL) throw uhd::runtime_error("Cannot access! Property uninitialized at: " + path);
+        node_type *node = find_node(key);
+        if (node == NULL) throw_path_not_found(_root / path_);
+        if (node->prop.get() == NULL) throw uhd::runtime_error("Cannot access! Property uninitialized at: " + (_root / path_));
         return node->prop;
     }
 
+    void begin_transaction(void){
+        boost::mutex::scoped_lock tx_lock(_guts->transaction_mutex);
+        const boost::thread::id this_thread = boost::this_thread::get_id();
+        if (_guts->transaction_depth > 0 and _guts->transaction_owner != this_thread){
+            throw uhd::runtime_error("Cannot begin transaction! Another thread has a transaction open");
+        }
+        _guts->transaction_owner = this_thread;
+        _guts->transaction_depth++;
+    }
+
+    void commit_transaction(void){
+        pending_list_type pending;
+        {
+            boost::mutex::scoped_lock tx_lock(_guts->transaction_mutex);
+            if (_guts->transaction_depth == 0 or _guts->transaction_owner != boost::this_thread::get_id()){
+                throw uhd::runtime_error("Cannot commit! No transaction open in this thread");
+            }
+            if (--_guts->transaction_depth > 0) return;
+            pending.swap(_guts->pending);
+            _guts->pending_keys.clear();
+        }
+
+        //collect the properties of each batch subscriber
+        std::vector<batch_subscriber_type> batch_subscribers;
+        std::vector<std::vector<fs_path> > batch_paths;
+        std::vector<bool> batched(pending.size(), false);
+        {
+            boost::shared_lock<boost::shared_mutex> lock(_guts->mutex);
+            batch_subscribers = _guts->batch_subscribers;
+            batch_paths.resize(batch_subscribers.size());
+            for (size_t i = 0; i < pending.size(); i++){
+                batch_index_type::const_iterator it = _guts->batch_index.find(pending[i].first);
+                if (it == _guts->batch_index.end()) continue;
+                batch_paths[it->second].push_back(fs_path(pending[i].first));
+                batched[i] = true;
+            }
+        }
+
+        //call outside of the locks, subscribers may use the tree
+        for (size_t i = 0; i < batch_subscribers.size(); i++){
+            if (not batch_paths[i].empty()) batch_subscribers[i](batch_paths[i]);
+        }
+        for (size_t i = 0; i < pending.size(); i++){
+            pending[i].second(not batched[i]);
+        }
+    }
+
+    void add_batch_subscriber(
+        const std::vector<fs_path> &paths,
+        const batch_subscriber_type &subscriber
+    ){
+        boost::unique_lock<boost::shared_mutex> lock(_guts->mutex);
+
+        std::vector<std::string> keys;
+        for (const fs_path &path : paths){
+            const std::string key = make_key(path);
+            node_type *node = find_node(key);
+            if (node == NULL or node->prop.get() == NULL) throw_path_not_found(_root / path);
+            if (_guts->batch_index.count(key)){
+                throw uhd::runtime_error("Cannot add batch subscriber! Property already has one at: " + (_root / path));
+            }
+            keys.push_back(key);
+        }
+        for (const std::string &key : keys){
+            _guts->batch_index[key] = _guts->batch_subscribers.size();
+        }
+        _guts->batch_subscribers.push_back(subscriber);
+    }
+
+    boost::function<bool(const boost::function<void(bool)> &)>
+    _make_deferrer(const fs_path &path, const void *prop){
+        return boost::bind(&property_tree_impl::defer_notify,
+            boost::weak_ptr<tree_guts_type>(_guts), make_key(path), prop, _1);
+    }
+
 private:
     void throw_path_not_found(const fs_path &path) const{
         throw uhd::lookup_error("Path not found in tree: " + path);
     }
 
+    //! Get the index key for a path relative to this (sub)tree
+    std::string make_key(const fs_path &path) const{
+        std::string key;
+        key.reserve(_root_key.size() + path.size() + 1);
+        key = _root_key;
+        append_path_key(key, path);
+        return key;
+    }
+
     //basic structural node element
     struct node_type : uhd::dict<std::string, node_type>{
         boost::shared_ptr<void> prop;
     };
 
+    //! Look up a node by key, the caller must hold the lock
+    node_type *find_node(const std::string &key) const{
+        index_type::const_iterator it = _guts->index.find(key);
+        return (it == _guts->index.end())? NULL : it->second;
+    }
+
+    //! True if key is base or below it
+    static bool is_below(const std::string &key, const std::string &base){
+        return key.compare(0, base.size(), base) == 0
+            and (key.size() == base.size() or key[base.size()] == '/');
+    }
+
+    //! Erase base and everything below it from a map by key
+    template <typename map_type>
+    static void erase_below(map_type &map, const std::string &base){
+        for (typename map_type::iterator it = map.begin(); it != map.end();){
+            if (is_below(it->first, base)) it = map.erase(it);
+            else ++it;
+        }
+    }
+
+    //index of all nodes by their normalized path (nodes have stable addresses)
+    typedef std::unordered_map<std::string, node_type *> index_type;
+
+    //properties with a batch subscriber, by index into the subscribers
+    typedef std::unordered_map<std::string, size_t> batch_index_type;
+
+    //properties set in the open transaction, in order, with their notification
+    typedef std::vector<std::pair<std::string, boost::function<void(bool)> > > pending_list_type;
+
     //tree guts which may be referenced in a subtree
     struct tree_guts_type{
+        tree_guts_type(void): transaction_depth(0){}
         node_type root;
-        boost::mutex mutex;
+        index_type index;
+        batch_index_type batch_index;
+        std::vector<batch_subscriber_type> batch_subscribers;
+        boost::shared_mutex mutex;
+
+        //transaction state, see begin_transaction()
+        boost::mutex transaction_mutex;
+        std::atomic<size_t> transaction_depth;
+        boost::thread::id transaction_owner;
+        pending_list_type pending;
+        std::unordered_set<std::string> pending_keys;
     };
 
+    /*!
+     * Called by a property when it is set: if the setting thread has a
+     * transaction open, store the notification for the commit.
+     * \return true if the notification was deferred
+     */
+    static bool defer_notify(
+        const boost::weak_ptr<tree_guts_type> &weak_guts,
+        const std::string &key,
+        const void *prop,
+        const boost::function<void(bool)> &notify
+    ){
+        boost::shared_ptr<tree_guts_type> guts = weak_guts.lock();
+        if (not guts or guts->transaction_depth == 0) return false;
+
+        //the property may have been removed from the tree (kept alive by a handle)
+        boost::shared_lock<boost::shared_mutex> lock(guts->mutex);
+        index_type::const_iterator node = guts->index.find(key);
+        if (node == guts->index.end() or node->second->prop.get() != prop) return false;
+
+        boost::mutex::scoped_lock tx_lock(guts->transaction_mutex);
+        if (guts->transaction_depth == 0 or guts->transaction_owner != boost::this_thread::get_id()){
+            return false;
+        }
+        if (guts->pending_keys.insert(key).second){
+            guts->pending.push_back(std::make_pair(key, notify));
+        }
+        return true;
+    }
+
     //members, the tree and root prefix
     boost::shared_ptr<tree_guts_type> _guts;
     const fs_path _root;
+    std::string _root_key;
 };
 
 property_tree::~property_tree(void){
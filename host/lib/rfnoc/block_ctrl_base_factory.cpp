@@ -10,6 +10,8 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/rfnoc/blockdef.hpp>
 #include <uhd/rfnoc/block_ctrl_base.hpp>
+#include <uhdlib/utils/parallel.hpp>
+#include <map>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -55,13 +57,10 @@ static void lookup_block_key(uint64_t noc_id, make_args_t &make_args)
 }
 
 
-block_ctrl_base::sptr block_ctrl_base::make(
-        const make_args_t &make_args_,
-        uint64_t noc_id
-) {
-    UHD_LOGGER_TRACE("RFNOC") << "[RFNoC Factory] block_ctrl_base::make()";
-    make_args_t make_args = make_args_;
-
+/*! Find the block controller key and the block name to use for a block.
+ */
+static void resolve_block_key(uint64_t noc_id, make_args_t &make_args)
+{
     // Check if a block key was specified, in this case, we *must* either
     // create a specialized block controller class or throw
     if (make_args.block_key.empty()) {
@@ -80,10 +79,60 @@ block_ctrl_base::sptr block_ctrl_base::make(
     if (make_args.block_name.empty()) {
         make_args.block_name = make_args.block_key;
     }
+}
 
+/*! Call the registered factory function for resolved make args.
+ */
+static block_ctrl_base::sptr make_resolved(const make_args_t &make_args)
+{
     UHD_LOGGER_TRACE("RFNOC")
         << "[RFNoC Factory] Using controller key '" << make_args.block_key
         << "' and block name '" << make_args.block_name << "'";
-    return get_block_fcn_regs()[make_args.block_key](make_args);
+    return get_block_fcn_regs().get(make_args.block_key)(make_args);
 }
 
+block_ctrl_base::sptr block_ctrl_base::make(
+        const make_args_t &make_args_,
+        uint64_t noc_id
+) {
+    UHD_LOGGER_TRACE("RFNOC") << "[RFNoC Factory] block_ctrl_base::make()";
+    make_args_t make_args = make_args_;
+    resolve_block_key(noc_id, make_args);
+    return make_resolved(make_args);
+}
+
+std::vector<block_ctrl_base::sptr> block_ctrl_base::make_blocks(
+        const std::vector<make_args_t> &make_args_,
+        const std::vector<uint64_t> &noc_ids,
+        const size_t max_threads
+) {
+    UHD_LOGGER_TRACE("RFNOC") << "[RFNoC Factory] block_ctrl_base::make_blocks()";
+    UHD_ASSERT_THROW(make_args_.size() == noc_ids.size());
+
+    // Resolve all names first, then group the blocks into chains of blocks
+    // with the same name. Block IDs are assigned by counting up from 0 until
+    // a free one is found, so blocks within a chain must be created in order.
+    std::vector<make_args_t> make_args = make_args_;
+    std::vector<std::vector<size_t>> chains;
+    std::map<std::string, size_t> chain_index;
+    for (size_t i = 0; i < make_args.size(); i++) {
+        resolve_block_key(noc_ids[i], make_args[i]);
+        const std::string &name = make_args[i].block_name;
+        if (not chain_index.count(name)) {
+            chain_index[name] = chains.size();
+            chains.push_back(std::vector<size_t>());
+        }
+        chains[chain_index[name]].push_back(i);
+    }
+
+    // Chains are independent of each other, so those can run in parallel
+    std::vector<sptr> blocks(make_args.size());
+    uhd::run_parallel(chains.size(), max_threads,
+        [&chains, &make_args, &blocks](const size_t chain_idx){
+            for (const size_t block_idx : chains[chain_idx]) {
+                blocks[block_idx] = make_resolved(make_args[block_idx]);
+            }
+        }
+    );
+    return blocks;
+}
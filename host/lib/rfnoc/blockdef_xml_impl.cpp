@@ -10,6 +10,7 @@
 #include <uhd/rfnoc/blockdef.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/paths.hpp>
+#include <uhd/utils/static.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -17,6 +18,10 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -148,6 +153,321 @@ std::string blockdef::arg_t::to_string() const
     return result;
 }
 
+/****************************************************************************
+ * blockdef index
+ ****************************************************************************/
+//! Maps NoC IDs to block definition files without parsing every XML file.
+//
+// The index is built once per process (and again if the set of block
+// directories changes). For every XML file, the IDs it declares are stored
+// by their normalized string (uppercase, no leading 0x). Since IDs in the
+// XML files match NoC IDs by prefix, a lookup tries every valid prefix
+// length of the NoC ID, which is a constant number of hash lookups.
+//
+// The list of IDs for every file is also stored on disk, so that a file
+// only needs to be parsed again when its modification time, size or
+// content hash changes. Parsed XML files are kept in memory, so every file
+// is parsed at most once per process.
+class blockdef_index
+{
+public:
+    //! Return the path of the first file declaring \p noc_id, or an empty path
+    fs::path lookup(const std::vector<fs::path> &dirs, const uint64_t noc_id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (dirs != _dirs) {
+            _build(dirs);
+        }
+
+        const std::string id_str = str(boost::format("%016X") % noc_id);
+        size_t best_file = _files.size();
+        for (size_t len = MIN_ID_CHARS; len <= MAX_ID_CHARS; len++) {
+            const auto it = _ids.find(id_str.substr(0, len));
+            if (it != _ids.end() and it->second < best_file) {
+                best_file = it->second;
+            }
+        }
+        if (best_file == _files.size()) {
+            return fs::path();
+        }
+        return fs::path(_files[best_file].path);
+    }
+
+    //! Return the parsed contents of \p filename, parsing it on first use
+    pt::ptree get_ptree(const fs::path &filename)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _ptrees.find(filename.string());
+        if (it == _ptrees.end()) {
+            pt::ptree propt;
+            read_xml(filename.string(), propt);
+            it = _ptrees.insert(std::make_pair(filename.string(), propt)).first;
+        }
+        return it->second;
+    }
+
+    //! Normalize an ID string from an XML file, throws on invalid IDs
+    static std::string normalize_id(const std::string &id)
+    {
+        std::string norm = boost::to_upper_copy(id);
+        if (norm.size() > 2 and norm[0] == '0' and norm[1] == 'X') {
+            norm = norm.substr(2);
+        }
+        if (norm.size() < MIN_ID_CHARS or norm.size() > MAX_ID_CHARS) {
+            throw uhd::value_error(str(boost::format(
+                    "%s is not a valid NoC ID (must be hexadecimal, min 4 and max 16 characters)"
+            ) % id));
+        }
+        return norm;
+    }
+
+private:
+    static const size_t MIN_ID_CHARS = 4;
+    static const size_t MAX_ID_CHARS = 16;
+    //! Change this whenever the layout of the cache file changes
+    static const uint32_t CACHE_MAGIC = 0x55424458; // UBDX
+    static const uint32_t CACHE_VERSION = 1;
+
+    struct file_entry_t {
+        std::string path;
+        int64_t mtime;
+        uint64_t size;
+        uint64_t hash;
+        std::vector<std::string> ids;
+    };
+    typedef std::unordered_map<std::string, file_entry_t> cache_t;
+
+    void _build(const std::vector<fs::path> &dirs)
+    {
+        _dirs = dirs;
+        _files.clear();
+        _ids.clear();
+
+        cache_t cache = _read_cache();
+        bool cache_dirty = false;
+        for (const auto& path : dirs) {
+            fs::directory_iterator end_itr;
+            for (fs::directory_iterator i(path); i != end_itr; ++i) {
+                if (not fs::exists(*i) or fs::is_directory(*i) or fs::is_empty(*i)) {
+                    continue;
+                }
+                if (i->path().filename().extension() != XML_EXTENSION) {
+                    continue;
+                }
+                file_entry_t entry;
+                if (not _scan_file(i->path(), cache, entry, cache_dirty)) {
+                    continue;
+                }
+                const size_t file_index = _files.size();
+                for (const auto& id : entry.ids) {
+                    // The first file declaring an ID wins
+                    _ids.insert(std::make_pair(id, file_index));
+                }
+                _files.push_back(entry);
+            }
+        }
+
+        // Drop entries for files that no longer exist, but keep those from
+        // directories not scanned here (other processes may use them)
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (fs::exists(it->first)) {
+                ++it;
+            } else {
+                it = cache.erase(it);
+                cache_dirty = true;
+            }
+        }
+        if (cache_dirty) {
+            _write_cache(cache);
+        }
+    }
+
+    //! Fill \p entry from the cache if it is current, or from the file itself
+    bool _scan_file(
+        const fs::path &filename,
+        cache_t &cache,
+        file_entry_t &entry,
+        bool &cache_dirty
+    ) {
+        std::string contents;
+        try {
+            std::ifstream file(filename.string().c_str(), std::ios::binary);
+            contents.assign(
+                std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>()
+            );
+            entry.path = filename.string();
+            entry.mtime = int64_t(fs::last_write_time(filename));
+            entry.size = contents.size();
+            entry.hash = _hash(contents);
+        } catch (const std::exception &e) {
+            UHD_LOGGER_WARNING("RFNOC")
+                << "blockdef index: caught exception " << e.what()
+                << " while reading file: " << filename.string();
+            return false;
+        }
+
+        const auto cached = cache.find(entry.path);
+        if (cached != cache.end()
+                and cached->second.mtime == entry.mtime
+                and cached->second.size == entry.size
+                and cached->second.hash == entry.hash) {
+            entry.ids = cached->second.ids;
+            return true;
+        }
+
+        cache_dirty = true;
+        try {
+            std::istringstream stream(contents);
+            pt::ptree propt;
+            read_xml(stream, propt);
+            for (pt::ptree::value_type &v : propt.get_child("nocblock.ids")) {
+                if (v.first == "id") {
+                    entry.ids.push_back(normalize_id(v.second.data()));
+                }
+            }
+            _ptrees[entry.path] = propt;
+            cache[entry.path] = entry;
+        } catch (const std::exception &e) {
+            UHD_LOGGER_WARNING("RFNOC")
+                << "blockdef index: caught exception " << e.what()
+                << " while parsing file: " << filename.string();
+            // Keep the file in the index (without IDs), so it won't be
+            // parsed again until it changes
+            entry.ids.clear();
+            cache[entry.path] = entry;
+        }
+        return true;
+    }
+
+    //! FNV-1a, stable across processes and platforms
+    static uint64_t _hash(const std::string &data)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char c : data) {
+            hash ^= uint8_t(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    static fs::path _get_cache_path()
+    {
+        return fs::path(uhd::get_app_path()) / ".uhd" / "cache" / "rfnoc_blockdefs.bin";
+    }
+
+    template <typename T>
+    static void _write_pod(std::ostream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool _read_pod(std::istream &in, T &value)
+    {
+        return bool(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+
+    static void _write_string(std::ostream &out, const std::string &str)
+    {
+        _write_pod(out, uint32_t(str.size()));
+        out.write(str.data(), str.size());
+    }
+
+    static bool _read_string(std::istream &in, std::string &str)
+    {
+        uint32_t len = 0;
+        if (not _read_pod(in, len) or len > MAX_CACHE_STRING_LEN) {
+            return false;
+        }
+        str.resize(len);
+        return len == 0 or bool(in.read(&str[0], len));
+    }
+
+    static const uint32_t MAX_CACHE_STRING_LEN = 4096;
+
+    //! Read the on-disk cache. A missing or corrupt cache reads as empty.
+    static cache_t _read_cache()
+    {
+        cache_t cache;
+        std::ifstream in(_get_cache_path().string().c_str(), std::ios::binary);
+        uint32_t magic = 0, version = 0, num_files = 0;
+        if (not _read_pod(in, magic) or magic != CACHE_MAGIC
+                or not _read_pod(in, version) or version != CACHE_VERSION
+                or not _read_pod(in, num_files)) {
+            return cache_t();
+        }
+        for (uint32_t i = 0; i < num_files; i++) {
+            file_entry_t entry;
+            uint32_t num_ids = 0;
+            if (not _read_string(in, entry.path)
+                    or not _read_pod(in, entry.mtime)
+                    or not _read_pod(in, entry.size)
+                    or not _read_pod(in, entry.hash)
+                    or not _read_pod(in, num_ids)) {
+                return cache_t();
+            }
+            entry.ids.resize(num_ids);
+            for (auto& id : entry.ids) {
+                if (not _read_string(in, id)) {
+                    return cache_t();
+                }
+            }
+            cache[entry.path] = entry;
+        }
+        return cache;
+    }
+
+    //! Write the on-disk cache. Failing to do so is not an error.
+    static void _write_cache(const cache_t &cache)
+    {
+        const fs::path cache_path = _get_cache_path();
+        const fs::path tmp_path = fs::path(cache_path.string() + ".tmp");
+        try {
+            fs::create_directories(cache_path.parent_path());
+            {
+                std::ofstream out(tmp_path.string().c_str(), std::ios::binary);
+                _write_pod(out, uint32_t(CACHE_MAGIC));
+                _write_pod(out, uint32_t(CACHE_VERSION));
+                _write_pod(out, uint32_t(cache.size()));
+                for (const auto& item : cache) {
+                    const file_entry_t &entry = item.second;
+                    _write_string(out, entry.path);
+                    _write_pod(out, entry.mtime);
+                    _write_pod(out, entry.size);
+                    _write_pod(out, entry.hash);
+                    _write_pod(out, uint32_t(entry.ids.size()));
+                    for (const auto& id : entry.ids) {
+                        _write_string(out, id);
+                    }
+                }
+                if (not out) {
+                    throw uhd::io_error("write failed");
+                }
+            }
+            // Replace atomically, so concurrent processes never see a
+            // partially written cache
+            fs::rename(tmp_path, cache_path);
+        } catch (const std::exception &e) {
+            UHD_LOGGER_DEBUG("RFNOC")
+                << "blockdef index: could not write cache file "
+                << cache_path.string() << ": " << e.what();
+        }
+    }
+
+    std::mutex _mutex;
+    //! Directories the index was built from
+    std::vector<fs::path> _dirs;
+    //! All indexed files, in scan order
+    std::vector<file_entry_t> _files;
+    //! Normalized ID -> index into _files
+    std::unordered_map<std::string, size_t> _ids;
+    //! Parsed XML files, by path
+    std::unordered_map<std::string, pt::ptree> _ptrees;
+};
+
+UHD_SINGLETON_FCN(blockdef_index, get_blockdef_index)
+
 /****************************************************************************
  * blockdef_impl stuff
  ****************************************************************************/
@@ -184,42 +504,14 @@ public:
     {
         // Sanitize input: Make both values strings with all uppercase
         // characters and no leading 0x. Check inputs are valid.
-        std::string lhs = boost::to_upper_copy(lhs_);
-        std::string rhs = str(boost::format("%016X") % rhs_);
-        if (lhs.size() > 2 and lhs[0] == '0' and lhs[1] == 'X') {
-            lhs = lhs.substr(2);
-        }
+        const std::string lhs = blockdef_index::normalize_id(lhs_);
+        const std::string rhs = str(boost::format("%016X") % rhs_);
         UHD_ASSERT_THROW(rhs.size() == 16);
-        if (lhs.size() < 4 or lhs.size() > 16) {
-            throw uhd::value_error(str(boost::format(
-                    "%s is not a valid NoC ID (must be hexadecimal, min 4 and max 16 characters)"
-            ) % lhs_));
-        }
 
         // OK, all good now. Next, we try and match the substring lhs in rhs:
         return (rhs.find(lhs) == 0);
     }
 
-    //! Open the file at filename and see if it's a block definition for the given NoC ID
-    static bool has_noc_id(uint64_t noc_id, const fs::path &filename)
-    {
-        pt::ptree propt;
-        try {
-            read_xml(filename.string(), propt);
-            for(pt::ptree::value_type &v:  propt.get_child("nocblock.ids")) {
-                if (v.first == "id" and match_noc_id(v.second.data(), noc_id)) {
-                    return true;
-                }
-            }
-        } catch (std::exception &e) {
-            UHD_LOGGER_WARNING("RFNOC")
-                << "has_noc_id(): caught exception " << e.what()
-                << " while parsing file: " << filename.string();
-            return false;
-        }
-        return false;
-    }
-
     blockdef_xml_impl(const fs::path &filename, uint64_t noc_id, xml_repr_t type=DESCRIBES_BLOCK) :
         _type(type),
         _noc_id(noc_id)
@@ -229,7 +521,7 @@ public:
             % filename.string().c_str()
             % noc_id
         ;
-        read_xml(filename.string(), _pt);
+        _pt = get_blockdef_index().get_ptree(filename);
         try {
             // Check key is valid
             get_key();
@@ -429,21 +721,9 @@ blockdef::sptr blockdef::make_from_noc_id(uint64_t noc_id)
         );
     }
 
-    // Iterate over all paths
-    for (const auto& path : valid) {
-        // Iterate over all .xml files
-        fs::directory_iterator end_itr;
-        for (fs::directory_iterator i(path); i != end_itr; ++i) {
-            if (not fs::exists(*i) or fs::is_directory(*i) or fs::is_empty(*i)) {
-                continue;
-            }
-            if (i->path().filename().extension() != XML_EXTENSION) {
-                continue;
-            }
-            if (blockdef_xml_impl::has_noc_id(noc_id, i->path())) {
-                return blockdef::sptr(new blockdef_xml_impl(i->path(), noc_id));
-            }
-        }
+    const fs::path filename = get_blockdef_index().lookup(valid, noc_id);
+    if (not filename.empty()) {
+        return blockdef::sptr(new blockdef_xml_impl(filename, noc_id));
     }
 
     return blockdef::sptr();
@@ -44,7 +44,8 @@ public:
                 uhd::rfnoc::CMD_FIFO_SIZE / 3, // Max command packet size is 3 lines
                 _xports.recv->get_num_recv_frames()
             )
-        )
+        ),
+        _timed_outstanding(false)
     {
         UHD_ASSERT_THROW(bool(_xports.send));
         UHD_ASSERT_THROW(bool(_xports.recv));
@@ -55,8 +56,8 @@ public:
     virtual ~ctrl_iface_impl(void)
     {
         UHD_SAFE_CALL(
-            // dummy peek with the purpose of ack'ing all packets
-            this->send_cmd_pkt(0, 0, true);
+            // ack all outstanding packets
+            this->flush();
         )
     }
 
@@ -77,6 +78,25 @@ public:
         );
     }
 
+    void send_cmd_pkts(const cmd_list_t &cmds)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        bool timed = false;
+        for (const cmd_t &cmd : cmds) {
+            timed = timed or bool(cmd.timestamp);
+            this->send_pkt(cmd.addr, cmd.data, cmd.timestamp);
+            // Only blocks if the command window is full
+            this->wait_for_ack(false, timed ? MASSIVE_TIMEOUT : ACK_TIMEOUT);
+        }
+        this->flush_acks(timed ? MASSIVE_TIMEOUT : ACK_TIMEOUT);
+    }
+
+    void flush(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        this->flush_acks(_timed_outstanding ? MASSIVE_TIMEOUT : ACK_TIMEOUT);
+    }
+
 private:
     // This is the buffer type for response messages
     struct resp_buff_type
@@ -84,6 +104,14 @@ private:
         uint32_t data[8];
     };
 
+    // Remembers which command an outstanding ACK belongs to
+    struct outstanding_cmd_type
+    {
+        size_t seq;
+        uint32_t addr;
+        uint32_t data;
+    };
+
     /*******************************************************************
      * Primary control and interaction private methods
      ******************************************************************/
@@ -129,7 +157,8 @@ private:
 
         //UHD_LOGGER_TRACE("RFNOC") << boost::format("0x%08x, 0x%08x\n") % addr % data;
         //send the buffer over the interface
-        _outstanding_seqs.push(_seq_out);
+        _outstanding_seqs.push(outstanding_cmd_type{_seq_out, addr, data});
+        _timed_outstanding = _timed_outstanding or bool(timestamp);
         buff->commit(sizeof(uint32_t)*(packet_info.num_packet_words32));
 
         _seq_out++;//inc seq for next call
@@ -139,110 +168,131 @@ private:
     {
         while (readback or (_outstanding_seqs.size() >= _max_outstanding_acks))
         {
-            //get seq to ack from outstanding packets list
-            UHD_ASSERT_THROW(not _outstanding_seqs.empty());
-            const size_t seq_to_ack = _outstanding_seqs.front();
-
-            //parse the packet
-            vrt::if_packet_info_t packet_info;
-            resp_buff_type resp_buff;
-            memset(&resp_buff, 0x00, sizeof(resp_buff));
-            uint32_t const *pkt = NULL;
-            managed_recv_buffer::sptr buff;
-
-            buff = _xports.recv->get_recv_buff(timeout);
-            try {
-                UHD_ASSERT_THROW(bool(buff));
-                UHD_ASSERT_THROW(buff->size() > 0);
-                _outstanding_seqs.pop();
+            const uint64_t value = this->recv_ack(timeout);
+
+            //return the readback value
+            if (readback and _outstanding_seqs.empty()) {
+                return value;
             }
-            catch(const std::exception &ex) {
-                throw uhd::io_error(str(
-                    boost::format("Block ctrl (%s) no response packet - %s")
-                    % _name
-                    % ex.what()
-                ));
+        }
+
+        return 0;
+    }
+
+    inline void flush_acks(const double timeout)
+    {
+        while (not _outstanding_seqs.empty()) {
+            this->recv_ack(timeout);
+        }
+    }
+
+    //! Receive and check the ACK of the oldest outstanding command, return its payload
+    inline uint64_t recv_ack(const double timeout)
+    {
+        //get seq to ack from outstanding packets list
+        UHD_ASSERT_THROW(not _outstanding_seqs.empty());
+        const outstanding_cmd_type cmd = _outstanding_seqs.front();
+        const size_t seq_to_ack = cmd.seq;
+
+        //parse the packet
+        vrt::if_packet_info_t packet_info;
+        resp_buff_type resp_buff;
+        memset(&resp_buff, 0x00, sizeof(resp_buff));
+        uint32_t const *pkt = NULL;
+        managed_recv_buffer::sptr buff;
+
+        buff = _xports.recv->get_recv_buff(timeout);
+        try {
+            UHD_ASSERT_THROW(bool(buff));
+            UHD_ASSERT_THROW(buff->size() > 0);
+            _outstanding_seqs.pop();
+            _timed_outstanding = _timed_outstanding and not _outstanding_seqs.empty();
+        }
+        catch(const std::exception &ex) {
+            throw uhd::io_error(str(
+                boost::format("Block ctrl (%s) no response packet for command 0x%X=0x%X - %s")
+                % _name
+                % cmd.addr % cmd.data
+                % ex.what()
+            ));
+        }
+        pkt = buff->cast<const uint32_t *>();
+        packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
+
+        //parse the buffer
+        try {
+            if (_endianness == uhd::ENDIANNESS_BIG) {
+                vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
+            } else {
+                vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
             }
-            pkt = buff->cast<const uint32_t *>();
-            packet_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
-
-            //parse the buffer
-            try {
-                if (_endianness == uhd::ENDIANNESS_BIG) {
-                    vrt::chdr::if_hdr_unpack_be(pkt, packet_info);
-                } else {
-                    vrt::chdr::if_hdr_unpack_le(pkt, packet_info);
-                }
+        }
+        catch(const std::exception &ex)
+        {
+            UHD_LOGGER_ERROR("RFNOC") << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() ;
+            if (buff){
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[0] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[1] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[2] ;
+                UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[3] ;
             }
-            catch(const std::exception &ex)
-            {
-                UHD_LOGGER_ERROR("RFNOC") << "[" << _name << "] Block ctrl bad VITA packet: " << ex.what() ;
-                if (buff){
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[0] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[1] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[2] ;
-                    UHD_LOGGER_INFO("RFNOC") << boost::format("%08X") % pkt[3] ;
-                }
-                else{
-                    UHD_LOGGER_INFO("RFNOC") << "buff is NULL" ;
-                }
+            else{
+                UHD_LOGGER_INFO("RFNOC") << "buff is NULL" ;
             }
+        }
 
-            //check the buffer
-            try {
-                UHD_ASSERT_THROW(packet_info.has_sid);
-                if (packet_info.sid != _xports.recv_sid.get()) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected SID: %s  Received SID: %s")
-                            % _xports.recv_sid.to_pp_string_hex()
-                            % uhd::sid_t(packet_info.sid).to_pp_string_hex()
-                        )
-                    );
-                }
-
-                if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
-                    throw uhd::io_error(
-                        str(
-                            boost::format("Expected packet index: %d " \
-                                          "Received index: %d")
-                            % (seq_to_ack & 0xfff)
-                            % packet_info.packet_count
-                        )
-                    );
-                }
-
-                UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
-            }
-            catch (const std::exception &ex) {
-                throw uhd::io_error(str(
-                    boost::format("Block ctrl (%s) packet parse error - %s")
-                    % _name
-                    % ex.what()
-                ));
+        //check the buffer
+        try {
+            UHD_ASSERT_THROW(packet_info.has_sid);
+            if (packet_info.sid != _xports.recv_sid.get()) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected SID: %s  Received SID: %s")
+                        % _xports.recv_sid.to_pp_string_hex()
+                        % uhd::sid_t(packet_info.sid).to_pp_string_hex()
+                    )
+                );
             }
 
-            //return the readback value
-            if (readback and _outstanding_seqs.empty()) {
-                const uint64_t hi = (_endianness == uhd::ENDIANNESS_BIG) ?
-                    uhd::ntohx(pkt[packet_info.num_header_words32+0])
-                    : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
-                const uint64_t lo = (_endianness == uhd::ENDIANNESS_BIG) ?
-                    uhd::ntohx(pkt[packet_info.num_header_words32+1])
-                    : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
-                return ((hi << 32) | lo);
+            if (packet_info.packet_count != (seq_to_ack & 0xfff)) {
+                throw uhd::io_error(
+                    str(
+                        boost::format("Expected packet index: %d " \
+                                      "Received index: %d")
+                        % (seq_to_ack & 0xfff)
+                        % packet_info.packet_count
+                    )
+                );
             }
+
+            UHD_ASSERT_THROW(packet_info.num_payload_words32 == 2);
+        }
+        catch (const std::exception &ex) {
+            throw uhd::io_error(str(
+                boost::format("Block ctrl (%s) packet parse error for command 0x%X=0x%X - %s")
+                % _name
+                % cmd.addr % cmd.data
+                % ex.what()
+            ));
         }
 
-        return 0;
+        const uint64_t hi = (_endianness == uhd::ENDIANNESS_BIG) ?
+            uhd::ntohx(pkt[packet_info.num_header_words32+0])
+            : uhd::wtohx(pkt[packet_info.num_header_words32+0]);
+        const uint64_t lo = (_endianness == uhd::ENDIANNESS_BIG) ?
+            uhd::ntohx(pkt[packet_info.num_header_words32+1])
+            : uhd::wtohx(pkt[packet_info.num_header_words32+1]);
+        return ((hi << 32) | lo);
     }
 
 
     const uhd::both_xports_t _xports;
     const std::string _name;
     size_t _seq_out;
-    std::queue<size_t> _outstanding_seqs;
+    std::queue<outstanding_cmd_type> _outstanding_seqs;
     const size_t _max_outstanding_acks;
+    //! True if any command sent since the last flush was timed
+    bool _timed_outstanding;
 
     boost::mutex _mutex;
 };
@@ -107,7 +107,10 @@ void block_iface::run_and_check(const std::string &code, const std::string &erro
     boost::mutex::scoped_lock local_interpreter_lock(_lil_mutex);
 
     UHD_NOCSCRIPT_LOG() << "[NocScript] Executing and asserting code: " << code ;
-    expression::sptr e = _parser->create_expr_tree(code);
+    expression::sptr &e = _compiled[code];
+    if (not e) {
+        e = _parser->create_expr_tree(code);
+    }
     expression_literal result = e->eval();
     if (not result.to_bool()) {
         if (error_message.empty()) {
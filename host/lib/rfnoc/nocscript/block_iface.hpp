@@ -76,6 +76,11 @@ class block_iface {
 
     //! Container for scoped variables
     std::map<std::string, expression_literal> _vars;
+
+    //! Compiled expression trees, by their source code. Argument checks and
+    // actions are run again every time an argument changes, so this saves
+    // parsing them every time.
+    std::map<std::string, expression::sptr> _compiled;
 };
 
 }}} /* namespace uhd::rfnoc::nocscript */
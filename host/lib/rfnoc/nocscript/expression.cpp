@@ -300,6 +300,13 @@ expression_literal expression_container::eval()
     return ret_val;
 }
 
+void expression_container::compile()
+{
+    for(const expression::sptr &sub_expr:  _sub_exprs) {
+        sub_expr->compile();
+    }
+}
+
 /********************************************************************
  * Functions
  *******************************************************************/
@@ -340,6 +347,8 @@ void expression_function::add(expression::sptr new_expr)
 {
     expression_container::add(new_expr);
     _arg_types.push_back(new_expr->infer_type());
+    // The signature changed, so any resolved function is stale
+    _function.clear();
 }
 
 expression::type_t expression_function::infer_type() const
@@ -349,7 +358,18 @@ expression::type_t expression_function::infer_type() const
 
 expression_literal expression_function::eval()
 {
-    return _func_table->eval(_name, _arg_types, _sub_exprs);
+    if (_function.empty()) {
+        _function = _func_table->get_function(_name, _arg_types);
+    }
+    return _function(_sub_exprs);
+}
+
+void expression_function::compile()
+{
+    if (_function.empty()) {
+        _function = _func_table->get_function(_name, _arg_types);
+    }
+    expression_container::compile();
 }
 
 
@@ -44,6 +44,16 @@ class expression
 
     //! Evaluate current expression and return its return value
     virtual expression_literal eval() = 0;
+
+    /*! Resolve everything that can be resolved before evaluation.
+     *
+     * Once an expression tree is complete, this may be called to do all
+     * lookups that don't depend on the values of variables (e.g. finding
+     * function objects in the function table). Calling eval() afterwards
+     * will not repeat them. Calling it is optional, eval() will resolve
+     * whatever is missing on first use.
+     */
+    virtual void compile() {};
 };
 
 /*! Literal (constant) expression class
@@ -243,6 +253,9 @@ class expression_container : public expression
      */
     virtual expression_literal eval();
 
+    //! Compile all sub-expressions
+    virtual void compile();
+
   protected:
     //! Store all the sub-expressions, in order
     expr_list_type _sub_exprs;
@@ -306,6 +319,12 @@ class expression_function : public expression_container
      */
     expression_literal eval();
 
+    /*! Look up the function object, then compile all arguments.
+     *
+     * \throws uhd::syntax_error if the signature is not in the function table
+     */
+    void compile();
+
     //! String representation
     std::string repr() const;
 
@@ -313,6 +332,8 @@ class expression_function : public expression_container
     std::string _name;
     const boost::shared_ptr<function_table> _func_table;
     std::vector<expression::type_t> _arg_types;
+    //! The resolved function object, empty until compiled
+    boost::function<expression_literal(expr_list_type&)> _function;
 };
 
 
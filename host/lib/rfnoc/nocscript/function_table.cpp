@@ -83,6 +83,20 @@ class function_table_impl : public function_table
         return _table[name][arg_types].function(arguments);
     }
 
+    function_ptr get_function(
+            const std::string &name,
+            const expression_function::argtype_list_type &arg_types
+    ) {
+        table_type::const_iterator it = _table.find(name);
+        if (it == _table.end() or (it->second.find(arg_types) == it->second.end())) {
+            throw uhd::syntax_error(str(
+                        boost::format("Cannot resolve function %s, not a known signature")
+                        % expression_function::to_string(name, arg_types)
+            ));
+        }
+        return it->second.find(arg_types)->second.function;
+    }
+
     void register_function(
             const std::string &name,
             const function_table::function_ptr &ptr,
@@ -7,6 +7,7 @@
 
 #include "expression.hpp"
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <vector>
 
@@ -62,6 +63,31 @@ class function_table
             expression_container::expr_list_type &arguments
     ) = 0;
 
+    /*! Look up the function object for a given name and argument type list
+     *
+     * Unlike eval(), the lookup only happens once. The returned function
+     * object can be called directly with the argument list.
+     *
+     * The default implementation returns a function object which calls
+     * eval() with \p name and \p arg_types.
+     *
+     * \returns A function object for the function
+     * \throws uhd::syntax_error if no such function is found
+     */
+    virtual function_ptr get_function(
+            const std::string &name,
+            const expression_function::argtype_list_type &arg_types
+    ) {
+        if (not function_exists(name, arg_types)) {
+            throw uhd::syntax_error(
+                    "Cannot resolve function "
+                    + expression_function::to_string(name, arg_types)
+                    + ", not a known signature"
+            );
+        }
+        return boost::bind(&function_table::eval, this, name, arg_types, _1);
+    }
+
     /*! Register a new function
      *
      * \param name Name of the function (e.g. 'ADD')
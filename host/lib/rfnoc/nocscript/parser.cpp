@@ -328,8 +328,10 @@ class parser_impl : public parser
             ));
         }
 
-        // Clear stack and return result
-        return P.get_result();
+        // Clear stack, resolve function lookups and return result
+        expression::sptr result = P.get_result();
+        result->compile();
+        return result;
     }
 
   private:
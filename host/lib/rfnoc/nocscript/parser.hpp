@@ -27,7 +27,9 @@ class parser
 
     /*! The main parsing call: Turn a string of code into an expression tree.
      *
-     * Evaluating the returned object will execute the code.
+     * Evaluating the returned object will execute the code. The returned
+     * tree is already compiled (see expression::compile()), and may be
+     * evaluated any number of times.
      *
      * \throws uhd::syntax_error if \p code contains syntax errors
      */
@@ -6,6 +6,7 @@
 //
 
 #include <uhd/stream.hpp>
+#include <uhd/exception.hpp>
 
 using namespace uhd;
 
@@ -14,7 +15,48 @@ rx_streamer::~rx_streamer(void)
     //empty
 }
 
+size_t rx_streamer::recv_borrowed(
+    borrowed_buffs_type &,
+    rx_metadata_t &,
+    const double
+){
+    throw uhd::not_implemented_error(
+        "This RX streamer does not support borrowing its receive buffers.");
+}
+
+void rx_streamer::release_borrowed(void)
+{
+    //empty
+}
+
+stream_stats_t rx_streamer::get_stats(void) const
+{
+    throw uhd::not_implemented_error(
+        "This RX streamer does not keep performance counters.");
+}
+
 tx_streamer::~tx_streamer(void)
 {
     //empty
 }
+
+size_t tx_streamer::borrow_send_buffs(
+    borrowed_buffs_type &,
+    const tx_metadata_t &,
+    const double
+){
+    throw uhd::not_implemented_error(
+        "This TX streamer does not support borrowing its send buffers.");
+}
+
+size_t tx_streamer::send_borrowed(const size_t)
+{
+    throw uhd::not_implemented_error(
+        "This TX streamer does not support borrowing its send buffers.");
+}
+
+stream_stats_t tx_streamer::get_stats(void) const
+{
+    throw uhd::not_implemented_error(
+        "This TX streamer does not keep performance counters.");
+}
@@ -93,6 +93,63 @@ UHD_INLINE static uint32_t vrt_to_chdr(const uint32_t vrt, const if_packet_info_
     return chdr;
 }
 
+/***********************************************************************
+ * common batch helpers
+ **********************************************************************/
+if_packet_batch_t::if_packet_batch_t(void):
+    link_type(if_packet_info_t::LINK_TYPE_NONE)
+{
+    /* NOP */
+}
+
+void if_packet_batch_t::resize(const size_t num_packets)
+{
+    info.resize(num_packets);
+    sid.resize(num_packets);
+    tsf.resize(num_packets);
+    packet_count.resize(num_packets);
+}
+
+//copy the per-packet fields into the struct-of-arrays form
+static void gather_batch_fields(if_packet_batch_t &batch)
+{
+    const size_t num_packets = batch.size();
+    batch.sid.resize(num_packets);
+    batch.tsf.resize(num_packets);
+    batch.packet_count.resize(num_packets);
+    for (size_t i = 0; i < num_packets; i++){
+        const if_packet_info_t &info = batch.info[i];
+        batch.sid[i] = info.has_sid? info.sid : 0;
+        batch.tsf[i] = info.has_tsf? info.tsf : 0;
+        batch.packet_count[i] = uint32_t(info.packet_count);
+    }
+}
+
+size_t vrt::find_sequence_error(
+    const if_packet_batch_t &batch,
+    const size_t expected_count
+){
+    const size_t num_packets = batch.size();
+    if (num_packets == 0) return 0;
+    const uint32_t mask =
+        (batch.link_type == if_packet_info_t::LINK_TYPE_NONE)? 0xf : 0xfff;
+    const uint32_t *counts = &batch.packet_count.front();
+    const uint32_t first = uint32_t(expected_count);
+
+    //branch-free pass over the whole batch, the common case is no error
+    uint32_t errors = 0;
+    for (size_t i = 0; i < num_packets; i++){
+        errors |= (counts[i] - (first + uint32_t(i))) & mask;
+    }
+    if (errors == 0) return num_packets;
+
+    //locate the first packet that broke the sequence
+    for (size_t i = 0; i < num_packets; i++){
+        if (((counts[i] - (first + uint32_t(i))) & mask) != 0) return i;
+    }
+    return num_packets;
+}
+
 ########################################################################
 <%def name="gen_code(XE_MACRO, suffix)">
 ########################################################################
@@ -259,37 +316,58 @@ UHD_INLINE void __if_hdr_unpack_${suffix}(
 /***********************************************************************
  * link layer + VRT IF packing
  **********************************************************************/
-void vrt::if_hdr_pack_${suffix}(
+UHD_INLINE void __if_hdr_pack_none_${suffix}(
     uint32_t *packet_buff,
     if_packet_info_t &if_packet_info
 ){
     uint32_t vrt_hdr_word32 = 0;
+    __if_hdr_pack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
+    packet_buff[0] = ${XE_MACRO}(vrt_hdr_word32);
+}
+
+UHD_INLINE void __if_hdr_pack_chdr_${suffix}(
+    uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
+    uint32_t vrt_hdr_word32 = 0;
+    __if_hdr_pack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
+    const uint32_t chdr = vrt_to_chdr(vrt_hdr_word32, if_packet_info);
+    packet_buff[0] = ${XE_MACRO}(chdr);
+}
+
+UHD_INLINE void __if_hdr_pack_vrlp_${suffix}(
+    uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
+    uint32_t vrt_hdr_word32 = 0;
+    __if_hdr_pack_${suffix}(packet_buff+2, if_packet_info, vrt_hdr_word32);
+    if_packet_info.num_header_words32 += 2;
+    if_packet_info.num_packet_words32 += 3;
+    packet_buff[0] = ${XE_MACRO}(VRLP);
+    packet_buff[1] = ${XE_MACRO}(uint32_t(
+        (if_packet_info.num_packet_words32 & 0xfffff) |
+        ((if_packet_info.packet_count & 0xfff) << 20)
+    ));
+    packet_buff[2] = ${XE_MACRO}(vrt_hdr_word32);
+    packet_buff[if_packet_info.num_packet_words32-1] = ${XE_MACRO}(VEND);
+}
+
+void vrt::if_hdr_pack_${suffix}(
+    uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
     switch (if_packet_info.link_type)
     {
     case if_packet_info_t::LINK_TYPE_NONE:
-        __if_hdr_pack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
-        packet_buff[0] = ${XE_MACRO}(vrt_hdr_word32);
+        __if_hdr_pack_none_${suffix}(packet_buff, if_packet_info);
         break;
 
     case if_packet_info_t::LINK_TYPE_CHDR:
-    {
-        __if_hdr_pack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
-        const uint32_t chdr = vrt_to_chdr(vrt_hdr_word32, if_packet_info);
-        packet_buff[0] = ${XE_MACRO}(chdr);
+        __if_hdr_pack_chdr_${suffix}(packet_buff, if_packet_info);
         break;
-    }
 
     case if_packet_info_t::LINK_TYPE_VRLP:
-        __if_hdr_pack_${suffix}(packet_buff+2, if_packet_info, vrt_hdr_word32);
-        if_packet_info.num_header_words32 += 2;
-        if_packet_info.num_packet_words32 += 3;
-        packet_buff[0] = ${XE_MACRO}(VRLP);
-        packet_buff[1] = ${XE_MACRO}(uint32_t(
-            (if_packet_info.num_packet_words32 & 0xfffff) |
-            ((if_packet_info.packet_count & 0xfff) << 20)
-        ));
-        packet_buff[2] = ${XE_MACRO}(vrt_hdr_word32);
-        packet_buff[if_packet_info.num_packet_words32-1] = ${XE_MACRO}(VEND);
+        __if_hdr_pack_vrlp_${suffix}(packet_buff, if_packet_info);
         break;
     }
 }
@@ -297,42 +375,100 @@ void vrt::if_hdr_pack_${suffix}(
 /***********************************************************************
  * link layer + VRT IF unpacking
  **********************************************************************/
+UHD_INLINE void __if_hdr_unpack_none_${suffix}(
+    const uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
+    const uint32_t vrt_hdr_word32 = ${XE_MACRO}(packet_buff[0]);
+    __if_hdr_unpack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
+}
+
+UHD_INLINE void __if_hdr_unpack_chdr_${suffix}(
+    const uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
+    const uint32_t chdr = ${XE_MACRO}(packet_buff[0]);
+    const uint32_t vrt_hdr_word32 = chdr_to_vrt(chdr, if_packet_info);
+    size_t packet_count = if_packet_info.packet_count;
+    __if_hdr_unpack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
+    if_packet_info.num_payload_bytes -= (~chdr + 1) & 0x3;
+    if_packet_info.packet_count = packet_count;
+}
+
+UHD_INLINE void __if_hdr_unpack_vrlp_${suffix}(
+    const uint32_t *packet_buff,
+    if_packet_info_t &if_packet_info
+){
+    if (${XE_MACRO}(packet_buff[0]) != VRLP) throw uhd::value_error("bad vrl header VRLP");
+    const uint32_t vrl_hdr = ${XE_MACRO}(packet_buff[1]);
+    const uint32_t vrt_hdr_word32 = ${XE_MACRO}(packet_buff[2]);
+    if (if_packet_info.num_packet_words32 < (vrl_hdr & 0xfffff)) throw uhd::value_error("bad vrl header or packet fragment");
+    if (${XE_MACRO}(packet_buff[(vrl_hdr & 0xfffff)-1]) != VEND) throw uhd::value_error("bad vrl trailer VEND");
+    __if_hdr_unpack_${suffix}(packet_buff+2, if_packet_info, vrt_hdr_word32);
+    if_packet_info.num_header_words32 += 2; //add vrl header
+    if_packet_info.packet_count = (vrl_hdr >> 20) & 0xfff;
+}
+
 void vrt::if_hdr_unpack_${suffix}(
     const uint32_t *packet_buff,
     if_packet_info_t &if_packet_info
 ){
-    uint32_t vrt_hdr_word32 = 0;
     switch (if_packet_info.link_type)
     {
     case if_packet_info_t::LINK_TYPE_NONE:
-        vrt_hdr_word32 = ${XE_MACRO}(packet_buff[0]);
-        __if_hdr_unpack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
+        __if_hdr_unpack_none_${suffix}(packet_buff, if_packet_info);
         break;
 
     case if_packet_info_t::LINK_TYPE_CHDR:
-    {
-        const uint32_t chdr = ${XE_MACRO}(packet_buff[0]);
-        vrt_hdr_word32 = chdr_to_vrt(chdr, if_packet_info);
-        size_t packet_count = if_packet_info.packet_count;
-        __if_hdr_unpack_${suffix}(packet_buff, if_packet_info, vrt_hdr_word32);
-        if_packet_info.num_payload_bytes -= (~chdr + 1) & 0x3;
-        if_packet_info.packet_count = packet_count;
+        __if_hdr_unpack_chdr_${suffix}(packet_buff, if_packet_info);
         break;
-    }
 
     case if_packet_info_t::LINK_TYPE_VRLP:
+        __if_hdr_unpack_vrlp_${suffix}(packet_buff, if_packet_info);
+        break;
+    }
+}
+
+/***********************************************************************
+ * batched link layer + VRT IF packing and unpacking
+ **********************************************************************/
+void vrt::if_hdr_pack_batch_${suffix}(
+    uint32_t *const *packet_buffs,
+    if_packet_batch_t &batch
+){
+    const size_t num_packets = batch.size();
+    switch (batch.link_type)
     {
-        if (${XE_MACRO}(packet_buff[0]) != VRLP) throw uhd::value_error("bad vrl header VRLP");
-        const uint32_t vrl_hdr = ${XE_MACRO}(packet_buff[1]);
-        vrt_hdr_word32 = ${XE_MACRO}(packet_buff[2]);
-        if (if_packet_info.num_packet_words32 < (vrl_hdr & 0xfffff)) throw uhd::value_error("bad vrl header or packet fragment");
-        if (${XE_MACRO}(packet_buff[(vrl_hdr & 0xfffff)-1]) != VEND) throw uhd::value_error("bad vrl trailer VEND");
-        __if_hdr_unpack_${suffix}(packet_buff+2, if_packet_info, vrt_hdr_word32);
-        if_packet_info.num_header_words32 += 2; //add vrl header
-        if_packet_info.packet_count = (vrl_hdr >> 20) & 0xfff;
+    % for link in ('none', 'chdr', 'vrlp'):
+    case if_packet_info_t::LINK_TYPE_${link.upper()}:
+        for (size_t i = 0; i < num_packets; i++){
+            batch.info[i].link_type = batch.link_type;
+            __if_hdr_pack_${link}_${suffix}(packet_buffs[i], batch.info[i]);
+        }
         break;
+
+    % endfor
     }
+}
+
+void vrt::if_hdr_unpack_batch_${suffix}(
+    const uint32_t *const *packet_buffs,
+    if_packet_batch_t &batch
+){
+    const size_t num_packets = batch.size();
+    switch (batch.link_type)
+    {
+    % for link in ('none', 'chdr', 'vrlp'):
+    case if_packet_info_t::LINK_TYPE_${link.upper()}:
+        for (size_t i = 0; i < num_packets; i++){
+            batch.info[i].link_type = batch.link_type;
+            __if_hdr_unpack_${link}_${suffix}(packet_buffs[i], batch.info[i]);
+        }
+        break;
+
+    % endfor
     }
+    gather_batch_fields(batch);
 }
 
 ########################################################################
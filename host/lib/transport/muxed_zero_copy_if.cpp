@@ -186,6 +186,12 @@ private:
             return _muxed_xport->base_xport()->get_send_buff(timeout);
         }
 
+        //! The counts of the base transport, shared by all streams
+        syscall_counters_t get_syscall_counters(void) const
+        {
+            return _muxed_xport->base_xport()->get_syscall_counters();
+        }
+
     private:
         const uint32_t                              _stream_num;
         muxed_zero_copy_if_impl::sptr               _muxed_xport;
@@ -19,10 +19,15 @@
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <uhdlib/rfnoc/rx_stream_terminator.hpp>
+#include <uhdlib/utils/stream_stats.hpp>
+#include <uhdlib/utils/no_alloc.hpp>
+#include <uhdlib/utils/tick_time.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/function.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -68,6 +73,12 @@ public:
      * \param size the number of transport channels
      */
     recv_packet_handler(const size_t size = 1):
+        _tick_rate(1.0),
+        _samp_rate(1.0),
+        _ticks_per_samp(1),
+        _batch_recv(false),
+        _no_alloc(false),
+        _no_alloc_armed(false),
         _queue_error_for_next_call(false),
         _buffers_infos_index(0)
     {
@@ -87,6 +98,7 @@ public:
     void resize(const size_t size){
         if (this->size() == size) return;
         _props.resize(size);
+        _borrowed_buffs.resize(size);
         //re-initialize all buffers infos by re-creating the vector
         _buffers_infos = std::vector<buffers_info_type>(4, buffers_info_type(size));
     }
@@ -114,11 +126,34 @@ public:
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate){
         _tick_rate = rate;
+        this->update_ticks_per_samp();
     }
 
     //! Set the rate of samples per second
     void set_samp_rate(const double rate){
         _samp_rate = rate;
+        this->update_ticks_per_samp();
+    }
+
+    /*!
+     * Enable batched receive.
+     * When enabled, recv() keeps appending packets to the user's buffers
+     * for as long as they continue the previous packet in time, checked
+     * with integer tick arithmetic. No per-packet metadata is built for
+     * these packets. Any discontinuity (gap in time, new burst, error)
+     * ends the batch, and the packet is returned by the next call.
+     */
+    void set_batch_recv(const bool enable){
+        _batch_recv = enable;
+    }
+
+    /*!
+     * Enable the no-allocation mode (stream arg no_alloc=1).
+     * recv() calls after the first one then run in a no_alloc::scope.
+     */
+    void set_no_alloc(const bool enable){
+        _no_alloc = enable;
+        _no_alloc_armed = false;
     }
 
     /*!
@@ -215,6 +250,32 @@ public:
         const double timeout,
         const bool one_packet
     ){
+        UHD_TRACE_SCOPE("streamer", "recv");
+        //the first call may still allocate, e.g., for thread-local rings
+        const no_alloc::scope no_alloc_scope(_no_alloc_armed);
+        _no_alloc_armed = _no_alloc;
+        const uint64_t start_ns = stream_stats_collector::now_ns();
+        const size_t nsamps = recv_and_align(
+            buffs, nsamps_per_buff, metadata, timeout, one_packet
+        );
+        _stats.call_time.add(stream_stats_collector::now_ns() - start_ns);
+        _stats.samples.add(nsamps);
+        return nsamps;
+    }
+
+    /*******************************************************************
+     * Receive and align:
+     * The body of recv(), without the performance counters.
+     ******************************************************************/
+    UHD_INLINE size_t recv_and_align(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t &metadata,
+        const double timeout,
+        const bool one_packet
+    ){
+        this->release_borrowed();
+
         //handle metadata queued from a previous receive
         if (_queue_error_for_next_call){
             _queue_error_for_next_call = false;
@@ -242,6 +303,23 @@ public:
 
         //loop until buffer is filled or error code
         while(accum_num_samps < nsamps_per_buff){
+            if (_batch_recv and can_batch_next_packet()){
+                const size_t num_samps = recv_contiguous_packet(
+                    buffs, nsamps_per_buff - accum_num_samps,
+                    timeout, accum_num_samps*_bytes_per_cpu_item
+                );
+
+                //discontinuity or error, the next call will handle it
+                if (num_samps == 0) break;
+
+                accum_num_samps += num_samps;
+
+                //return immediately if end of burst
+                metadata.end_of_burst = get_curr_buffer_info().metadata.end_of_burst;
+                if (metadata.end_of_burst) break;
+                continue;
+            }
+
             size_t num_samps = recv_one_packet(
                 buffs, nsamps_per_buff - accum_num_samps, _queue_metadata,
                 timeout, accum_num_samps*_bytes_per_cpu_item
@@ -268,10 +346,74 @@ public:
         return accum_num_samps;
     }
 
+    /*******************************************************************
+     * Receive borrowed:
+     * Hand out the wire payload of one aligned packet per channel
+     * without conversion. The managed buffers are held until released.
+     ******************************************************************/
+    UHD_INLINE size_t recv_borrowed(
+        uhd::rx_streamer::borrowed_buffs_type &buffs,
+        uhd::rx_metadata_t &metadata,
+        const double timeout
+    ){
+        this->release_borrowed();
+        buffs.assign(this->size(), nullptr);
+
+        //handle metadata queued from a previous receive
+        if (_queue_error_for_next_call){
+            _queue_error_for_next_call = false;
+            metadata = _queue_metadata;
+            if (_queue_metadata.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT) return 0;
+        }
+
+        //get the next buffer if the current one has expired
+        if (get_curr_buffer_info().data_bytes_to_copy == 0)
+        {
+            //perform receive with alignment logic
+            get_aligned_buffs(timeout);
+        }
+
+        buffers_info_type &info = get_curr_buffer_info();
+        metadata = info.metadata;
+        metadata.time_spec = get_time_spec(info, info.fragment_offset_in_samps);
+        metadata.more_fragments = false;
+        metadata.fragment_offset = info.fragment_offset_in_samps;
+        if (info.data_bytes_to_copy == 0) return 0;
+
+        //take ownership of the buffers, the handler is done with them
+        for (size_t i = 0; i < this->size(); i++){
+            buffs[i] = info[i].copy_buff;
+            _borrowed_buffs[i].swap(info[i].buff);
+            info[i].copy_buff = nullptr;
+        }
+
+        const size_t nitems = info.data_bytes_to_copy/_bytes_per_otw_item;
+        info.fragment_offset_in_samps += nitems;
+        info.data_bytes_to_copy = 0;
+        _stats.samples.add(nitems);
+        return nitems;
+    }
+
+    //! Release the buffers handed out by recv_borrowed()
+    void release_borrowed(void){
+        for (size_t i = 0; i < _borrowed_buffs.size(); i++){
+            _borrowed_buffs[i].reset();
+        }
+    }
+
+    //! Get a snapshot of the performance counters
+    uhd::stream_stats_t get_stats(void) const{
+        return _stats.get();
+    }
+
 private:
     vrt_unpacker_type _vrt_unpacker;
     size_t _header_offset_words32;
     double _tick_rate, _samp_rate;
+    uint64_t _ticks_per_samp; //0 when not an integer ratio
+    bool _batch_recv;
+    bool _no_alloc;
+    bool _no_alloc_armed;
     bool _queue_error_for_next_call;
     size_t _alignment_failure_threshold;
     rx_metadata_t _queue_metadata;
@@ -294,6 +436,8 @@ private:
     size_t _bytes_per_otw_item; //used in conversion
     size_t _bytes_per_cpu_item; //used in conversion
     uhd::convert::converter::sptr _converter; //used in conversion
+    std::vector<managed_recv_buffer::sptr> _borrowed_buffs; //held by recv_borrowed
+    stream_stats_collector _stats;
 
     //! information stored for a received buffer
     struct per_buffer_info_type{
@@ -319,7 +463,8 @@ private:
             alignment_time(0),
             alignment_time_valid(false),
             data_bytes_to_copy(0),
-            fragment_offset_in_samps(0)
+            fragment_offset_in_samps(0),
+            time_spec_from_ticks(false)
         {/* NOP */}
         void reset()
         {
@@ -328,6 +473,7 @@ private:
             alignment_time_valid = false;
             data_bytes_to_copy = 0;
             fragment_offset_in_samps = 0;
+            time_spec_from_ticks = false;
             metadata.reset();
             for (size_t i = 0; i < size(); i++)
                 at(i).reset();
@@ -337,6 +483,7 @@ private:
         bool alignment_time_valid; //used in alignment logic
         size_t data_bytes_to_copy; //keeps track of state
         size_t fragment_offset_in_samps; //keeps track of state
+        bool time_spec_from_ticks; //metadata time is derived lazily from the packet time
         rx_metadata_t metadata; //packet description
     };
 
@@ -378,7 +525,9 @@ private:
         while (1)
         {
             //get a single packet from the transport layer
+            const uint64_t start_ns = stream_stats_collector::now_ns();
             buff = _props[index].get_buff(timeout);
+            _stats.xport_time.add(stream_stats_collector::now_ns() - start_ns);
             if (buff.get() == nullptr) return PACKET_TIMEOUT_ERROR;
 
             #ifdef  ERROR_INJECT_DROPPED_PACKETS
@@ -428,6 +577,11 @@ private:
             break;
         }
 
+        if (info.ifpi.packet_type == vrt::if_packet_info_t::PACKET_TYPE_DATA){
+            _stats.packets.add(1);
+            _stats.bytes.add(buff->size());
+        }
+
         //--------------------------------------------------------------
         //-- Determine return conditions:
         //-- The order of these checks is HOLY.
@@ -551,6 +705,7 @@ private:
      * The logic will throw out older packets until it finds a match.
      ******************************************************************/
     UHD_INLINE void get_aligned_buffs(double timeout){
+        UHD_TRACE_SCOPE("streamer", "get_aligned_buffs");
 
         get_prev_buffer_info().reset(); // no longer need the previous info - reset it for future use
 
@@ -624,8 +779,14 @@ private:
                     rx_metadata_t metadata = curr_info.metadata;
                     _props[index].handle_overflow();
                     curr_info.metadata = metadata;
+                    _stats.overflows.add(1);
+                    UHD_TRACE_INSTANT("streamer", "overflow", index,
+                        curr_info.metadata.time_spec.get_real_secs());
                     UHD_LOG_FASTPATH("O");
                 }
+                else if (curr_info.metadata.error_code == rx_metadata_t::ERROR_CODE_LATE_COMMAND){
+                    _stats.late.add(1);
+                }
                 return;
 
             case PACKET_TIMEOUT_ERROR:
@@ -634,16 +795,20 @@ private:
                     _props[index].handle_flowctrl(next_info[index].ifpi.packet_count);
                 }
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                _stats.timeouts.add(1);
                 return;
 
             case PACKET_SEQUENCE_ERROR:
                 alignment_check(index, curr_info);
                 std::swap(curr_info, next_info); //save progress from curr -> next
                 curr_info.metadata.has_time_spec = prev_info.metadata.has_time_spec;
-                curr_info.metadata.time_spec = prev_info.metadata.time_spec + time_spec_t::from_ticks(
-                    prev_info[index].ifpi.num_payload_words32*sizeof(uint32_t)/_bytes_per_otw_item, _samp_rate);
+                curr_info.metadata.time_spec = get_time_spec(prev_info,
+                    prev_info[index].ifpi.num_payload_words32*sizeof(uint32_t)/_bytes_per_otw_item);
                 curr_info.metadata.out_of_sequence = true;
                 curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+                _stats.sequence_errors.add(1);
+                UHD_TRACE_INSTANT("streamer", "sequence_error", index,
+                    curr_info.metadata.time_spec.get_real_secs());
                 UHD_LOG_FASTPATH("D");
                 return;
 
@@ -665,12 +830,14 @@ private:
         }
 
         //set the metadata from the buffer information at index zero
+        //(the time spec is only computed when handed to the user)
         curr_info.metadata.has_time_spec = curr_info[0].ifpi.has_tsf;
-        curr_info.metadata.time_spec = time_spec_t::from_ticks(curr_info[0].time, _tick_rate);
+        curr_info.time_spec_from_ticks = true;
         curr_info.metadata.more_fragments = false;
         curr_info.metadata.fragment_offset = 0;
         curr_info.metadata.error_code = rx_metadata_t::ERROR_CODE_NONE;
-
+        UHD_TRACE_INSTANT("streamer", "aligned", 0,
+            time_spec_t::from_ticks(curr_info[0].time, _tick_rate).get_real_secs());
     }
 
     /*******************************************************************
@@ -697,7 +864,76 @@ private:
         metadata = info.metadata;
 
         //interpolate the time spec (useful when this is a fragment)
-        metadata.time_spec += time_spec_t::from_ticks(info.fragment_offset_in_samps, _samp_rate);
+        metadata.time_spec = get_time_spec(info, info.fragment_offset_in_samps);
+        metadata.fragment_offset = info.fragment_offset_in_samps;
+
+        const size_t nsamps_to_copy_per_io_buff = convert_curr_buffer(
+            buffs, nsamps_per_buff, buffer_offset_bytes
+        );
+
+        //setup the fragment flags
+        metadata.more_fragments = info.data_bytes_to_copy != 0;
+
+        return nsamps_to_copy_per_io_buff;
+    }
+
+    /*******************************************************************
+     * Receive a contiguous packet on all channels (batched mode)
+     * Gets the next aligned packet and copy-converts it only when it
+     * directly continues the previous one in time. No metadata is
+     * produced; errors are queued for the next call to recv().
+     * Returns 0 when the batch must end.
+     ******************************************************************/
+    UHD_INLINE bool can_batch_next_packet(void){
+        const buffers_info_type &info = get_curr_buffer_info();
+        return _ticks_per_samp != 0
+            and _num_outputs == 1
+            and info.time_spec_from_ticks
+            and info.metadata.has_time_spec
+            and info.data_bytes_to_copy == 0;
+    }
+
+    UHD_INLINE size_t recv_contiguous_packet(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const double timeout,
+        const size_t buffer_offset_bytes
+    ){
+        //where the previous packet ends, in ticks
+        const per_buffer_info_type &prev = get_curr_buffer_info()[0];
+        const uint64_t next_time = prev.time
+            + (prev.ifpi.num_payload_bytes/_bytes_per_otw_item)*_ticks_per_samp;
+
+        get_aligned_buffs(timeout);
+        buffers_info_type &info = get_curr_buffer_info();
+
+        if (info.metadata.error_code != rx_metadata_t::ERROR_CODE_NONE){
+            _queue_metadata = info.metadata;
+            _queue_metadata.time_spec = get_time_spec(info, 0);
+            _queue_error_for_next_call = true;
+            return 0;
+        }
+
+        if (not info.metadata.has_time_spec
+            or info.metadata.start_of_burst
+            or info[0].time != next_time){
+            return 0;
+        }
+
+        return convert_curr_buffer(buffs, nsamps_per_buff, buffer_offset_bytes);
+    }
+
+    /*!
+     * Copy-convert the data left in the current buffers into the user's
+     * output buffers, and advance the buffers' state.
+     * \return the number of samples written per output buffer
+     */
+    UHD_INLINE size_t convert_curr_buffer(
+        const uhd::rx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const size_t buffer_offset_bytes
+    ){
+        buffers_info_type &info = get_curr_buffer_info();
 
         //extract the number of samples available to copy
         const size_t nsamps_available = info.data_bytes_to_copy/_bytes_per_otw_item;
@@ -712,21 +948,55 @@ private:
         _convert_bytes_to_copy = bytes_to_copy;
 
         //perform N channels of conversion
-        for (size_t i = 0; i < this->size(); i++) {
-            convert_to_out_buff(i);
+        {
+            UHD_TRACE_SCOPE("streamer", "convert");
+            const uint64_t start_ns = stream_stats_collector::now_ns();
+            for (size_t i = 0; i < this->size(); i++) {
+                convert_to_out_buff(i);
+            }
+            _stats.convert_time.add(stream_stats_collector::now_ns() - start_ns);
         }
 
         //update the copy buffer's availability
         info.data_bytes_to_copy -= bytes_to_copy;
-
-        //setup the fragment flags and offset
-        metadata.more_fragments = info.data_bytes_to_copy != 0;
-        metadata.fragment_offset = info.fragment_offset_in_samps;
         info.fragment_offset_in_samps += nsamps_to_copy; //set for next call
 
         return nsamps_to_copy_per_io_buff;
     }
 
+    /*!
+     * Get the time of a sample within the given buffers.
+     * For packets that were received without errors, the time is derived
+     * from the packet's tick count. When the tick rate is an integer
+     * multiple of the sample rate, the offset is added in the tick domain,
+     * which needs a single conversion and does not accumulate rounding.
+     */
+    UHD_INLINE time_spec_t get_time_spec(
+        const buffers_info_type &info, const size_t offset_in_samps
+    ){
+        if (not info.time_spec_from_ticks){
+            if (offset_in_samps == 0) return info.metadata.time_spec;
+            return info.metadata.time_spec
+                + time_spec_t::from_ticks(offset_in_samps, _samp_rate);
+        }
+        tick_time_t time(info[0].time, _tick_rate);
+        if (_ticks_per_samp != 0){
+            time += offset_in_samps*_ticks_per_samp;
+            return time.to_time_spec();
+        }
+        return time.to_time_spec()
+            + time_spec_t::from_ticks(offset_in_samps, _samp_rate);
+    }
+
+    //! Cache the tick/sample ratio for integer time math
+    void update_ticks_per_samp(void){
+        const double ratio = _tick_rate/_samp_rate;
+        const double ratio_int = std::floor(ratio + 0.5);
+        const bool is_int = ratio_int >= 1.0
+            and std::abs(ratio - ratio_int) < 1e-9*ratio_int;
+        _ticks_per_samp = is_int? uint64_t(ratio_int) : 0;
+    }
+
     /*! Run the conversion from the internal buffers to the user's output
      *  buffer.
      *
@@ -852,11 +1122,29 @@ public:
         return recv_packet_handler::recv(buffs, nsamps_per_buff, metadata, timeout, one_packet);
     }
 
+    size_t recv_borrowed(
+        rx_streamer::borrowed_buffs_type &buffs,
+        uhd::rx_metadata_t &metadata,
+        const double timeout
+    ){
+        return recv_packet_handler::recv_borrowed(buffs, metadata, timeout);
+    }
+
+    void release_borrowed(void)
+    {
+        recv_packet_handler::release_borrowed();
+    }
+
     void issue_stream_cmd(const stream_cmd_t &stream_cmd)
     {
         return recv_packet_handler::issue_stream_cmd(stream_cmd);
     }
 
+    uhd::stream_stats_t get_stats(void) const
+    {
+        return recv_packet_handler::get_stats();
+    }
+
 private:
     size_t _max_num_samps;
 };
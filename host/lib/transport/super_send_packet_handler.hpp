@@ -19,7 +19,12 @@
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/transport/zero_copy.hpp>
 #include <uhdlib/rfnoc/tx_stream_terminator.hpp>
+#include <uhdlib/utils/no_alloc.hpp>
+#include <uhdlib/utils/stream_stats.hpp>
+#include <uhdlib/utils/tick_time.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/function.hpp>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -50,6 +55,7 @@ public:
     typedef std::function<managed_send_buffer::sptr(double)> get_buff_type;
     typedef std::function<void(void)> post_send_cb_type;
     typedef std::function<bool(uhd::async_metadata_t &, const double)> async_receiver_type;
+    typedef std::function<uhd::time_spec_t(void)> time_now_type;
     typedef void(*vrt_packer_type)(uint32_t *, vrt::if_packet_info_t &);
     //typedef std::function<void(uint32_t *, vrt::if_packet_info_t &)> vrt_packer_type;
 
@@ -58,7 +64,8 @@ public:
      * \param size the number of transport channels
      */
     send_packet_handler(const size_t size = 1):
-        _next_packet_seq(0), _cached_metadata(false)
+        _next_packet_seq(0), _no_alloc(false), _no_alloc_armed(false),
+        _cached_metadata(false), _has_borrowed(false)
     {
         this->set_enable_trailer(true);
         this->resize(size);
@@ -98,6 +105,16 @@ public:
         _has_tlr = enable;
     }
 
+    /*!
+     * Enable the no-allocation mode (stream arg no_alloc=1).
+     * send() calls after the first one then run in a no_alloc::scope.
+     */
+    void set_no_alloc(const bool enable)
+    {
+        _no_alloc = enable;
+        _no_alloc_armed = false;
+    }
+
     //! Set the rate of ticks per second
     void set_tick_rate(const double rate){
         _tick_rate = rate;
@@ -161,15 +178,33 @@ public:
         _async_receiver = async_receiver;
     }
 
+    /*!
+     * Set the function to read the device time. It is used to measure how
+     * long before their time spec timed bursts reach the transport.
+     */
+    void set_time_source(const time_now_type &time_now)
+    {
+        _time_now = time_now;
+    }
+
     //! Overload call to get async metadata
     bool recv_async_msg(
         uhd::async_metadata_t &async_metadata, double timeout = 0.1
     ){
-        if (_async_receiver) return _async_receiver(async_metadata, timeout);
+        if (_async_receiver){
+            if (not _async_receiver(async_metadata, timeout)) return false;
+            _stats.count_async_msg(async_metadata);
+            return true;
+        }
         std::this_thread::sleep_for(std::chrono::microseconds(long(timeout*1e6)));
         return false;
     }
 
+    //! Get a snapshot of the performance counters
+    uhd::stream_stats_t get_stats(void) const{
+        return _stats.get();
+    }
+
     /*******************************************************************
      * Send:
      * The entry point for the fast-path send calls.
@@ -181,18 +216,36 @@ public:
         const uhd::tx_metadata_t &metadata,
         const double timeout
     ){
+        UHD_TRACE_SCOPE("streamer", "send", metadata.has_time_spec
+            ? metadata.time_spec.get_real_secs() : uhd::trace::no_device_time());
+        //the first call may still allocate, e.g., for thread-local rings
+        const no_alloc::scope no_alloc_scope(_no_alloc_armed);
+        _no_alloc_armed = _no_alloc;
+        const uint64_t start_ns = stream_stats_collector::now_ns();
+        const size_t nsamps = send_and_fragment(
+            buffs, nsamps_per_buff, metadata, timeout
+        );
+        _stats.call_time.add(stream_stats_collector::now_ns() - start_ns);
+        _stats.samples.add(nsamps);
+        if (nsamps < nsamps_per_buff) _stats.timeouts.add(1);
+        return nsamps;
+    }
+
+    /*******************************************************************
+     * Send and fragment:
+     * The body of send(), without the performance counters.
+     ******************************************************************/
+    UHD_INLINE size_t send_and_fragment(
+        const uhd::tx_streamer::buffs_type &buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        //the packet time in ticks, computed once for all fragments
+        const tick_time_t tsf = tick_time_t::from_time_spec(metadata.time_spec, _tick_rate);
+
         //translate the metadata to vrt if packet info
-        vrt::if_packet_info_t if_packet_info;
-        if_packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
-        //if_packet_info.has_sid = false; //set per channel
-        if_packet_info.has_cid = false;
-        if_packet_info.has_tlr = _has_tlr;
-        if_packet_info.has_tsi = false;
-        if_packet_info.has_tsf = metadata.has_time_spec;
-        if_packet_info.tsf     = metadata.time_spec.to_ticks(_tick_rate);
-        if_packet_info.sob     = metadata.start_of_burst;
-        if_packet_info.eob     = metadata.end_of_burst;
-        if_packet_info.fc_ack  = false; //This is a data packet
+        vrt::if_packet_info_t if_packet_info = make_if_packet_info(metadata, tsf);
 
         /*
          * Metadata is cached when we get a send requesting a start of burst with no samples.
@@ -259,8 +312,7 @@ public:
                 return total_num_samps_sent;
 
             //setup metadata for the next fragment
-            const time_spec_t time_spec = metadata.time_spec; // + time_spec_t::from_ticks(total_num_samps_sent, _samp_rate);
-            if_packet_info.tsf = time_spec.to_ticks(_tick_rate);
+            if_packet_info.tsf = tsf.get_ticks(); // + total_num_samps_sent in ticks
             if_packet_info.sob = false;
 
         }
@@ -275,6 +327,82 @@ public:
 		return nsamps_sent;
     }
 
+    /*******************************************************************
+     * Borrow send buffers:
+     * Hand out the payload of the next packet of each channel, so the
+     * caller can write wire items without any conversion.
+     ******************************************************************/
+    UHD_INLINE size_t borrow_send_buffs(
+        uhd::tx_streamer::borrowed_buffs_type &buffs,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        //get a buffer for each channel or timeout
+        _convert_nsamps = _max_samples_per_packet;
+        if (not get_buffs(timeout)) return 0; //timeout
+
+        //the header length depends on the metadata, so fix it now
+        _borrowed_if_packet_info = make_if_packet_info(metadata,
+            tick_time_t::from_time_spec(metadata.time_spec, _tick_rate));
+        vrt::if_packet_info_t if_packet_info = _borrowed_if_packet_info;
+        if_packet_info.num_payload_bytes = 0;
+        if_packet_info.num_payload_words32 = 0;
+
+        buffs.resize(this->size());
+        for (size_t i = 0; i < this->size(); i++){
+            uint32_t *otw_mem = _props[i].buff->cast<uint32_t *>() + _header_offset_words32;
+            if_packet_info.has_sid = _props[i].has_sid;
+            if_packet_info.sid = _props[i].sid;
+            _vrt_packer(otw_mem, if_packet_info);
+            buffs[i] = otw_mem + if_packet_info.num_header_words32;
+        }
+        _borrowed_payloads = buffs;
+        _has_borrowed = true;
+        return _max_samples_per_packet;
+    }
+
+    /*******************************************************************
+     * Send borrowed:
+     * Pack the headers into the borrowed buffers and commit them.
+     ******************************************************************/
+    UHD_INLINE size_t send_borrowed(const size_t nsamps_per_buff){
+        if (not _has_borrowed){
+            throw uhd::runtime_error(
+                "Cannot send borrowed buffers! No buffers were borrowed.");
+        }
+        UHD_ASSERT_THROW(nsamps_per_buff <= _max_samples_per_packet);
+        _has_borrowed = false;
+
+        size_t num_items = nsamps_per_buff;
+        //TODO remove this code when sample counts of zero are supported by hardware
+        #ifndef SSPH_DONT_PAD_TO_ONE
+            if (num_items == 0){
+                for (size_t i = 0; i < this->size(); i++){
+                    std::memset(_borrowed_payloads[i], 0, _num_inputs*_bytes_per_otw_item);
+                }
+                num_items = 1;
+            }
+        #endif
+
+        vrt::if_packet_info_t if_packet_info = _borrowed_if_packet_info;
+        if_packet_info.num_payload_bytes = num_items*_num_inputs*_bytes_per_otw_item;
+        if_packet_info.num_payload_words32 = (if_packet_info.num_payload_bytes + 3/*round up*/)/sizeof(uint32_t);
+        if_packet_info.packet_count = _next_packet_seq;
+
+        for (size_t i = 0; i < this->size(); i++){
+            uint32_t *otw_mem = _props[i].buff->cast<uint32_t *>() + _header_offset_words32;
+            if_packet_info.has_sid = _props[i].has_sid;
+            if_packet_info.sid = _props[i].sid;
+            _vrt_packer(otw_mem, if_packet_info);
+            commit_and_release(i, if_packet_info.num_packet_words32);
+        }
+        record_deadline(if_packet_info);
+
+        _next_packet_seq++; //increment sequence after commits
+        _stats.samples.add(nsamps_per_buff);
+        return nsamps_per_buff;
+    }
+
 private:
 
     vrt_packer_type _vrt_packer;
@@ -296,10 +424,17 @@ private:
     size_t _max_samples_per_packet;
     std::vector<const void *> _zero_buffs;
     size_t _next_packet_seq;
+    bool _no_alloc;
+    bool _no_alloc_armed;
     bool _has_tlr;
     async_receiver_type _async_receiver;
     bool _cached_metadata;
     uhd::tx_metadata_t _metadata_cache;
+    bool _has_borrowed;
+    vrt::if_packet_info_t _borrowed_if_packet_info;
+    std::vector<void *> _borrowed_payloads;
+    time_now_type _time_now;
+    stream_stats_collector _stats;
 
 #ifdef UHD_TXRX_DEBUG_PRINTS
     struct dbg_send_stat_t {
@@ -346,6 +481,61 @@ private:
 
 #endif
 
+    //! Translate the metadata to vrt if packet info
+    UHD_INLINE vrt::if_packet_info_t make_if_packet_info(
+        const uhd::tx_metadata_t &metadata,
+        const tick_time_t &tsf
+    ){
+        vrt::if_packet_info_t if_packet_info;
+        if_packet_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        //if_packet_info.has_sid = false; //set per channel
+        if_packet_info.has_cid = false;
+        if_packet_info.has_tlr = _has_tlr;
+        if_packet_info.has_tsi = false;
+        if_packet_info.has_tsf = metadata.has_time_spec;
+        if_packet_info.tsf     = tsf.get_ticks();
+        if_packet_info.sob     = metadata.start_of_burst;
+        if_packet_info.eob     = metadata.end_of_burst;
+        if_packet_info.fc_ack  = false; //This is a data packet
+        return if_packet_info;
+    }
+
+    //! Get a buffer for each channel, return false on timeout
+    UHD_INLINE bool get_buffs(const double timeout)
+    {
+        UHD_TRACE_SCOPE("streamer", "get_buffs");
+        const uint64_t start_ns = stream_stats_collector::now_ns();
+        bool ok = true;
+        for (xport_chan_props_type &props : _props){
+            if (not props.buff) props.buff = props.get_buff(timeout);
+            if (not props.buff){
+                ok = false;
+                break;
+            }
+        }
+        _stats.fc_wait_time.add(stream_stats_collector::now_ns() - start_ns);
+        return ok;
+    }
+
+    //! Commit a packed buffer to the zero-copy interface and release it
+    UHD_INLINE void commit_and_release(const size_t index, const size_t num_packet_words32)
+    {
+        UHD_TRACE_SCOPE("streamer", "commit");
+        managed_send_buffer::sptr &buff = _props[index].buff;
+        const size_t num_bytes = (_header_offset_words32+num_packet_words32)*sizeof(uint32_t);
+        const uint64_t start_ns = stream_stats_collector::now_ns();
+        buff->commit(num_bytes);
+        buff.reset(); //effectively a release
+        _stats.xport_time.add(stream_stats_collector::now_ns() - start_ns);
+        _stats.packets.add(1);
+        _stats.bytes.add(num_bytes);
+
+        if (_props[index].go_postal)
+        {
+            _props[index].go_postal();
+        }
+    }
+
     /*******************************************************************
      * Send a single packet:
      ******************************************************************/
@@ -367,11 +557,8 @@ private:
         _convert_nsamps = nsamps_per_buff;
 
         //get a buffer for each channel or timeout
-        BOOST_FOREACH(xport_chan_props_type &props, _props){
-            //We need to get nsamps_per_buff into crimson. How how how how
-            if (not props.buff) props.buff = props.get_buff(timeout);
-            if (not props.buff) return 0; //timeout
-        }
+        //We need to get nsamps_per_buff into crimson. How how how how
+        if (not get_buffs(timeout)) return 0; //timeout
 
         //setup the data to share with converter threads
         _convert_nsamps = nsamps_per_buff;
@@ -380,14 +567,34 @@ private:
         _convert_if_packet_info = &if_packet_info;
 
         //perform N channels of conversion
+        _convert_ns = 0;
         for (size_t i = 0; i < this->size(); i++) {
             convert_to_in_buff(i);
         }
+        _stats.convert_time.add(_convert_ns);
+        record_deadline(if_packet_info);
 
         _next_packet_seq++; //increment sequence after commits
         return nsamps_per_buff;
     }
 
+    /*!
+     * Record the time left until the time spec of a timed burst, once its
+     * first packet is committed. Needs the device time.
+     */
+    UHD_INLINE void record_deadline(const vrt::if_packet_info_t &if_packet_info)
+    {
+        if (not (_time_now and if_packet_info.sob and if_packet_info.has_tsf)) return;
+        const double time_left = (
+            time_spec_t::from_ticks(if_packet_info.tsf, _tick_rate) - _time_now()
+        ).get_real_secs();
+        if (time_left < 0.0){
+            _stats.late.add(1);
+            return;
+        }
+        _stats.deadline_time.add(uint64_t(time_left*1e9));
+    }
+
     /*! Run the conversion from the internal buffers to the user's input
      *  buffer.
      *
@@ -419,17 +626,15 @@ private:
         otw_mem += if_packet_info.num_header_words32;
 
         //perform the conversion operation
-        _converter->conv(in_buffs, otw_mem, _convert_nsamps);
-
-        //commit the samples to the zero-copy interface
-        const size_t num_vita_words32 = _header_offset_words32+if_packet_info.num_packet_words32;
-        buff->commit(num_vita_words32*sizeof(uint32_t));
-        buff.reset(); //effectively a release
-
-        if (_props[index].go_postal)
         {
-            _props[index].go_postal();
+            UHD_TRACE_SCOPE("streamer", "convert");
+            const uint64_t start_ns = stream_stats_collector::now_ns();
+            _converter->conv(in_buffs, otw_mem, _convert_nsamps);
+            _convert_ns += stream_stats_collector::now_ns() - start_ns;
         }
+
+        //commit the samples to the zero-copy interface
+        commit_and_release(index, if_packet_info.num_packet_words32);
     }
 
     //! Shared variables for the worker threads
@@ -437,6 +642,7 @@ private:
     const tx_streamer::buffs_type *_convert_buffs;
     size_t _convert_buffer_offset_bytes;
     vrt::if_packet_info_t *_convert_if_packet_info;
+    uint64_t _convert_ns;
 
 };
 
@@ -464,12 +670,28 @@ public:
         return send_packet_handler::send(buffs, nsamps_per_buff, metadata, timeout);
     }
 
+    size_t borrow_send_buffs(
+        tx_streamer::borrowed_buffs_type &buffs,
+        const uhd::tx_metadata_t &metadata,
+        const double timeout
+    ){
+        return send_packet_handler::borrow_send_buffs(buffs, metadata, timeout);
+    }
+
+    size_t send_borrowed(const size_t nsamps_per_buff){
+        return send_packet_handler::send_borrowed(nsamps_per_buff);
+    }
+
     bool recv_async_msg(
         uhd::async_metadata_t &async_metadata, double timeout = 0.1
     ){
         return send_packet_handler::recv_async_msg(async_metadata, timeout);
     }
 
+    uhd::stream_stats_t get_stats(void) const{
+        return send_packet_handler::get_stats();
+    }
+
 private:
     size_t _max_num_samps;
 };
@@ -9,7 +9,9 @@
 #define INCLUDED_LIBUHD_TRANSPORT_VRT_PACKET_HANDLER_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/transport/zero_copy.hpp>
 #include <boost/asio.hpp>
+#include <atomic>
 
 namespace uhd{ namespace transport{
 
@@ -23,6 +25,40 @@ namespace uhd{ namespace transport{
 
     typedef boost::shared_ptr<boost::asio::ip::udp::socket> socket_sptr;
 
+    /*!
+     * System call counters of a socket transport.
+     * Each side (receive and send) is driven by one thread at a time, so
+     * the counters are only read atomically, not incremented atomically,
+     * and the two sides sit on separate cache lines.
+     */
+    class socket_syscall_counters {
+    public:
+        socket_syscall_counters(void): _recv(0), _poll(0), _send(0) {}
+
+        UHD_INLINE void count_recv(void){ increment(_recv); }
+        UHD_INLINE void count_poll(void){ increment(_poll); }
+        UHD_INLINE void count_send(void){ increment(_send); }
+
+        zero_copy_if::syscall_counters_t get(void) const{
+            zero_copy_if::syscall_counters_t counters;
+            counters.recv = _recv.load(std::memory_order_relaxed);
+            counters.send = _send.load(std::memory_order_relaxed);
+            counters.poll = _poll.load(std::memory_order_relaxed);
+            return counters;
+        }
+
+    private:
+        static UHD_INLINE void increment(std::atomic<uint64_t> &counter){
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64_t> _recv;
+        std::atomic<uint64_t> _poll;
+        char _padding[64];
+        std::atomic<uint64_t> _send;
+    };
+
     /*!
      * Wait for the socket to become ready for a receive operation.
      * \param sock_fd the open socket file descriptor
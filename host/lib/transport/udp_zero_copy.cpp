@@ -12,6 +12,7 @@
 
 #include <uhd/utils/log.hpp>
 #include <uhdlib/utils/atomic.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <vector>
@@ -57,17 +58,22 @@ static void check_registry_for_fast_send_threshold(const size_t mtu){
  **********************************************************************/
 class udp_zero_copy_asio_mrb : public managed_recv_buffer{
 public:
-    udp_zero_copy_asio_mrb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _len(0) { /*NOP*/ }
+    udp_zero_copy_asio_mrb(
+        void *mem, int sock_fd, const size_t frame_size, socket_syscall_counters &counters
+    ):
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size), _len(0),
+        _counters(counters) { /*NOP*/ }
 
     void release(void){
         _claimer.release();
     }
 
     UHD_INLINE sptr get_new(const double timeout, size_t &index){
+        UHD_TRACE_SCOPE("transport", "udp_recv");
         if (not _claimer.claim_with_wait(timeout)) return sptr();
 
         #ifdef MSG_DONTWAIT //try a non-blocking recv() if supported
+        _counters.count_recv();
         _len = ::recv(_sock_fd, (char *)_mem, _frame_size, MSG_DONTWAIT);
         if (_len > 0){
             index++; //advances the caller's buffer
@@ -75,7 +81,9 @@ public:
         }
         #endif
 
+        _counters.count_poll();
         if (wait_for_recv_ready(_sock_fd, timeout)){
+            _counters.count_recv();
             _len = ::recv(_sock_fd, (char *)_mem, _frame_size, 0);
             if (_len == 0)
                 throw uhd::io_error("socket closed");
@@ -94,6 +102,7 @@ private:
     int _sock_fd;
     size_t _frame_size;
     ssize_t _len;
+    socket_syscall_counters &_counters;
     simple_claimer _claimer;
 };
 
@@ -103,15 +112,20 @@ private:
  **********************************************************************/
 class udp_zero_copy_asio_msb : public managed_send_buffer{
 public:
-    udp_zero_copy_asio_msb(void *mem, int sock_fd, const size_t frame_size):
-        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size) { /*NOP*/ }
+    udp_zero_copy_asio_msb(
+        void *mem, int sock_fd, const size_t frame_size, socket_syscall_counters &counters
+    ):
+        _mem(mem), _sock_fd(sock_fd), _frame_size(frame_size),
+        _counters(counters) { /*NOP*/ }
 
     void release(void){
+        UHD_TRACE_SCOPE("transport", "udp_send");
         //Retry logic because send may fail with ENOBUFS.
         //This is known to occur at least on some OSX systems.
         //But it should be safe to always check for the error.
         while (true)
         {
+            _counters.count_send();
             const ssize_t ret = ::send(_sock_fd, (const char *)_mem, size(), 0);
             if (ret == ssize_t(size())) break;
             if (ret == -1 and errno == ENOBUFS)
@@ -138,6 +152,7 @@ private:
     void *_mem;
     int _sock_fd;
     size_t _frame_size;
+    socket_syscall_counters &_counters;
     simple_claimer _claimer;
 };
 
@@ -190,14 +205,14 @@ public:
         //allocate re-usable managed receive buffers
         for (size_t i = 0; i < get_num_recv_frames(); i++){
             _mrb_pool.push_back(boost::make_shared<udp_zero_copy_asio_mrb>(
-                _recv_buffer_pool->at(i), _sock_fd, get_recv_frame_size()
+                _recv_buffer_pool->at(i), _sock_fd, get_recv_frame_size(), _counters
             ));
         }
 
         //allocate re-usable managed send buffers
         for (size_t i = 0; i < get_num_send_frames(); i++){
             _msb_pool.push_back(boost::make_shared<udp_zero_copy_asio_msb>(
-                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size()
+                _send_buffer_pool->at(i), _sock_fd, get_send_frame_size(), _counters
             ));
         }
     }
@@ -255,6 +270,11 @@ public:
         return _socket->local_endpoint().address().to_string();
     }
 
+    syscall_counters_t get_syscall_counters(void) const
+    {
+        return _counters.get();
+    }
+
 private:
     //memory management -> buffers and fifos
     const size_t _recv_frame_size, _num_recv_frames;
@@ -263,6 +283,7 @@ private:
     std::vector<boost::shared_ptr<udp_zero_copy_asio_msb> > _msb_pool;
     std::vector<boost::shared_ptr<udp_zero_copy_asio_mrb> > _mrb_pool;
     size_t _next_recv_buff_index, _next_send_buff_index;
+    socket_syscall_counters _counters;
 
     //asio guts -> socket and service
     asio::io_service        _io_service;
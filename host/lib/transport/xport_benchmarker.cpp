@@ -6,56 +6,140 @@
 //
 
 #include "xport_benchmarker.hpp"
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
 #include <chrono>
-#include <thread>
+#include <cstring>
 
 namespace uhd { namespace transport {
 
-const device_addr_t& xport_benchmarker::benchmark_throughput_chdr
+namespace {
+    //! CHDR header and SID, the timestamp follows them
+    const size_t TIMESTAMP_OFFSET = 2*sizeof(uint32_t);
+
+    //! Smallest packet: header, SID and the timestamp
+    const size_t MIN_PACKET_SIZE = TIMESTAMP_OFFSET + sizeof(uint64_t);
+
+    uint64_t get_now_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    zero_copy_if::syscall_counters_t get_counters(
+        zero_copy_if::sptr tx_transport,
+        zero_copy_if::sptr rx_transport
+    ){
+        zero_copy_if::syscall_counters_t counters = tx_transport->get_syscall_counters();
+        if (rx_transport != tx_transport) {
+            const zero_copy_if::syscall_counters_t rx = rx_transport->get_syscall_counters();
+            counters.recv += rx.recv;
+            counters.send += rx.send;
+            counters.poll += rx.poll;
+        }
+        return counters;
+    }
+}
+
+const xport_benchmarker::results_t& xport_benchmarker::benchmark_chdr
 (
     zero_copy_if::sptr tx_transport,
     zero_copy_if::sptr rx_transport,
     uint32_t sid,
     bool big_endian,
-    uint32_t duration_ms)
+    uint32_t duration_ms,
+    size_t packet_size,
+    size_t max_in_flight)
 {
     vrt::if_packet_info_t pkt_info;
-    _initialize_chdr(tx_transport, rx_transport, sid, pkt_info);
+    _initialize_chdr(tx_transport, rx_transport, sid, packet_size, pkt_info);
+    _max_in_flight = max_in_flight;
     _reset_counters();
-    boost::posix_time::ptime start_time(boost::posix_time::microsec_clock::local_time());
+    const zero_copy_if::syscall_counters_t start_counters =
+        get_counters(tx_transport, rx_transport);
+    const auto start_time = std::chrono::steady_clock::now();
 
-    _tx_thread.reset(new boost::thread(boost::bind(&xport_benchmarker::_stream_tx, this, tx_transport.get(), &pkt_info, big_endian)));
-    _rx_thread.reset(new boost::thread(boost::bind(&xport_benchmarker::_stream_rx, this, rx_transport.get(), &pkt_info, big_endian)));
+    _stop = false;
+    //Packing writes to the packet info, so each thread gets its own copy
+    _rx_thread = std::thread([this, rx_transport, pkt_info, big_endian](){
+        this->_stream_rx(rx_transport.get(), &pkt_info, big_endian);
+    });
+    _tx_thread = std::thread([this, tx_transport, pkt_info, big_endian]() mutable {
+        this->_stream_tx(tx_transport.get(), &pkt_info, big_endian);
+    });
 
     std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
 
-    _tx_thread->interrupt();
-    _rx_thread->interrupt();
-    _tx_thread->join();
-    _rx_thread->join();
+    //The threads may still wait for a buffer, that time does not count
+    const auto stop_time = std::chrono::steady_clock::now();
+    _stop = true;
+    _tx_thread.join();
+    _rx_thread.join();
 
-    boost::posix_time::ptime stop_time(boost::posix_time::microsec_clock::local_time());
-    double duration_s = ((double)(stop_time-start_time).total_microseconds())/1e6;
+    const zero_copy_if::syscall_counters_t stop_counters =
+        get_counters(tx_transport, rx_transport);
 
-    uint64_t tx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_tx_packets;
-    uint64_t rx_bytes = pkt_info.num_payload_words32*sizeof(uint32_t)*_num_rx_packets;
-    double tx_rate = (((double)tx_bytes)/duration_s);
-    double rx_rate = (((double)rx_bytes)/duration_s);
+    const size_t packet_bytes = pkt_info.num_packet_words32*sizeof(uint32_t);
+    _results.duration_s = std::chrono::duration<double>(stop_time - start_time).count();
+    _results.tx_packets = _num_tx_packets;
+    _results.rx_packets = _num_rx_packets;
+    _results.tx_bytes = _results.tx_packets*packet_bytes;
+    _results.rx_bytes = _num_rx_bytes;
+    _results.tx_timeouts = _num_tx_timeouts;
+    _results.rx_timeouts = _num_rx_timeouts;
+    _results.data_errors = _num_data_errors;
+    _results.latency = _latency;
+    _results.syscalls.recv = stop_counters.recv - start_counters.recv;
+    _results.syscalls.send = stop_counters.send - start_counters.send;
+    _results.syscalls.poll = stop_counters.poll - start_counters.poll;
+    return _results;
+}
 
-    _results["TX-Bytes"] = (boost::format("%.2fMB") % (tx_bytes/(1024*1024))).str();
-    _results["RX-Bytes"] = (boost::format("%.2fMB") % (rx_bytes/(1024*1024))).str();
-    _results["TX-Throughput"] = (boost::format("%.2fMB/s") % (tx_rate/(1024*1024))).str();
-    _results["RX-Throughput"] = (boost::format("%.2fMB/s") % (rx_rate/(1024*1024))).str();
-    _results["TX-Timeouts"] = std::to_string(_num_tx_timeouts);
-    _results["RX-Timeouts"] = std::to_string(_num_rx_timeouts);
-    _results["Data-Errors"] = std::to_string(_num_data_errors);
+const device_addr_t& xport_benchmarker::benchmark_throughput_chdr
+(
+    zero_copy_if::sptr tx_transport,
+    zero_copy_if::sptr rx_transport,
+    uint32_t sid,
+    bool big_endian,
+    uint32_t duration_ms)
+{
+    const results_t &results = benchmark_chdr(
+        tx_transport, rx_transport, sid, big_endian, duration_ms);
 
-    return _results;
+    double tx_rate = (((double)results.tx_bytes)/results.duration_s);
+    double rx_rate = (((double)results.rx_bytes)/results.duration_s);
+
+    _results_strs["TX-Bytes"] = (boost::format("%.2fMB") % (results.tx_bytes/(1024.0*1024))).str();
+    _results_strs["RX-Bytes"] = (boost::format("%.2fMB") % (results.rx_bytes/(1024.0*1024))).str();
+    _results_strs["TX-Throughput"] = (boost::format("%.2fMB/s") % (tx_rate/(1024*1024))).str();
+    _results_strs["RX-Throughput"] = (boost::format("%.2fMB/s") % (rx_rate/(1024*1024))).str();
+    _results_strs["TX-Timeouts"] = std::to_string(results.tx_timeouts);
+    _results_strs["RX-Timeouts"] = std::to_string(results.rx_timeouts);
+    _results_strs["Data-Errors"] = std::to_string(results.data_errors);
+    _results_strs["Latency"] = results.latency.to_pp_string();
+    _results_strs["TX-Syscalls"] = std::to_string(results.syscalls.send);
+    _results_strs["RX-Syscalls"] = std::to_string(results.syscalls.recv + results.syscalls.poll);
+
+    return _results_strs;
 }
 
 void xport_benchmarker::_stream_tx(zero_copy_if* transport, vrt::if_packet_info_t* pkt_info, bool big_endian)
 {
-    while (not boost::this_thread::interruption_requested()) {
+    while (not _stop) {
+        //Hold back while the window is full, but not forever: packets may get lost
+        if (_max_in_flight != 0) {
+            const auto deadline = std::chrono::steady_clock::now()
+                + std::chrono::duration<double>(_tx_timeout);
+            while (not _stop and _num_tx_packets - _num_rx_packets >= _max_in_flight) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    _num_tx_timeouts++;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+
         managed_send_buffer::sptr buff = transport->get_send_buff(_tx_timeout);
         if (buff) {
             uint32_t *packet_buff = buff->cast<uint32_t *>();
@@ -65,6 +149,9 @@ void xport_benchmarker::_stream_tx(zero_copy_if* transport, vrt::if_packet_info_
             } else {
                 vrt::if_hdr_pack_le(packet_buff, *pkt_info);
             }
+            //Stamp the payload so the receiver can measure the latency
+            const uint64_t now_ns = get_now_ns();
+            std::memcpy(buff->cast<uint8_t *>() + TIMESTAMP_OFFSET, &now_ns, sizeof(now_ns));
             //send the buffer over the interface
             buff->commit(sizeof(uint32_t)*(pkt_info->num_packet_words32));
             _num_tx_packets++;
@@ -76,16 +163,27 @@ void xport_benchmarker::_stream_tx(zero_copy_if* transport, vrt::if_packet_info_
 
 void xport_benchmarker::_stream_rx(zero_copy_if* transport, const vrt::if_packet_info_t* exp_pkt_info, bool big_endian)
 {
-    while (not boost::this_thread::interruption_requested()) {
+    //Stream transports may return parts of packets, or several at once.
+    //Track where the buffer starts in the stream to find the packets.
+    const size_t packet_bytes = exp_pkt_info->num_packet_words32*sizeof(uint32_t);
+    uint64_t stream_offset = 0;
+
+    while (not _stop) {
         managed_recv_buffer::sptr buff = transport->get_recv_buff(_rx_timeout);
-        if (buff) {
-            //Extract packet info
+        if (not buff) {
+            _num_rx_timeouts++;
+            continue;
+        }
+        const uint8_t *bytes = buff->cast<const uint8_t *>();
+        const size_t num_bytes = buff->size();
+
+        //Check the packets which are whole in this buffer
+        size_t offset = size_t((packet_bytes - stream_offset % packet_bytes) % packet_bytes);
+        for (; offset + packet_bytes <= num_bytes; offset += packet_bytes) {
             vrt::if_packet_info_t pkt_info;
             pkt_info.link_type = exp_pkt_info->link_type;
-            pkt_info.num_packet_words32 = buff->size()/sizeof(uint32_t);
-            const uint32_t *packet_buff = buff->cast<const uint32_t *>();
-
-            _num_rx_packets++;
+            pkt_info.num_packet_words32 = exp_pkt_info->num_packet_words32;
+            const uint32_t *packet_buff = reinterpret_cast<const uint32_t *>(bytes + offset);
 
             //unpacking can fail
             try {
@@ -98,13 +196,26 @@ void xport_benchmarker::_stream_rx(zero_copy_if* transport, const vrt::if_packet
                 if (exp_pkt_info->packet_type != pkt_info.packet_type ||
                     exp_pkt_info->num_payload_bytes != pkt_info.num_payload_bytes) {
                     _num_data_errors++;
+                    continue;
                 }
             } catch(const std::exception &ex) {
                 _num_data_errors++;
+                continue;
             }
-        } else {
-            _num_rx_timeouts++;
+
+            uint64_t sent_ns = 0;
+            std::memcpy(&sent_ns, bytes + offset + TIMESTAMP_OFFSET, sizeof(sent_ns));
+            const uint64_t now_ns = get_now_ns();
+            const uint64_t ns = (now_ns > sent_ns) ? now_ns - sent_ns : 0;
+            _latency.buckets[duration_histogram_t::get_bucket(ns)]++;
+            _latency.count++;
+            _latency.total_ns += ns;
+            _latency.max_ns = std::max(_latency.max_ns, ns);
         }
+
+        stream_offset += num_bytes;
+        _num_rx_bytes = stream_offset;
+        _num_rx_packets = stream_offset/packet_bytes;
     }
 }
 
@@ -112,25 +223,36 @@ void xport_benchmarker::_reset_counters(void)
 {
     _num_tx_packets = 0;
     _num_rx_packets = 0;
+    _num_rx_bytes = 0;
     _num_tx_timeouts = 0;
     _num_rx_timeouts = 0;
     _num_data_errors = 0;
+    _latency = duration_histogram_t();
 }
 
 void xport_benchmarker::_initialize_chdr(
     zero_copy_if::sptr tx_transport,
     zero_copy_if::sptr rx_transport,
     uint32_t sid,
+    size_t packet_size,
     vrt::if_packet_info_t& pkt_info)
 {
     _tx_timeout = 0.5;
     _rx_timeout = 0.5;
 
     size_t frame_size = std::min(tx_transport->get_send_frame_size(), rx_transport->get_recv_frame_size());
+    if (packet_size == 0) {
+        packet_size = frame_size;
+    }
+    if (packet_size < MIN_PACKET_SIZE or packet_size > frame_size) {
+        throw uhd::value_error(str(boost::format(
+            "xport_benchmarker: packet size %u is not between %u and the frame size %u")
+            % packet_size % MIN_PACKET_SIZE % frame_size));
+    }
 
     pkt_info.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
     pkt_info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
-    pkt_info.num_packet_words32 = (frame_size/sizeof(uint32_t));
+    pkt_info.num_packet_words32 = (packet_size/sizeof(uint32_t));
     pkt_info.num_payload_words32 = pkt_info.num_packet_words32 - 2;
     pkt_info.num_payload_bytes = pkt_info.num_payload_words32*sizeof(uint32_t);
     pkt_info.packet_count = 0;
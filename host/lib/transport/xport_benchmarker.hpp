@@ -10,16 +10,57 @@
 
 #include <uhd/transport/zero_copy.hpp>
 #include <uhd/types/device_addr.hpp>
+#include <uhd/types/stream_stats.hpp>
 #include <uhd/utils/log.hpp>
-#include <boost/shared_ptr.hpp>
-#include <boost/thread/thread.hpp>
+#include <boost/noncopyable.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
+#include <atomic>
+#include <thread>
 
 namespace uhd { namespace transport {
 
 //Test class to benchmark a low-level transport object with a VITA/C-VITA data stream
 class xport_benchmarker : boost::noncopyable {
 public:
+    //! Results of one benchmark run
+    struct results_t {
+        double duration_s;
+        uint64_t tx_packets;
+        uint64_t rx_packets;
+        uint64_t tx_bytes;
+        uint64_t rx_bytes;
+        uint64_t tx_timeouts;
+        uint64_t rx_timeouts;
+        uint64_t data_errors;
+        //! Time from sending a packet to receiving it
+        uhd::duration_histogram_t latency;
+        //! System calls the transports made during the run
+        zero_copy_if::syscall_counters_t syscalls;
+    };
+
+    /*!
+     * Push CHDR packets from one transport to another for a while.
+     * The two can be the same transport, when the far end echoes packets.
+     * \param tx_transport the transport to send on
+     * \param rx_transport the transport to receive on
+     * \param sid the stream ID of the packets
+     * \param big_endian true for big endian packet headers
+     * \param duration_ms the duration of the run
+     * \param packet_size bytes per packet, 0 for the largest frame
+     * \param max_in_flight the number of packets sent but not yet received
+     *        at which sending pauses, 0 for no limit
+     * \return the results of the run
+     */
+    const results_t& benchmark_chdr(
+        zero_copy_if::sptr tx_transport,
+        zero_copy_if::sptr rx_transport,
+        uint32_t sid,
+        bool big_endian,
+        uint32_t duration_ms,
+        size_t packet_size = 0,
+        size_t max_in_flight = 0);
+
+    //! Run benchmark_chdr() and return its results as strings
     const device_addr_t& benchmark_throughput_chdr(
         zero_copy_if::sptr tx_transport,
         zero_copy_if::sptr rx_transport,
@@ -42,23 +83,29 @@ private:
         zero_copy_if::sptr tx_transport,
         zero_copy_if::sptr rx_transport,
         uint32_t sid,
+        size_t packet_size,
         vrt::if_packet_info_t& pkt_info);
 
     void _reset_counters(void);
 
-    boost::shared_ptr<boost::thread>    _tx_thread;
-    boost::shared_ptr<boost::thread>    _rx_thread;
+    std::thread         _tx_thread;
+    std::thread         _rx_thread;
+    std::atomic<bool>   _stop;
 
-    uint64_t     _num_tx_packets;
-    uint64_t     _num_rx_packets;
+    std::atomic<uint64_t>   _num_tx_packets;
+    std::atomic<uint64_t>   _num_rx_packets;
+    uint64_t     _num_rx_bytes;
     uint64_t     _num_tx_timeouts;
     uint64_t     _num_rx_timeouts;
     uint64_t     _num_data_errors;
+    uhd::duration_histogram_t _latency;
 
     double              _tx_timeout;
     double              _rx_timeout;
+    size_t              _max_in_flight;
 
-    device_addr_t       _results;
+    results_t           _results;
+    device_addr_t       _results_strs;
 };
 
 
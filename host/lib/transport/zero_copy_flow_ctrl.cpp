@@ -186,6 +186,11 @@ public:
         return _transport->get_send_frame_size();
     }
 
+    syscall_counters_t get_syscall_counters() const
+    {
+        return _transport->get_syscall_counters();
+    }
+
 private:
     // The underlying transport
     zero_copy_if::sptr _transport;
@@ -12,6 +12,7 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/safe_call.hpp>
 #include <uhd/utils/thread.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/thread/mutex.hpp>
@@ -76,6 +77,7 @@ public:
     // pulling pointers to managed receiver buffers quickly
     void enqueue_recv()
     {
+        const thread_policy::scope policy_scope("recv_offload");
         while (not is_recv_done()) {
             managed_recv_buffer::sptr buff = _transport->get_recv_buff(_timeout);
             if (not buff) continue;
@@ -123,6 +125,11 @@ public:
         return _transport->get_send_frame_size();
     }
 
+    syscall_counters_t get_syscall_counters() const
+    {
+        return _transport->get_syscall_counters();
+    }
+
 private:
     // The linked transport
     zero_copy_if::sptr _transport;
@@ -18,8 +18,15 @@ using namespace uhd;
 static const char* arg_delim = ",";
 static const char* pair_delim = "=";
 
+static const char* whitespace = " \t\n\v\f\r";
+
 static std::string trim(const std::string &in){
-    return boost::algorithm::trim_copy(in);
+    //same as boost::algorithm::trim_copy() in the classic locale, but
+    //without a locale lookup for every character
+    const size_t first = in.find_first_not_of(whitespace);
+    if (first == std::string::npos) return std::string();
+    const size_t last = in.find_last_not_of(whitespace);
+    return in.substr(first, last - first + 1);
 }
 
 #define tokenizer(inp, sep) \
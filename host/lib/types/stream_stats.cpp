@@ -0,0 +1,109 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/types/stream_stats.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+using namespace uhd;
+
+/***********************************************************************
+ * duration histogram
+ **********************************************************************/
+duration_histogram_t::duration_histogram_t(void):
+    count(0),
+    total_ns(0),
+    max_ns(0)
+{
+    std::memset(buckets, 0, sizeof(buckets));
+}
+
+size_t duration_histogram_t::get_bucket(const uint64_t ns)
+{
+#if defined(__GNUC__)
+    const size_t bucket = (ns < 2) ? 0 : size_t(63 - __builtin_clzll(ns));
+#else
+    size_t bucket = 0;
+    for (uint64_t n = ns >> 1; n != 0; n >>= 1) {
+        bucket++;
+    }
+#endif
+    return std::min(bucket, NUM_BUCKETS - 1);
+}
+
+double duration_histogram_t::get_mean_ns(void) const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    return double(total_ns) / count;
+}
+
+uint64_t duration_histogram_t::get_percentile_ns(const double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    const double p = std::max(0.0, std::min(percentile, 100.0));
+    const uint64_t rank = std::max<uint64_t>(1,
+        uint64_t(std::ceil(p / 100.0 * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(uint64_t(2) << i, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+std::string duration_histogram_t::to_pp_string(void) const
+{
+    if (count == 0) {
+        return "n=0";
+    }
+    return str(boost::format("n=%u mean=%.3fus p50<%.3fus p99<%.3fus max=%.3fus")
+        % count
+        % (get_mean_ns() / 1e3)
+        % (get_percentile_ns(50) / 1e3)
+        % (get_percentile_ns(99) / 1e3)
+        % (max_ns / 1e3)
+    );
+}
+
+/***********************************************************************
+ * stream stats
+ **********************************************************************/
+stream_stats_t::stream_stats_t(void):
+    packets(0),
+    bytes(0),
+    samples(0),
+    timeouts(0),
+    overflows(0),
+    underflows(0),
+    sequence_errors(0),
+    late(0)
+{
+    /* NOP */
+}
+
+std::string stream_stats_t::to_pp_string(void) const
+{
+    std::ostringstream ss;
+    ss << boost::format("Packets: %u  Bytes: %u  Samples: %u\n")
+        % packets % bytes % samples;
+    ss << boost::format("Timeouts: %u  Overflows: %u  Underflows: %u  Sequence errors: %u  Late: %u\n")
+        % timeouts % overflows % underflows % sequence_errors % late;
+    ss << "Call time:     " << call_time.to_pp_string() << "\n";
+    ss << "Convert time:  " << convert_time.to_pp_string() << "\n";
+    ss << "FC wait time:  " << fc_wait_time.to_pp_string() << "\n";
+    ss << "Xport time:    " << xport_time.to_pp_string() << "\n";
+    ss << "Deadline time: " << deadline_time.to_pp_string() << "\n";
+    return ss.str();
+}
@@ -112,6 +112,46 @@ std::string crimson_tng_iface::peek_str() {
 	return peek_str( 6.250 );
 }
 
+// Never call this function by itself, always call through crimson_tng_impl::set_strings(),
+// else it will mess up the protocol with the sequencing and will contian no error checks.
+std::vector<std::string> crimson_tng_iface::poke_peek_strs( const std::vector<std::string> &data, float timeout_s ) {
+    // all requests go out at once, so there is only one round trip to wait for
+    const uint32_t first_seq = seq;
+    for (const std::string &d : data) {
+        poke_str(d);
+    }
+
+    // replies are matched to their requests by sequence number
+    std::vector<std::string> replies(data.size());
+    size_t num_replies = 0;
+    std::vector<std::string> tokens;
+    while (num_replies < data.size()) {
+        memset( _buff, 0, sizeof( _buff ) );
+        const size_t nbytes = _ctrl_transport -> recv(boost::asio::buffer(_buff), timeout_s );
+        if (nbytes == 0) break;
+
+        // parses it through tokens: seq, status, [data]
+        tokens.clear();
+        this -> parse(tokens, _buff, ',');
+        if (tokens.empty() or tokens[0] == "flow") continue;
+
+        uint32_t iseq;
+        if (sscanf(tokens[0].c_str(), "%" SCNd32, &iseq) != 1) continue;
+        const size_t i = iseq - first_seq;
+        if (iseq < first_seq or i >= data.size() or not replies[i].empty()) continue;
+
+        if (tokens.size() >= 2 and tokens[1].c_str()[0] == CMD_ERROR) replies[i] = "ERROR";
+        else if (tokens.size() < 3) replies[i] = "0";
+        else replies[i] = tokens[2];
+        num_replies++;
+    }
+
+    for (std::string &reply : replies) {
+        if (reply.empty()) reply = "TIMEOUT";
+    }
+    return replies;
+}
+
 /***********************************************************************
  * Public make function for crimson_tng interface
  **********************************************************************/
@@ -25,6 +25,7 @@
 #include <boost/function.hpp>
 #include <uhd/types/wb_iface.hpp>
 #include <string>
+#include <vector>
 #include "crimson_tng_fw_common.h"
 
 namespace uhd {
@@ -55,6 +56,10 @@ public:
     // Recieve/read a data packet (string), null terminated
     virtual std::string peek_str( float timeout_s );
 
+    // Send several data packets (strings) back-to-back, then receive all of
+    // their replies, which are returned in the same order
+    virtual std::vector<std::string> poke_peek_strs( const std::vector<std::string> &data, float timeout_s );
+
 private:
     //this lovely lady makes it all possible
     uhd::transport::udp_simple::sptr _ctrl_transport;
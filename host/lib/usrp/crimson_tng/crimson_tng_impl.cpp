@@ -29,6 +29,7 @@
 #include "uhd/transport/udp_simple.hpp"
 #include "uhd/types/stream_cmd.hpp"
 #include "uhd/utils/static.hpp"
+#include "uhdlib/utils/thread_policy.hpp"
 
 #include "../../transport/super_recv_packet_handler.hpp"
 #include "../../transport/super_send_packet_handler.hpp"
@@ -104,6 +105,52 @@ void crimson_tng_impl::set_string(const std::string pre, std::string data) {
 		return;
 }
 
+// sets all properties at once, the replies are only waited for after all requests are sent
+void crimson_tng_impl::set_strings(const std::vector<std::pair<std::string, std::string> > &data) {
+
+	std::vector<std::string> reqs;
+	for (const std::pair<std::string, std::string> &d : data) {
+		reqs.push_back("set," + d.first + "," + d.second);
+	}
+
+	std::lock_guard<std::mutex> _lock( _iface_lock );
+
+	const std::vector<std::string> rets = _mbc[ "0" ].iface -> poke_peek_strs(reqs, 6.250);
+
+	for (size_t i = 0; i < rets.size(); i++) {
+		if (rets[i] == "TIMEOUT" || rets[i] == "ERROR")
+			throw uhd::runtime_error("crimson_tng_impl::set_strings - UDP resp. timed out: set: " + data[i].first + " = " + data[i].second);
+	}
+}
+
+void crimson_tng_impl::set_properties_batch(const std::vector<fs_path> &paths) {
+	std::vector<std::pair<std::string, std::string> > data;
+	for (const fs_path &path : paths) {
+		const batch_prop_t &batch_prop = _batch_props.at(path);
+		data.push_back(std::make_pair(batch_prop.prop, batch_prop.get_desired()));
+	}
+	set_strings(data);
+}
+
+template <typename T>
+void crimson_tng_impl::add_batch_prop_as_string(const fs_path &path, const std::string &prop) {
+	// same conversion as the set_<type>() wrappers
+	property<T> &p = _tree->access<T>(path);
+	batch_prop_t &batch_prop = _batch_props[path];
+	batch_prop.prop = prop;
+	batch_prop.get_desired = [&p]() { return boost::lexical_cast<std::string>(p.get_desired()); };
+}
+
+void crimson_tng_impl::add_batch_prop(const fs_path &path, const std::string &prop, std::string *) {
+	add_batch_prop_as_string<std::string>(path, prop);
+}
+void crimson_tng_impl::add_batch_prop(const fs_path &path, const std::string &prop, int *) {
+	add_batch_prop_as_string<int>(path, prop);
+}
+void crimson_tng_impl::add_batch_prop(const fs_path &path, const std::string &prop, double *) {
+	add_batch_prop_as_string<double>(path, prop);
+}
+
 // wrapper for type <double> through the ASCII Crimson interface
 double crimson_tng_impl::get_double(std::string req) {
 	try { return boost::lexical_cast<double>( get_string(req) );
@@ -688,6 +735,8 @@ bool crimson_tng_impl::time_diff_converged() {
 // the buffer monitor thread
 void crimson_tng_impl::bm_thread_fn( crimson_tng_impl *dev ) {
 
+	const thread_policy::scope policy_scope( "crimson_bm" );
+
 	dev->_bm_thread_running = true;
 
 	const uhd::time_spec_t T( 1.0 / (double) CRIMSON_TNG_UPDATE_PER_SEC );
@@ -777,6 +826,7 @@ UHD_STATIC_BLOCK(register_crimson_tng_device)
     		.set( get_ ## HANDLER (PROP))							\
 		.add_desired_subscriber(boost::bind(&crimson_tng_impl::set_ ## HANDLER, this, (PROP), _1))	\
 		.set_publisher(boost::bind(&crimson_tng_impl::get_ ## HANDLER, this, (PROP)    ));	\
+		add_batch_prop((PATH), (PROP), (TYPE *) NULL);						\
 	} while(0)
 
 // Macro to create the tree, all properties created with this are RO properties
@@ -1283,6 +1333,12 @@ crimson_tng_impl::crimson_tng_impl(const device_addr_t &_device_addr)
 	TREE_CREATE_RW(cm_path / "tx/gain/val", "cm/tx/gain/val", double, double);
 	TREE_CREATE_RW(cm_path / "trx/freq/val", "cm/trx/freq/val", double, double);
 	TREE_CREATE_RW(cm_path / "trx/nco_adj", "cm/trx/nco_adj", double, double);
+	// properties set in a property tree transaction are sent to Crimson together
+	std::vector<fs_path> batch_paths;
+	for (const std::pair<const std::string, batch_prop_t> &batch_prop : _batch_props) {
+		batch_paths.push_back(batch_prop.first);
+	}
+	_tree->add_batch_subscriber(batch_paths, boost::bind(&crimson_tng_impl::set_properties_batch, this, _1));
 
 	this->io_init();
 
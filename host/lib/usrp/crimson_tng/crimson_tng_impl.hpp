@@ -18,6 +18,7 @@
 #ifndef INCLUDED_CRIMSON_TNG_IMPL_HPP
 #define INCLUDED_CRIMSON_TNG_IMPL_HPP
 
+#include <map>
 #include <set>
 #include <vector>
 #include <thread>
@@ -175,6 +176,26 @@ private:
     // set arbitrary crimson properties from dev_addr_t using mappings of the form "crimson:key" => "val"
     void set_properties_from_addr();
 
+    // set several properties with a single round trip, see crimson_tng_iface::poke_peek_strs()
+    void set_strings(const std::vector<std::pair<std::string, std::string> > &data);
+
+    // batch subscriber of the property tree, sets all properties of a transaction with set_strings()
+    void set_properties_batch(const std::vector<uhd::fs_path> &paths);
+
+    // properties that can be set in a batch: the Crimson property, and the desired value as a string
+    struct batch_prop_t {
+        std::string prop;
+        boost::function<std::string(void)> get_desired;
+    };
+    std::map<std::string, batch_prop_t> _batch_props;
+
+    // only properties with the basic string/int/double handlers can be set in a batch
+    template <typename T> void add_batch_prop(const uhd::fs_path &, const std::string &, T *) {}
+    void add_batch_prop(const uhd::fs_path &path, const std::string &prop, std::string *);
+    void add_batch_prop(const uhd::fs_path &path, const std::string &prop, int *);
+    void add_batch_prop(const uhd::fs_path &path, const std::string &prop, double *);
+    template <typename T> void add_batch_prop_as_string(const uhd::fs_path &path, const std::string &prop);
+
     // private pointer to the UDP interface, this is the path to send commands to Crimson
     //uhd::crimson_tng_iface::sptr _iface;
     std::mutex _iface_lock;
@@ -7,6 +7,7 @@
 #include <boost/core/ignore_unused.hpp>
 
 #include <uhd/types/time_spec.hpp>
+#include <uhdlib/utils/tick_time.hpp>
 
 namespace uhd {
 
@@ -56,8 +57,12 @@ public:
 	virtual uhd::time_spec_t get_start_of_burst_time() = 0;
 
 	/**
-	 * Using linear interpolation, compute the number of samples transmitted
-	 * from time a to time b at a given sample rate.
+	 * Compute the number of samples transmitted from time a to time b at a
+	 * given sample rate.
+	 *
+	 * Both times are quantized to sample ticks before taking the difference,
+	 * so counts over consecutive intervals add up exactly and do not drift
+	 * from rounding, no matter how large the absolute times are.
 	 *
 	 * @param a            start time
 	 * @param b            stop time
@@ -67,20 +72,11 @@ public:
 	 */
 	static inline size_t interp( const uhd::time_spec_t & a, const uhd::time_spec_t & b, const double sample_rate ) {
 
-		size_t r;
-
-		double ta = a.get_real_secs();
-		double tb = b.get_real_secs();
-
-		if ( tb > ta ) {
-			double dt = tb - ta;
-			double nsamps = sample_rate * dt;
-			r = floor( nsamps );
-		} else {
-			r = 0;
-		}
+		const int64_t nsamps =
+			uhd::tick_time_t::from_time_spec( b, sample_rate )
+			- uhd::tick_time_t::from_time_spec( a, sample_rate );
 
-		return r;
+		return nsamps > 0 ? nsamps : 0;
 	}
 
 	/**
@@ -26,6 +26,10 @@
 #include "crimson_tng_impl.hpp"
 #include "crimson_tng_fw_common.h"
 #include <uhd/utils/log.hpp>
+#include <uhdlib/utils/binary_log.hpp>
+#include <uhdlib/utils/no_alloc.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/trace.hpp>
 #include <uhd/utils/tasks.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/utils/byteswap.hpp>
@@ -186,7 +190,9 @@ public:
 		_max_num_samps( max_num_samps ),
 		_actual_num_samps( max_num_samps ),
 		_samp_rate( 1.0 ),
+		_no_alloc( false ),
 		_pillaging( false ),
+		_burst_done( false ),
 		_blessbless( false ) // icelandic (viking) for bye
 
 	{
@@ -222,6 +228,8 @@ public:
     ){
         static const double default_sob = 1.0;
 
+        const no_alloc::scope no_alloc_scope( _no_alloc and not _first_call_to_send );
+
         size_t r = 0;
 
         uhd::tx_metadata_t metadata = metadata_;
@@ -236,9 +244,7 @@ public:
         }
         if ( _first_call_to_send ) {
             if ( ! metadata.start_of_burst ) {
-                #ifdef UHD_TXRX_DEBUG_PRINTS
-                std::cout << "Warning: first call to send but no start of burst!" << std::endl;
-                #endif
+                UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "first call to send but no start of burst");
                 metadata.start_of_burst = true;
 
 				//for( auto & ep: _eprops ) {
@@ -248,9 +254,7 @@ public:
         }
         if ( _first_call_to_send ) {
             if ( ! metadata.has_time_spec ) {
-                #ifdef UHD_TXRX_DEBUG_PRINTS
-                std::cout << "Warning: first call to send but no time spec supplied" << std::endl;
-                #endif
+                UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "first call to send but no time spec supplied");
                 metadata.has_time_spec = true;
                 metadata.time_spec = now + default_sob;
             }
@@ -258,13 +262,11 @@ public:
         if ( metadata.start_of_burst ) {
             if ( metadata.time_spec < now + default_sob ) {
                 metadata.time_spec = now + default_sob;
-                #ifdef UHD_TXRX_DEBUG_PRINTS
-                std::cout << "UHD::CRIMSON_TNG::Warning: time_spec was too soon for start of burst and has been adjusted!" << std::endl;
-                #endif
+                UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "time_spec was too soon for start of burst and has been adjusted to %f",
+                    metadata.time_spec.get_real_secs());
             }
-            #ifdef UHD_TXRX_DEBUG_PRINTS
-            std::cout << "UHD::CRIMSON_TNG::Info: " << get_time_now() << ": sob @ " << metadata.time_spec << " | " << metadata.time_spec.to_ticks( 162500000 ) << std::endl;
-            #endif
+            UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "%f: sob @ %f | %d",
+                now.get_real_secs(), metadata.time_spec.get_real_secs(), metadata.time_spec.to_ticks( 162500000 ));
 
             for( auto & ep: _eprops ) {
                 ep.flow_control->set_start_of_burst_time( metadata.time_spec );
@@ -272,9 +274,7 @@ public:
             sob_time = metadata.time_spec;
         }
         if ( _first_call_to_send ) {
-            #ifdef UHD_TXRX_DEBUG_PRINTS
-            std::cout << "first call to send: nsamps_per_buff: " << nsamps_per_buff << std::endl;
-            #endif
+            UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "first call to send: nsamps_per_buff: %u", nsamps_per_buff);
            // for( auto & ep: _eprops ) {
             //	ep._remaining_num_samps = nsamps_per_buff;
            // }
@@ -299,22 +299,29 @@ public:
         pillage();
 
         if ( 0 == nsamps_per_buff && metadata.end_of_burst ) {
-            #ifdef UHD_TXRX_DEBUG_PRINTS
-            std::cout << "UHD::CRIMSON_TNG::Info: " << now << ": " << "eob @ " << now << " | " << now.to_ticks( 162500000 ) << std::endl;
-            #endif
+            UHD_LOG_BINARY_TRACE("CRIMSON_TNG", "%f: eob @ %f | %d",
+                now.get_real_secs(), now.get_real_secs(), now.to_ticks( 162500000 ));
 
             async_metadata_t am;
             am.has_time_spec = true;
             am.time_spec = now;
             am.event_code = async_metadata_t::EVENT_CODE_BURST_ACK;
 
-            retreat();
+            // starting a viking allocates, so without allocations it stays
+            // for the next burst
+            if ( _no_alloc ) {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _burst_done = true;
+            } else {
+                retreat();
+            }
         } else   r = send_packet_handler::send(buffs, nsamps_per_buff, metadata, timeout);
 
         return r;
     }
 
     static managed_send_buffer::sptr get_send_buff( boost::weak_ptr<uhd::tx_streamer> tx_streamer, const size_t chan, double timeout ){
+        UHD_TRACE_SCOPE("crimson", "get_send_buff");
 
         boost::shared_ptr<crimson_tng_send_packet_streamer> my_streamer =
             boost::dynamic_pointer_cast<crimson_tng_send_packet_streamer>( tx_streamer.lock() );
@@ -338,6 +345,7 @@ public:
     }
     void set_time_now( timenow_type time_now ) {
         _time_now = time_now;
+        set_time_source( time_now );
     }
     uhd::time_spec_t get_time_now() {
         return _time_now ? _time_now() : get_system_time();
@@ -351,6 +359,10 @@ public:
     void set_async_pusher( async_pusher_type pusher ) {
 		async_pusher = pusher;
     }
+    void set_no_alloc( const bool enable ) {
+        sph::send_packet_streamer::set_no_alloc( enable );
+        _no_alloc = enable;
+    }
     void set_channel_name( size_t chan, std::string name ) {
         _eprops.at(chan).name = name;
     }
@@ -379,7 +391,7 @@ public:
 	void pillage() {
 		// probably should also (re)start the "bm thread", which currently just manages time diff
 		std::lock_guard<std::mutex> lck( _mutex );
-		if ( ! _pillaging ) {
+		if ( ! _pillaging || _burst_done ) {
 			_blessbless = false;
 
             // Assuming pillage is called for each send(), and thus each stacked command,
@@ -390,8 +402,11 @@ public:
             }
 
 			//spawn a new viking to raid the send hoardes
-			_pillage_thread = std::thread( crimson_tng_send_packet_streamer::send_viking_loop, this );
-			_pillaging = true;
+			if ( ! _pillaging ) {
+				_pillage_thread = std::thread( crimson_tng_send_packet_streamer::send_viking_loop, this );
+				_pillaging = true;
+			}
+			_burst_done = false;
 		}
 	}
 
@@ -412,7 +427,10 @@ private:
     size_t _max_num_samps;
     size_t _actual_num_samps;
     double _samp_rate;
+    bool _no_alloc;
     bool _pillaging;
+    //! The last burst ended, but its viking kept running (no_alloc)
+    bool _burst_done;
     bool _blessbless;
     std::thread _pillage_thread;
     async_pusher_type async_pusher;
@@ -455,6 +473,7 @@ private:
     }
 
     bool check_fc_condition( const size_t chan, const double & timeout ) {
+        UHD_TRACE_SCOPE("crimson", "check_fc_condition");
 
         #ifdef UHD_TXRX_SEND_DEBUG_PRINTS
         static uhd::time_spec_t last_print_time( 0.0 ), next_print_time( get_time_now() );
@@ -466,6 +485,8 @@ private:
         now = get_time_now();
         dt = _eprops.at( chan ).flow_control->get_time_until_next_send( _actual_num_samps, now );
         then = now + dt;
+        UHD_TRACE_COUNTER("crimson", "time_until_next_send_ns", chan,
+            dt.get_real_secs() * 1e9, now.get_real_secs());
 
         if (( dt > timeout ) and (!_eprops.at( chan ).flow_control->start_of_burst_pending( now ))) {
             return false;
@@ -489,7 +510,10 @@ private:
 		// Otherwise, delay.
 		req.tv_sec = (time_t) dt.get_full_secs();
 		req.tv_nsec = dt.get_frac_secs()*1e9;
-		nanosleep( &req, &rem );
+		{
+			UHD_TRACE_SCOPE("crimson", "fc_sleep", now.get_real_secs());
+			nanosleep( &req, &rem );
+		}
 
 		return true;
     }
@@ -506,19 +530,20 @@ private:
 
 		// std::cout << __func__ << "(): beginning viking loop for tx streamer @ " << (void *) self << std::endl;
 
+		const thread_policy::scope policy_scope( "crimson_fc" );
+
 		for( ; ! self->_blessbless; ) {
 
 			const auto t0 = std::chrono::high_resolution_clock::now();
 
 			for( size_t i = 0; i < self->_eprops.size(); i++ ) {
+				UHD_TRACE_SCOPE("crimson", "viking_update_chan");
 
 				eprops_type & ep = self->_eprops[ i ];
 
-				xport_chan_fifo_lvl_type get_fifo_level;
-				uhd::flow_control::sptr fc;
-
-				get_fifo_level = ep.xport_chan_fifo_lvl;
-				fc = ep.flow_control;
+				// references, copying the function would allocate on every update
+				const xport_chan_fifo_lvl_type & get_fifo_level = ep.xport_chan_fifo_lvl;
+				const uhd::flow_control::sptr & fc = ep.flow_control;
 
 				if ( !( get_fifo_level && fc.get() ) ) {
 					continue;
@@ -533,6 +558,7 @@ private:
 				size_t max_level = fc->get_buffer_size();
 
 				try {
+					UHD_TRACE_SCOPE("crimson", "get_fifo_level");
 					get_fifo_level( level_pcnt, uflow, oflow, then );
 				} catch( ... ) {
 
@@ -551,8 +577,11 @@ private:
 				size_t level = level_pcnt * max_level;
 
 				if ( ! fc->start_of_burst_pending( then ) ) {
-					level -= ( now - then ).get_real_secs() / self->_samp_rate;
+					// samples drained from the buffer since the level was sampled
+					const size_t drained = uhd::flow_control::interp( then, now, self->_samp_rate );
+					level = level > drained ? level - drained : 0;
 					fc->set_buffer_level( level, now );
+					UHD_TRACE_COUNTER("crimson", "buffer_level", i, level, then.get_real_secs());
 #ifdef DEBUG_FC
 				    std::printf("%10lu\t", level);
 #endif
@@ -568,6 +597,10 @@ private:
 					metadata.has_time_spec = true;
 					metadata.time_spec = then;
 					metadata.event_code = uhd::async_metadata_t::EVENT_CODE_UNDERFLOW;
+					UHD_LOG_BINARY_DEBUG("CRIMSON_TNG", "tx%u: %u underflow(s) before %f",
+						i, uflow - ep.uflow, then.get_real_secs());
+					UHD_TRACE_INSTANT("crimson", "underflow", i, then.get_real_secs());
+					UHD_TRACE_TRIGGER("underflow");
 					// assumes that underflow counter is monotonically increasing
 					self->push_async_msg( metadata );
 				}
@@ -584,6 +617,9 @@ private:
 					metadata.has_time_spec = true;
 					metadata.time_spec = then;
 					metadata.event_code = uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR;
+					UHD_LOG_BINARY_DEBUG("CRIMSON_TNG", "tx%u: %u overflow(s) before %f",
+						i, oflow - ep.oflow, then.get_real_secs());
+					UHD_TRACE_INSTANT("crimson", "overflow", i, then.get_real_secs());
 					// assumes that overflow counter is monotonically increasing
 					self->push_async_msg( metadata );
 				}
@@ -811,6 +847,8 @@ rx_streamer::sptr crimson_tng_impl::get_rx_stream(const uhd::stream_args_t &args
     id.output_format = args.cpu_format;
     id.num_outputs = 1;
     my_streamer->set_converter(id);
+    my_streamer->set_batch_recv(args.args.has_key("recv_batch"));
+    my_streamer->set_no_alloc(no_alloc::is_enabled(args));
 
     if ( false ) {
     } else if ( "fc32" == args.cpu_format ) {
@@ -931,7 +969,7 @@ rx_streamer::sptr crimson_tng_impl::get_rx_stream(const uhd::stream_args_t &args
  * Transmit streamer
  **********************************************************************/
 
-static void get_fifo_lvl_udp( const size_t channel, uhd::transport::udp_simple::sptr xport, double & pcnt, uint64_t & uflow, uint64_t & oflow, uhd::time_spec_t & now ) {
+static void get_fifo_lvl_udp( const size_t channel, const uhd::transport::udp_simple::sptr & xport, double & pcnt, uint64_t & uflow, uint64_t & oflow, uhd::time_spec_t & now ) {
 
 	static constexpr double tick_period_ps = 2.0 / CRIMSON_TNG_MASTER_CLOCK_RATE;
 
@@ -1070,6 +1108,7 @@ tx_streamer::sptr crimson_tng_impl::get_tx_stream(const uhd::stream_args_t &args
     my_streamer->resize(args.channels.size());
     my_streamer->set_vrt_packer(&vrt::if_hdr_pack_be, vrt_send_header_offset_words32);
     my_streamer->set_enable_trailer( false );
+    my_streamer->set_no_alloc( no_alloc::is_enabled( args ) );
 
     my_streamer->set_time_now(boost::bind(&crimson_tng_impl::get_time_now,this));
 
@@ -10,11 +10,15 @@
 #include <uhd/rfnoc/block_ctrl_base.hpp>
 #include <uhdlib/rfnoc/graph_impl.hpp>
 #include <uhdlib/rfnoc/ctrl_iface.hpp>
+#include <uhdlib/utils/parallel.hpp>
 #include <boost/make_shared.hpp>
 #include <algorithm>
 
 using namespace uhd::usrp;
 
+//! Number of threads used to read NoC-IDs and set up block controllers
+static const size_t DEFAULT_RFNOC_INIT_THREADS = 8;
+
 device3_impl::device3_impl()
 {
     _type = uhd::device::USRP;
@@ -105,12 +109,21 @@ void device3_impl::enumerate_rfnoc_blocks(
     // 2) Destroy existing block controllers
     // TODO: Clear out all the old block control classes
     // 3) Create new block controllers
+    // Transports are allocated from device state that is shared between all
+    // blocks, so they are always made sequentially. Everything that only
+    // talks to a single block (NoC-ID readback, block controller setup) runs
+    // on up to rfnoc_init_threads threads.
+    const size_t max_threads = transport_args.cast<size_t>(
+        "rfnoc_init_threads", DEFAULT_RFNOC_INIT_THREADS);
+    std::vector<uhd::rfnoc::make_args_t> make_args(n_blocks);
+    std::vector<uint64_t> noc_ids(n_blocks);
+    std::vector<uhd::sid_t> ctrl_sids(n_blocks, base_sid);
+    // 3a) Make a transport for port number zero, because we always need that:
     for (size_t i = 0; i < n_blocks; i++) {
-        // First, make a transport for port number zero, because we always need that:
-        ctrl_sid.set_dst_xbarport(base_port + i);
-        ctrl_sid.set_dst_blockport(0);
+        ctrl_sids[i].set_dst_xbarport(base_port + i);
+        ctrl_sids[i].set_dst_blockport(0);
         both_xports_t xport = this->make_transport(
-            ctrl_sid,
+            ctrl_sids[i],
             CTRL,
             transport_args
         );
@@ -118,34 +131,45 @@ void device3_impl::enumerate_rfnoc_blocks(
             str(boost::format("Setting up NoC-Shell Control for port #0 (SID: %s)...")
                 % xport.send_sid.to_pp_string_hex())
         );
-        uhd::rfnoc::ctrl_iface::sptr ctrl = uhd::rfnoc::ctrl_iface::make(
+        make_args[i].ctrl_ifaces[0] = uhd::rfnoc::ctrl_iface::make(
             xport,
             str(boost::format("CE_%02d_Port_%02X")
                 % i
-                % ctrl_sid.get_dst_endpoint())
+                % ctrl_sids[i].get_dst_endpoint())
         );
-        uint64_t noc_id = ctrl->send_cmd_pkt(
+        make_args[i].base_address = xport.send_sid.get_dst();
+        make_args[i].device_index = device_index;
+        make_args[i].tree = subtree;
+    }
+    // 3b) Read all NoC-IDs
+    uhd::run_parallel(n_blocks, max_threads,
+        [&make_args, &noc_ids, &ctrl_sids](const size_t i){
+            noc_ids[i] = make_args[i].ctrl_ifaces[0]->send_cmd_pkt(
                 uhd::rfnoc::SR_READBACK,
                 uhd::rfnoc::SR_READBACK_REG_ID,
                 true
-        );
-        UHD_LOG_DEBUG("DEVICE3", str(
-            boost::format("Port 0x%02X: Found NoC-Block with ID %016X.")
-                % int(ctrl_sid.get_dst_endpoint())
-                % noc_id
-        ));
-        uhd::rfnoc::make_args_t make_args;
-        uhd::rfnoc::blockdef::sptr block_def = uhd::rfnoc::blockdef::make_from_noc_id(noc_id);
+            );
+            UHD_LOG_DEBUG("DEVICE3", str(
+                boost::format("Port 0x%02X: Found NoC-Block with ID %016X.")
+                    % int(ctrl_sids[i].get_dst_endpoint())
+                    % noc_ids[i]
+            ));
+        }
+    );
+    // 3c) Make transports for all other ports the blocks have
+    for (size_t i = 0; i < n_blocks; i++) {
+        uhd::rfnoc::blockdef::sptr block_def =
+            uhd::rfnoc::blockdef::make_from_noc_id(noc_ids[i]);
         if (not block_def) {
             UHD_LOG_WARNING("DEVICE3",
                 "No block definition found, using default block configuration "
-                "for block with NOC ID: " + str(boost::format("0x%08X") % noc_id)
+                "for block with NOC ID: " + str(boost::format("0x%08X") % noc_ids[i])
             );
             block_def = uhd::rfnoc::blockdef::make_from_noc_id(
                 uhd::rfnoc::DEFAULT_NOC_ID);
         }
         UHD_ASSERT_THROW(block_def);
-        make_args.ctrl_ifaces[0] = ctrl;
+        uhd::sid_t ctrl_sid = ctrl_sids[i];
         for (const size_t port_number : block_def->get_all_port_numbers()) {
             if (port_number == 0) { // We've already set this up
                 continue;
@@ -166,20 +190,19 @@ void device3_impl::enumerate_rfnoc_blocks(
                     xport1,
                     str(boost::format("CE_%02d_Port_%02d") % i % ctrl_sid.get_dst_endpoint())
             );
-            make_args.ctrl_ifaces[port_number] = ctrl1;
+            make_args[i].ctrl_ifaces[port_number] = ctrl1;
         }
         UHD_LOG_TRACE("DEVICE3",
             "All control transports successfully created for block with ID " <<
-            str(boost::format("0x%08X") % noc_id)
+            str(boost::format("0x%08X") % noc_ids[i])
         );
-
-        make_args.base_address = xport.send_sid.get_dst();
-        make_args.device_index = device_index;
-        make_args.tree = subtree;
-        {   //Critical section for block_ctrl vector access
-            boost::lock_guard<boost::mutex> lock(_block_ctrl_mutex);
-            _rfnoc_block_ctrl.push_back(uhd::rfnoc::block_ctrl_base::make(make_args, noc_id));
-        }
+    }
+    // 3d) Create the block controllers themselves
+    std::vector<uhd::rfnoc::block_ctrl_base::sptr> blocks =
+        uhd::rfnoc::block_ctrl_base::make_blocks(make_args, noc_ids, max_threads);
+    {   //Critical section for block_ctrl vector access
+        boost::lock_guard<boost::mutex> lock(_block_ctrl_mutex);
+        _rfnoc_block_ctrl.insert(_rfnoc_block_ctrl.end(), blocks.begin(), blocks.end());
     }
 }
 
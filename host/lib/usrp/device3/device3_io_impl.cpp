@@ -739,6 +739,7 @@ rx_streamer::sptr device3_impl::get_rx_stream(const stream_args_t &args_)
         id.output_format = args.cpu_format;
         id.num_outputs = 1;
         my_streamer->set_converter(id);
+        my_streamer->set_batch_recv(args.args.has_key("recv_batch"));
 
         // Give the streamer a functor to handle flow control ACK messages
         my_streamer->set_xport_handle_flowctrl_ack(
@@ -21,6 +21,7 @@
 #include <uhd/usrp/gps_ctrl.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/types/dict.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 
 #include "gpsd_iface.hpp"
 
@@ -109,6 +110,7 @@ public:
 private: // member functions
     void _thread_fcn()
     {
+        const uhd::thread_policy::scope policy_scope("gpsd");
         while (not boost::this_thread::interruption_requested()) {
             if (!gps_waiting(&_gps_data, CLICK_RATE)) {
                 if (TIMEOUT < _timeout_cnt++)
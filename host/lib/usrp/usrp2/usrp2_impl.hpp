@@ -45,6 +45,7 @@ static const size_t mimo_clock_sync_delay_cycles = 138;
 static const size_t USRP2_SRAM_BYTES = size_t(1 << 20);
 static const uint32_t USRP2_TX_ASYNC_SID = 2;
 static const uint32_t USRP2_RX_SID_BASE = 3;
+static const size_t USRP2_MAX_INIT_THREADS = 10;
 
 uhd::device_addrs_t usrp2_find(const uhd::device_addr_t &hint_);
 
@@ -108,6 +109,7 @@ private:
     void set_rx_fe_corrections(const std::string &mb, const double);
     void set_tx_fe_corrections(const std::string &mb, const double);
     bool _ignore_cal_file;
+    void setup_mb(const size_t mbi, const uhd::device_addr_t &device_args_i);
 
     //io impl methods and members
     uhd::device_addr_t device_addr;
@@ -10,6 +10,7 @@
 #include "x310_lvbitx.hpp"
 #include "x300_mb_eeprom_iface.hpp"
 #include <uhdlib/usrp/common/apply_corrections.hpp>
+#include <uhdlib/utils/parallel.hpp>
 #include <uhd/utils/static.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/paths.hpp>
@@ -403,34 +404,16 @@ x300_impl::x300_impl(const uhd::device_addr_t &dev_addr)
     const device_addrs_t device_args = separate_device_addr(dev_addr);
     _mb.resize(device_args.size());
 
-    // Serialize the initialization process
-    if (dev_addr.has_key("serialize_init") or device_args.size() == 1) {
-        for (size_t i = 0; i < device_args.size(); i++)
-        {
-            this->setup_mb(i, device_args[i]);
-        }
-        return;
-    }
-
-
-    // Initialize groups of USRPs in parallel
-    size_t total_usrps = device_args.size();
-    size_t num_usrps   = 0;
-    while (num_usrps < total_usrps)
-    {
-        size_t init_usrps = std::min(total_usrps - num_usrps, x300::MAX_INIT_THREADS);
-        boost::thread_group setup_threads;
-        for (size_t i = 0; i < init_usrps; i++)
-        {
-            size_t index = num_usrps + i;
-            setup_threads.create_thread(
-                boost::bind(&x300_impl::setup_mb, this, index, device_args[index])
-            );
+    // Initialize the motherboards in parallel, on up to init_threads
+    // threads. serialize_init does one after another (for debugging).
+    const size_t max_threads = dev_addr.has_key("serialize_init")
+        ? 1
+        : dev_addr.cast<size_t>("init_threads", x300::MAX_INIT_THREADS);
+    uhd::run_parallel(device_args.size(), max_threads,
+        [this, &device_args](const size_t mb_i){
+            this->setup_mb(mb_i, device_args[mb_i]);
         }
-        setup_threads.join_all();
-        num_usrps += init_usrps;
-    }
-
+    );
 }
 
 void x300_impl::mboard_members_t::discover_eth(
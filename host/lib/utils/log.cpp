@@ -11,11 +11,16 @@
 #include <uhd/utils/paths.hpp>
 #include <uhd/transport/bounded_buffer.hpp>
 #include <uhd/version.hpp>
+#include <uhdlib/utils/binary_log.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <fstream>
 #include <cctype>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <memory>
 #include <thread>
@@ -175,7 +180,11 @@ public:
 #ifndef UHD_LOG_FASTPATH_DISABLE
         _fastpath_queue(10),
 #endif
-        _log_queue(10)
+        _log_queue(10),
+        _ts_ref(uhd::log::binary::get_timestamp()),
+        _steady_ref(std::chrono::steady_clock::now()),
+        _wall_ref(pt::microsec_clock::local_time()),
+        _ts_per_us(1e3)
     {
         //allow override from macro definition
 #ifdef UHD_LOG_MIN_LEVEL
@@ -212,6 +221,11 @@ public:
             std::thread([this](){this->pop_task();})
         );
 
+        // Binary log record consumer
+        _pop_binary_task = std::make_shared<std::thread>(
+            std::thread([this](){this->pop_binary_task();})
+        );
+
         // Fastpath message consumer
 #ifndef UHD_LOG_FASTPATH_DISABLE
         //allow override from environment variables
@@ -261,6 +275,8 @@ public:
         push_fastpath("");
 #endif
         _pop_task->join();
+        _pop_binary_task->join();
+        _pop_binary_task.reset();
         {
             std::lock_guard<std::mutex> l(_logmap_mutex);
             _loggers.clear();
@@ -304,6 +320,7 @@ public:
 
     void pop_task()
     {
+        const uhd::thread_policy::scope policy_scope("log");
         uhd::log::logging_info log_info;
         log_info.message = "";
 
@@ -323,6 +340,7 @@ public:
 
     void pop_fastpath_task()
     {
+        const uhd::thread_policy::scope policy_scope("log");
 #ifndef UHD_LOG_FASTPATH_DISABLE
         std::string msg;
         while (!_exit) {
@@ -339,6 +357,7 @@ public:
 
     void pop_fastpath_dummy_task()
     {
+        const uhd::thread_policy::scope policy_scope("log");
 #ifndef UHD_LOG_FASTPATH_DISABLE
         std::string msg;
         while (!_exit) {
@@ -350,6 +369,82 @@ public:
 #endif
     }
 
+    void pop_binary_task()
+    {
+        const uhd::thread_policy::scope policy_scope("log");
+        static const auto POLL_PERIOD = std::chrono::milliseconds(1);
+
+        while (!_exit) {
+            std::this_thread::sleep_for(POLL_PERIOD);
+            drain_binary();
+        }
+
+        // Exit procedure: Clear the rings
+        drain_binary();
+    }
+
+    void add_ring(std::shared_ptr<uhd::log::binary::ring_t> ring)
+    {
+        std::lock_guard<std::mutex> l(_rings_mutex);
+        _rings.push_back(ring_entry{ring, 0});
+    }
+
+    /*! Format and publish all records in the rings
+     *
+     * Records from different threads are published in timestamp order.
+     * This runs on the binary pop task, and from flush().
+     */
+    void drain_binary()
+    {
+        std::lock_guard<std::mutex> drain_lock(_drain_mutex);
+        calibrate_timestamps();
+
+        std::vector<std::pair<uhd::log::binary::record_t, boost::thread::id>> records;
+        std::vector<uhd::log::logging_info> drop_msgs;
+        {
+            std::lock_guard<std::mutex> l(_rings_mutex);
+            for (auto &entry : _rings) {
+                uhd::log::binary::record_t record;
+                while (entry.ring->pop(record)) {
+                    records.push_back(std::make_pair(record, entry.ring->thread_id));
+                }
+                const size_t dropped = entry.ring->get_dropped();
+                if (dropped != entry.dropped_reported) {
+                    auto drop_msg = uhd::log::logging_info(
+                        pt::microsec_clock::local_time(),
+                        uhd::log::warning,
+                        __FILE__,
+                        __LINE__,
+                        "LOGGING",
+                        entry.ring->thread_id
+                    );
+                    drop_msg.message = str(boost::format(
+                        "Dropped %u binary log records, the ring was full.")
+                        % (dropped - entry.dropped_reported));
+                    drop_msgs.push_back(drop_msg);
+                    entry.dropped_reported = dropped;
+                }
+            }
+            // Forget the rings of threads that are gone, once they're empty
+            _rings.erase(std::remove_if(_rings.begin(), _rings.end(),
+                [](const ring_entry &entry){
+                    return entry.ring->orphaned and entry.ring->empty();
+                }), _rings.end());
+        }
+
+        std::stable_sort(records.begin(), records.end(),
+            [](const std::pair<uhd::log::binary::record_t, boost::thread::id> &a,
+               const std::pair<uhd::log::binary::record_t, boost::thread::id> &b){
+                return a.first.timestamp < b.first.timestamp;
+            });
+        for (const auto &record : records) {
+            _handle_log_info(format_record(record.first, record.second));
+        }
+        for (const auto &drop_msg : drop_msgs) {
+            _handle_log_info(drop_msg);
+        }
+    }
+
     void add_logger(
         const std::string &key,
         uhd::log::log_fn_t logger_fn
@@ -368,6 +463,7 @@ public:
 
 private:
     std::shared_ptr<std::thread> _pop_task;
+    std::shared_ptr<std::thread> _pop_binary_task;
 #ifndef UHD_LOG_FASTPATH_DISABLE
     std::shared_ptr<std::thread> _pop_fastpath_task;
 #endif
@@ -465,6 +561,56 @@ private:
         _log_queue.push_with_timed_wait(log_msg, 0.25);
     }
 
+    //! Estimate the timestamp rate against the steady clock
+    void calibrate_timestamps()
+    {
+        const uint64_t ts = uhd::log::binary::get_timestamp();
+        const double elapsed_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - _steady_ref).count();
+        if (elapsed_us > 1000) {
+            _ts_per_us = double(ts - _ts_ref) / elapsed_us;
+        }
+    }
+
+    uhd::log::logging_info format_record(
+        const uhd::log::binary::record_t &record,
+        const boost::thread::id &thread_id
+    ) {
+        const uhd::log::binary::call_site_t &site = *record.site;
+        const double us = double(int64_t(record.timestamp - _ts_ref)) / _ts_per_us;
+        auto log_info = uhd::log::logging_info(
+            _wall_ref + pt::microseconds(int64_t(us)),
+            site.verbosity,
+            site.file,
+            site.line,
+            site.component,
+            thread_id
+        );
+
+        // A bad format string must not take down the logging thread
+        boost::format fmt;
+        fmt.exceptions(boost::io::no_error_bits);
+        fmt.parse(site.format);
+        for (size_t i = 0; i < record.num_args; i++) {
+            switch (record.types[i]) {
+            case uhd::log::binary::ARG_INT:
+                fmt % record.args[i].i;
+                break;
+            case uhd::log::binary::ARG_UINT:
+                fmt % record.args[i].u;
+                break;
+            case uhd::log::binary::ARG_DOUBLE:
+                fmt % record.args[i].d;
+                break;
+            case uhd::log::binary::ARG_STRING:
+                fmt % (record.args[i].s ? record.args[i].s : "(null)");
+                break;
+            }
+        }
+        log_info.message = fmt.str();
+        return log_info;
+    }
+
     std::mutex _logmap_mutex;
     std::atomic<bool> _exit;
     using level_logfn_pair =
@@ -474,6 +620,20 @@ private:
     uhd::transport::bounded_buffer<std::string> _fastpath_queue;
 #endif
     uhd::transport::bounded_buffer<uhd::log::logging_info> _log_queue;
+
+    struct ring_entry {
+        std::shared_ptr<uhd::log::binary::ring_t> ring;
+        size_t dropped_reported;
+    };
+    std::mutex _rings_mutex;
+    std::vector<ring_entry> _rings;
+    //! Only one thread at a time may pop from the rings
+    std::mutex _drain_mutex;
+    // Reference points to convert record timestamps to wall clock time
+    const uint64_t _ts_ref;
+    const std::chrono::steady_clock::time_point _steady_ref;
+    const pt::ptime _wall_ref;
+    double _ts_per_us;
 };
 
 UHD_SINGLETON_FCN(log_resource, log_rs);
@@ -512,6 +672,38 @@ uhd::_log::log::~log(void)
     }
 }
 
+/***********************************************************************
+ * Binary logging
+ **********************************************************************/
+uhd::log::severity_level uhd::log::binary::get_level(void)
+{
+    return log_rs().global_level;
+}
+
+uhd::log::binary::ring_t *uhd::log::binary::register_thread(void)
+{
+    // Owns the ring of a thread, and marks it when the thread exits
+    struct ring_owner {
+        std::shared_ptr<ring_t> ring;
+        ~ring_owner() {
+            if (ring) {
+                ring->orphaned = true;
+            }
+        }
+    };
+    static thread_local ring_owner owner;
+    if (not owner.ring) {
+        owner.ring = std::make_shared<ring_t>();
+        log_rs().add_ring(owner.ring);
+    }
+    return owner.ring.get();
+}
+
+void uhd::log::binary::flush(void)
+{
+    log_rs().drain_binary();
+}
+
 #ifndef UHD_LOG_FASTPATH_DISABLE
 void uhd::_log::log_fastpath(const std::string &msg)
 {
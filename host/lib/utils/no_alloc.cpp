@@ -0,0 +1,33 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/no_alloc.hpp>
+
+namespace {
+    //! Depth of the active scopes of this thread, scopes nest
+    thread_local size_t scope_depth = 0;
+}
+
+bool uhd::no_alloc::is_enabled(const uhd::stream_args_t &args)
+{
+    const std::string value = args.args.get("no_alloc", "0");
+    return value == "1" or value == "true";
+}
+
+bool uhd::no_alloc::in_scope(void)
+{
+    return scope_depth != 0;
+}
+
+uhd::no_alloc::scope::scope(const bool active): _active(active)
+{
+    if (_active) scope_depth++;
+}
+
+uhd::no_alloc::scope::~scope(void)
+{
+    if (_active) scope_depth--;
+}
@@ -0,0 +1,219 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/stream_stats_exporter.hpp>
+#include <uhd/utils/tasks.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/exception.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/format.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <thread>
+
+using namespace uhd;
+namespace ipc = boost::interprocess;
+
+namespace {
+    //! "UHDS", marks a segment as written by an exporter
+    const uint32_t SHM_MAGIC = 0x55484453;
+    //! Bump this when the layout of the segment changes
+    const uint32_t SHM_VERSION = 2;
+
+    /*!
+     * Layout of the shared memory segment.
+     *
+     * The counters are guarded by a sequence lock: The writer makes the
+     * sequence number odd before it updates the counters, and even again
+     * afterwards. A reader retries until it copied the counters with the
+     * same, even sequence number before and after.
+     */
+    struct shm_layout_t {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t stats_size;
+        std::atomic<uint32_t> seq;
+        uint64_t num_updates;
+        stream_stats_t stats;
+    };
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2,
+        "The sequence lock needs a lock-free atomic integer");
+}
+
+stream_stats_exporter::~stream_stats_exporter(void){
+    /* NOP */
+}
+
+/***********************************************************************
+ * Exporter implementation
+ **********************************************************************/
+class stream_stats_exporter_impl : public stream_stats_exporter{
+public:
+    typedef std::function<bool(stream_stats_t &)> stats_getter_type;
+
+    stream_stats_exporter_impl(
+        const stats_getter_type &get_stats,
+        const std::string &name,
+        const double interval
+    ):
+        _get_stats(get_stats),
+        _name(name),
+        _interval(std::chrono::microseconds(int64_t(interval*1e6))),
+        _num_updates(0)
+    {
+        if (interval <= 0.0){
+            throw uhd::value_error(
+                "The stream stats export interval must be positive.");
+        }
+        try {
+            ipc::shared_memory_object::remove(_name.c_str());
+            _shm = ipc::shared_memory_object(
+                ipc::create_only, _name.c_str(), ipc::read_write);
+            _shm.truncate(sizeof(shm_layout_t));
+            _region = ipc::mapped_region(_shm, ipc::read_write);
+        } catch (const ipc::interprocess_exception &ex) {
+            throw uhd::runtime_error(str(boost::format(
+                "Cannot create the shared memory segment %s for stream stats: %s")
+                % _name % ex.what()));
+        }
+
+        _layout = new (_region.get_address()) shm_layout_t();
+        _layout->version = SHM_VERSION;
+        _layout->stats_size = sizeof(stream_stats_t);
+        _layout->seq.store(0);
+        _layout->num_updates = 0;
+        //publish the magic last, readers ignore the segment until then
+        std::atomic_thread_fence(std::memory_order_release);
+        _layout->magic = SHM_MAGIC;
+
+        _next_update = std::chrono::steady_clock::now();
+        _task = task::make(
+            std::bind(&stream_stats_exporter_impl::export_task, this),
+            "uhd_stats_exp");
+    }
+
+    ~stream_stats_exporter_impl(void){
+        _task.reset();
+        ipc::shared_memory_object::remove(_name.c_str());
+    }
+
+    uint64_t get_num_updates(void){
+        return _num_updates;
+    }
+
+private:
+    void export_task(void){
+        if (std::chrono::steady_clock::now() < _next_update){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return;
+        }
+        _next_update += _interval;
+
+        stream_stats_t stats;
+        if (not _get_stats(stats)) return;
+
+        const uint32_t seq = _layout->seq.load(std::memory_order_relaxed);
+        _layout->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&_layout->stats, &stats, sizeof(stats));
+        _layout->num_updates = ++_num_updates;
+        _layout->seq.store(seq + 2, std::memory_order_release);
+    }
+
+    const stats_getter_type _get_stats;
+    const std::string _name;
+    const std::chrono::steady_clock::duration _interval;
+    std::chrono::steady_clock::time_point _next_update;
+    std::atomic<uint64_t> _num_updates;
+    ipc::shared_memory_object _shm;
+    ipc::mapped_region _region;
+    shm_layout_t *_layout;
+    task::sptr _task;
+};
+
+/***********************************************************************
+ * Factory and reader
+ **********************************************************************/
+template <typename streamer_type>
+static stream_stats_exporter::sptr make_exporter(
+    boost::shared_ptr<streamer_type> streamer,
+    const std::string &name,
+    const double interval
+){
+    boost::weak_ptr<streamer_type> weak_streamer(streamer);
+    return stream_stats_exporter::sptr(new stream_stats_exporter_impl(
+        [weak_streamer](stream_stats_t &stats){
+            boost::shared_ptr<streamer_type> streamer = weak_streamer.lock();
+            if (not streamer) return false;
+            stats = streamer->get_stats();
+            return true;
+        }, name, interval));
+}
+
+stream_stats_exporter::sptr stream_stats_exporter::make(
+    rx_streamer::sptr streamer,
+    const std::string &name,
+    const double interval
+){
+    return make_exporter(streamer, name, interval);
+}
+
+stream_stats_exporter::sptr stream_stats_exporter::make(
+    tx_streamer::sptr streamer,
+    const std::string &name,
+    const double interval
+){
+    return make_exporter(streamer, name, interval);
+}
+
+uint64_t stream_stats_exporter::read(const std::string &name, stream_stats_t &stats)
+{
+    ipc::mapped_region region;
+    try {
+        ipc::shared_memory_object shm(
+            ipc::open_only, name.c_str(), ipc::read_only);
+        region = ipc::mapped_region(shm, ipc::read_only);
+    } catch (const ipc::interprocess_exception &) {
+        return 0;
+    }
+    if (region.get_size() < sizeof(shm_layout_t)) {
+        return 0;
+    }
+
+    const shm_layout_t *layout =
+        static_cast<const shm_layout_t *>(region.get_address());
+    if (layout->magic != SHM_MAGIC) {
+        return 0;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (layout->version != SHM_VERSION
+        or layout->stats_size != sizeof(stream_stats_t)) {
+        UHD_LOGGER_WARNING("STATS") << boost::format(
+            "The stream stats segment %s has an incompatible layout (version %u).")
+            % name % layout->version;
+        return 0;
+    }
+
+    while (true) {
+        const uint32_t seq_before = layout->seq.load(std::memory_order_acquire);
+        if (seq_before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(&stats, &layout->stats, sizeof(stats));
+        const uint64_t num_updates = layout->num_updates;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (layout->seq.load(std::memory_order_relaxed) == seq_before) {
+            return num_updates;
+        }
+    }
+}
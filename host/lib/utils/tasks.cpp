@@ -10,6 +10,7 @@
 #include <uhd/utils/thread.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/exception.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/barrier.hpp>
 #include <exception>
@@ -43,6 +44,7 @@ public:
 
 private:
     void task_loop(const task_fcn_type &task_fcn){
+        const thread_policy::scope policy_scope("task");
         try{
             while (!_exit){
                 task_fcn();
@@ -121,6 +123,7 @@ public:
 private:
 
     void task_loop(const task_fcn_type &task_fcn){
+        const thread_policy::scope policy_scope("msg_task");
         _running = true;
         _spawn_barrier.wait();
 
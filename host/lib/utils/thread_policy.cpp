@@ -0,0 +1,364 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/thread_policy.hpp>
+#include <uhdlib/utils/prefs.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+
+using namespace uhd;
+using namespace uhd::thread_policy;
+
+namespace {
+    constexpr char CONFIG_SECTION[] = "threads";
+    constexpr char ARGS_PREFIX[] = "thread_";
+    constexpr char DEFAULT_CLASS[] = "default";
+
+    typedef std::map<std::string, policy_t> policy_map_t;
+
+    struct thread_entry_t
+    {
+        std::string thread_class;
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+        pthread_t handle;
+        pid_t tid;
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+    };
+
+    //! The policies, and the threads in a scope
+    struct registry_t
+    {
+        std::mutex mutex;
+        policy_map_t policies;
+        std::map<size_t, thread_entry_t> threads;
+        size_t next_id = 0;
+        bool config_read = false;
+    };
+
+    // Never destroyed, threads may leave their scopes during static destruction
+    registry_t &get_registry(void)
+    {
+        static registry_t *registry = new registry_t();
+        return *registry;
+    }
+
+    void check_priority_range(const float priority)
+    {
+        if (priority > +1.0 or priority < -1.0)
+            throw uhd::value_error("priority out of range [-1.0, +1.0]");
+    }
+
+    std::vector<size_t> parse_cpus(const std::string &key, const std::string &value)
+    {
+        std::vector<size_t> cpus;
+        std::vector<std::string> tokens;
+        boost::split(tokens, value, boost::is_any_of(",;"));
+        try {
+            for (std::string token : tokens) {
+                boost::trim(token);
+                if (token.empty()) continue;
+                std::vector<std::string> range;
+                boost::split(range, token, boost::is_any_of("-"));
+                if (range.size() > 2) throw boost::bad_lexical_cast();
+                const size_t first = boost::lexical_cast<size_t>(range.front());
+                const size_t last = boost::lexical_cast<size_t>(range.back());
+                if (last < first) throw boost::bad_lexical_cast();
+                for (size_t cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+            }
+        } catch (const boost::bad_lexical_cast &) {
+            throw uhd::value_error(str(
+                boost::format("%s: invalid CPU list \"%s\"") % key % value));
+        }
+        return cpus;
+    }
+
+    policy_t::sched_t parse_sched(const std::string &key, const std::string &value)
+    {
+        const std::string name = boost::algorithm::to_lower_copy(value);
+        if (name == "other") return policy_t::POLICY_OTHER;
+        if (name == "batch") return policy_t::POLICY_BATCH;
+        if (name == "idle") return policy_t::POLICY_IDLE;
+        if (name == "fifo") return policy_t::POLICY_FIFO;
+        if (name == "rr") return policy_t::POLICY_RR;
+        throw uhd::value_error(str(
+            boost::format("%s: unknown scheduling policy \"%s\"") % key % value));
+    }
+
+    float parse_priority(const std::string &key, const std::string &value)
+    {
+        try {
+            const float priority = boost::lexical_cast<float>(value);
+            check_priority_range(priority);
+            return priority;
+        } catch (const std::exception &) {
+            throw uhd::value_error(str(
+                boost::format("%s: invalid priority \"%s\", must be in [-1.0, +1.0]")
+                % key % value));
+        }
+    }
+
+    /*!
+     * Set one field from a <class>_<field> key
+     * \return false if the key is not a thread policy key
+     */
+    bool set_field(
+        policy_map_t &policies, const std::string &key, const std::string &value
+    ) {
+        const size_t pos = key.rfind('_');
+        if (pos == std::string::npos or pos == 0) return false;
+        const std::string thread_class = key.substr(0, pos);
+        const std::string field = key.substr(pos + 1);
+        if (field == "cpus") {
+            policies[thread_class].cpus = parse_cpus(key, value);
+        } else if (field == "sched") {
+            policies[thread_class].sched = parse_sched(key, value);
+        } else if (field == "priority") {
+            policies[thread_class].priority = parse_priority(key, value);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    //! Must be called with the registry locked
+    policy_t get_merged_policy(const registry_t &registry, const std::string &thread_class)
+    {
+        policy_t policy;
+        const auto it = registry.policies.find(thread_class);
+        if (it != registry.policies.end()) policy = it->second;
+        const auto def = registry.policies.find(DEFAULT_CLASS);
+        if (def != registry.policies.end()) {
+            if (policy.cpus.empty()) policy.cpus = def->second.cpus;
+            if (policy.sched == policy_t::POLICY_INHERIT) {
+                policy.sched = def->second.sched;
+                policy.priority = def->second.priority;
+            }
+        }
+        return policy;
+    }
+
+    /*!
+     * Apply a policy to a thread, which need not be the calling thread
+     * \return an error message, empty on success
+     */
+    std::string apply_policy(const thread_entry_t &thread, const policy_t &policy)
+    {
+        if (policy.cpus.empty() and policy.sched == policy_t::POLICY_INHERIT) {
+            return "";
+        }
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+        if (not policy.cpus.empty()) {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            for (const size_t cpu : policy.cpus) {
+                if (cpu >= CPU_SETSIZE) {
+                    return str(boost::format("CPU %d out of range") % cpu);
+                }
+                CPU_SET(cpu, &cpu_set);
+            }
+            const int ret = pthread_setaffinity_np(thread.handle, sizeof(cpu_set), &cpu_set);
+            if (ret != 0) {
+                return std::string("error in pthread_setaffinity_np: ") + std::strerror(ret);
+            }
+        }
+        if (policy.sched == policy_t::POLICY_INHERIT) {
+            return "";
+        }
+
+        int sched_policy = SCHED_OTHER;
+        switch (policy.sched) {
+            case policy_t::POLICY_BATCH: sched_policy = SCHED_BATCH; break;
+            case policy_t::POLICY_IDLE: sched_policy = SCHED_IDLE; break;
+            case policy_t::POLICY_FIFO: sched_policy = SCHED_FIFO; break;
+            case policy_t::POLICY_RR: sched_policy = SCHED_RR; break;
+            default: break;
+        }
+        const bool realtime = sched_policy == SCHED_FIFO or sched_policy == SCHED_RR;
+
+        sched_param sp;
+        sp.sched_priority = 0;
+        if (realtime) {
+            const int min_pri = sched_get_priority_min(sched_policy);
+            const int max_pri = sched_get_priority_max(sched_policy);
+            if (min_pri == -1 or max_pri == -1) {
+                return "error in sched_get_priority_min/max";
+            }
+            // we cannot have below normal priority, set to zero
+            const float priority = std::max(policy.priority, 0.0f);
+            sp.sched_priority = int(priority * (max_pri - min_pri)) + min_pri;
+        }
+        const int ret = pthread_setschedparam(thread.handle, sched_policy, &sp);
+        if (ret != 0) {
+            return std::string("error in pthread_setschedparam: ") + std::strerror(ret);
+        }
+
+        // the nice value is per thread on Linux
+        if (sched_policy == SCHED_OTHER or sched_policy == SCHED_BATCH) {
+            const int nice = int(std::lround(
+                (policy.priority < 0) ? -19 * policy.priority : -20 * policy.priority));
+            if (setpriority(PRIO_PROCESS, id_t(thread.tid), nice) != 0) {
+                return std::string("error in setpriority: ") + std::strerror(errno);
+            }
+        }
+        return "";
+#else
+        (void)thread;
+        return "thread placement is not supported on this platform";
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+    }
+
+    //! Must be called with the registry locked
+    std::vector<std::string> apply_all(const registry_t &registry)
+    {
+        std::vector<std::string> errors;
+        for (const auto &thread : registry.threads) {
+            const std::string error = apply_policy(
+                thread.second, get_merged_policy(registry, thread.second.thread_class));
+            if (not error.empty()) {
+                errors.push_back(thread.second.thread_class + ": " + error);
+            }
+        }
+        return errors;
+    }
+
+    //! Log outside of the registry lock, the logger threads have scopes too
+    void log_errors(const std::vector<std::string> &errors)
+    {
+        for (const std::string &error : errors) {
+            UHD_LOGGER_WARNING("UHD") << boost::format(
+                "Unable to apply the thread policy. Performance may be negatively affected.\n"
+                "%s"
+            ) % error;
+        }
+    }
+}
+
+void thread_policy::set_policy(const std::string &thread_class, const policy_t &policy)
+{
+    check_priority_range(policy.priority);
+    registry_t &registry = get_registry();
+    std::vector<std::string> errors;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.policies[thread_class] = policy;
+        errors = apply_all(registry);
+    }
+    log_errors(errors);
+}
+
+policy_t thread_policy::get_policy(const std::string &thread_class)
+{
+    registry_t &registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return get_merged_policy(registry, thread_class);
+}
+
+void thread_policy::update(const uhd::device_addr_t &args)
+{
+    registry_t &registry = get_registry();
+    bool config_read;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        config_read = registry.config_read;
+    }
+
+    // Read the config file without the lock, reading it may start the logger
+    uhd::device_addr_t config;
+    if (not config_read) {
+        config_parser &conf = uhd::prefs::get_uhd_config();
+        for (const std::string &key : conf.options(CONFIG_SECTION)) {
+            config[key] = conf.get<std::string>(CONFIG_SECTION, key);
+        }
+    }
+
+    std::vector<std::string> unknown_keys;
+    std::vector<std::string> errors;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        // Parse into a copy, so malformed values do not leave half a policy
+        policy_map_t policies = registry.policies;
+        if (not registry.config_read) {
+            for (const std::string &key : config.keys()) {
+                if (not set_field(policies, key, config[key])) {
+                    unknown_keys.push_back(key);
+                }
+            }
+        }
+        const std::string prefix(ARGS_PREFIX);
+        for (const std::string &key : args.keys()) {
+            if (boost::starts_with(key, prefix)) {
+                set_field(policies, key.substr(prefix.size()), args[key]);
+            }
+        }
+        registry.policies = policies;
+        registry.config_read = true;
+        errors = apply_all(registry);
+    }
+    for (const std::string &key : unknown_keys) {
+        UHD_LOGGER_WARNING("UHD") << "Ignoring unknown key " << key
+            << " in the [" << CONFIG_SECTION << "] section of the config file";
+    }
+    log_errors(errors);
+}
+
+/***********************************************************************
+ * Scope
+ **********************************************************************/
+namespace {
+    size_t enter_scope(const std::string &thread_class)
+    {
+        thread_entry_t thread;
+        thread.thread_class = thread_class;
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+        thread.handle = pthread_self();
+        thread.tid = pid_t(syscall(SYS_gettid));
+#endif /* HAVE_PTHREAD_SETAFFINITY_NP */
+
+        registry_t &registry = get_registry();
+        size_t id;
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            id = registry.next_id++;
+            registry.threads[id] = thread;
+            error = apply_policy(thread, get_merged_policy(registry, thread_class));
+        }
+        if (not error.empty()) {
+            log_errors(std::vector<std::string>(1, thread_class + ": " + error));
+        }
+        return id;
+    }
+}
+
+thread_policy::scope::scope(const std::string &thread_class)
+    : _id(enter_scope(thread_class))
+{
+    /* NOP */
+}
+
+thread_policy::scope::~scope(void)
+{
+    registry_t &registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.erase(_id);
+}
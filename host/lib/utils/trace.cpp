@@ -0,0 +1,393 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/utils/trace.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/platform.hpp>
+#include <uhd/utils/static.hpp>
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+using namespace uhd::trace;
+
+namespace {
+    //! Keep the rings of at most this many exited threads
+    const size_t MAX_ORPHANED_RINGS = 64;
+
+    //! Time to keep recording after a trigger, before dumping
+    const std::chrono::milliseconds TRIGGER_DELAY(20);
+
+    //! Event type of the Chrome trace format for a phase
+    const char *get_phase_char(const phase_t phase)
+    {
+        switch (phase) {
+        case PHASE_COMPLETE: return "X";
+        case PHASE_INSTANT: return "i";
+        case PHASE_COUNTER: return "C";
+        }
+        return "i";
+    }
+
+    //! Name of the calling thread, for the trace viewer
+    std::string get_thread_name(const size_t index)
+    {
+#ifdef __linux__
+        char name[16] = {0};
+        if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0
+            and name[0] != '\0') {
+            return str(boost::format("%s (%u)") % name % index);
+        }
+#endif
+        return str(boost::format("thread %u") % index);
+    }
+
+    //! Quote a static string for JSON (names are literals, but be safe)
+    std::string json_string(const char *str)
+    {
+        std::string out = "\"";
+        for (const char *c = str; *c != '\0'; c++) {
+            if (*c == '"' or *c == '\\') {
+                out += '\\';
+            }
+            out += (*c >= 0 and *c < 0x20) ? ' ' : *c;
+        }
+        return out + "\"";
+    }
+}
+
+/***********************************************************************
+ * Ring
+ **********************************************************************/
+size_t ring_t::read(event_t *events) const
+{
+    // Copy optimistically, then drop whatever the writer may have
+    // overwritten while we were copying.
+    const uint64_t head = _head.load(std::memory_order_acquire);
+    const uint64_t start = std::max(
+        _start.load(std::memory_order_relaxed),
+        head > RING_SIZE ? head - RING_SIZE : 0);
+    for (uint64_t i = start; i < head; i++) {
+        events[i - start] = _events[i % RING_SIZE];
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t new_head = _head.load(std::memory_order_relaxed);
+    const uint64_t valid_start = std::max(start,
+        new_head > RING_SIZE ? new_head - RING_SIZE : 0);
+    if (valid_start >= head) {
+        return 0;
+    }
+    const size_t num_valid = size_t(head - valid_start);
+    if (valid_start != start) {
+        std::copy(events + (valid_start - start), events + (head - start), events);
+    }
+    return num_valid;
+}
+
+void ring_t::clear(void)
+{
+    _start.store(_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+/***********************************************************************
+ * Registry of all rings, and the trigger
+ **********************************************************************/
+class trace_resource {
+public:
+    std::atomic<bool> enabled;
+
+    trace_resource(void):
+        enabled(false),
+        _num_threads(0),
+        _armed(false),
+        _triggered(false),
+        _trigger_reason(""),
+        _num_trigger_dumps(0),
+        _exit(false)
+    {
+        const char *trace_file_env = std::getenv("UHD_TRACE_FILE");
+        if (trace_file_env != NULL and trace_file_env[0] != '\0') {
+            set_trigger_file(trace_file_env);
+            enabled = true;
+        }
+    }
+
+    ~trace_resource(void)
+    {
+        {
+            std::lock_guard<std::mutex> l(_trigger_mutex);
+            _exit = true;
+        }
+        _trigger_cond.notify_one();
+        if (_trigger_thread.joinable()) {
+            _trigger_thread.join();
+        }
+    }
+
+    ring_t *register_thread(void)
+    {
+        // Owns the ring of a thread, and marks it when the thread exits
+        struct ring_owner {
+            std::shared_ptr<ring_t> ring;
+            ~ring_owner() {
+                if (ring) {
+                    ring->orphaned = true;
+                }
+            }
+        };
+        static thread_local ring_owner owner;
+        if (not owner.ring) {
+            std::lock_guard<std::mutex> l(_rings_mutex);
+            owner.ring = std::make_shared<ring_t>(get_thread_name(_num_threads));
+            _rings.push_back(ring_entry{owner.ring, _num_threads++});
+
+            // The rings of exited threads are kept, their events are what
+            // led up to a problem. But don't let them pile up.
+            const size_t num_orphaned = std::count_if(_rings.begin(), _rings.end(),
+                [](const ring_entry &entry){ return bool(entry.ring->orphaned); });
+            if (num_orphaned > MAX_ORPHANED_RINGS) {
+                _rings.erase(std::find_if(_rings.begin(), _rings.end(),
+                    [](const ring_entry &entry){ return bool(entry.ring->orphaned); }));
+            }
+        }
+        return owner.ring.get();
+    }
+
+    size_t dump(const std::string &path)
+    {
+        std::ofstream out(path.c_str());
+        if (not out) {
+            throw uhd::runtime_error(str(boost::format(
+                "Cannot open %s to write the trace") % path));
+        }
+
+        std::vector<ring_entry> rings;
+        {
+            std::lock_guard<std::mutex> l(_rings_mutex);
+            rings = _rings;
+        }
+
+        const int32_t pid = uhd::get_process_id();
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << boost::format(
+            "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"tid\":0,"
+            "\"args\":{\"name\":\"UHD\"}}") % pid;
+
+        std::vector<event_t> events(RING_SIZE);
+        size_t num_events = 0;
+        for (const ring_entry &entry : rings) {
+            out << boost::format(
+                ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%u,"
+                "\"args\":{\"name\":%s}}")
+                % pid % entry.tid % json_string(entry.ring->thread_name.c_str());
+
+            const size_t n = entry.ring->read(events.data());
+            for (size_t i = 0; i < n; i++) {
+                const event_t &event = events[i];
+                // every channel of a counter gets its own track
+                const std::string name = (event.site->phase == PHASE_COUNTER)
+                    ? str(boost::format("%s %u") % event.site->name % event.chan)
+                    : std::string(event.site->name);
+                out << boost::format(
+                    ",\n{\"ph\":\"%s\",\"cat\":%s,\"name\":%s,\"pid\":%d,\"tid\":%u,"
+                    "\"ts\":%.3f")
+                    % get_phase_char(event.site->phase)
+                    % json_string(event.site->category)
+                    % json_string(name.c_str())
+                    % pid % entry.tid % (event.host_ns / 1e3);
+                switch (event.site->phase) {
+                case PHASE_COMPLETE:
+                    out << boost::format(",\"dur\":%.3f") % (event.value / 1e3);
+                    break;
+                case PHASE_INSTANT:
+                    out << ",\"s\":\"t\"";
+                    break;
+                case PHASE_COUNTER:
+                    break;
+                }
+                out << ",\"args\":{";
+                switch (event.site->phase) {
+                case PHASE_COMPLETE:
+                    break;
+                case PHASE_INSTANT:
+                    out << "\"chan\":" << event.chan;
+                    break;
+                case PHASE_COUNTER:
+                    out << "\"value\":" << event.value;
+                    break;
+                }
+                if (not std::isnan(event.device_time)) {
+                    out << boost::format("%s\"device_time\":%.9f")
+                        % (event.site->phase == PHASE_COMPLETE ? "" : ",")
+                        % event.device_time;
+                }
+                out << "}}";
+            }
+            num_events += n;
+        }
+        out << "\n]}\n";
+        out.close();
+        if (not out) {
+            throw uhd::runtime_error(str(boost::format(
+                "Cannot write the trace to %s") % path));
+        }
+        return num_events;
+    }
+
+    void clear(void)
+    {
+        std::lock_guard<std::mutex> l(_rings_mutex);
+        for (ring_entry &entry : _rings) {
+            entry.ring->clear();
+        }
+    }
+
+    void set_trigger_file(const std::string &path)
+    {
+        std::lock_guard<std::mutex> l(_trigger_mutex);
+        _trigger_path = path;
+        _triggered = false;
+        _armed = not path.empty();
+        if (_armed and not _trigger_thread.joinable()) {
+            _trigger_thread = std::thread([this](){ this->trigger_task(); });
+        }
+    }
+
+    void trigger(const char *reason)
+    {
+        // cheap check first, this is called from the fast path
+        if (not _armed.load(std::memory_order_relaxed) or not enabled) {
+            return;
+        }
+        if (not _armed.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> l(_trigger_mutex);
+            _trigger_reason = reason;
+            _triggered = true;
+        }
+        _trigger_cond.notify_one();
+    }
+
+    size_t get_num_trigger_dumps(void)
+    {
+        return _num_trigger_dumps;
+    }
+
+private:
+    //! Waits for triggers and writes the dumps, so the fast path never does
+    void trigger_task(void)
+    {
+        std::unique_lock<std::mutex> l(_trigger_mutex);
+        while (true) {
+            _trigger_cond.wait(l, [this](){ return _exit or _triggered; });
+            if (_exit) {
+                return;
+            }
+            _triggered = false;
+            const std::string path = _trigger_path;
+            const std::string reason = _trigger_reason;
+            l.unlock();
+
+            // record a little of what happens after the trigger, too
+            std::this_thread::sleep_for(TRIGGER_DELAY);
+            try {
+                const size_t num_events = dump(path);
+                _num_trigger_dumps++;
+                UHD_LOGGER_INFO("TRACE") << boost::format(
+                    "Trace triggered by %s: wrote %u events to %s")
+                    % reason % num_events % path;
+            } catch (const uhd::exception &ex) {
+                UHD_LOGGER_ERROR("TRACE") << ex.what();
+            }
+            l.lock();
+        }
+    }
+
+    struct ring_entry {
+        std::shared_ptr<ring_t> ring;
+        size_t tid;
+    };
+    std::mutex _rings_mutex;
+    std::vector<ring_entry> _rings;
+    size_t _num_threads;
+
+    std::mutex _trigger_mutex;
+    std::condition_variable _trigger_cond;
+    std::thread _trigger_thread;
+    std::string _trigger_path;
+    std::atomic<bool> _armed;
+    bool _triggered;
+    const char *_trigger_reason;
+    std::atomic<size_t> _num_trigger_dumps;
+    bool _exit;
+};
+
+UHD_SINGLETON_FCN(trace_resource, trace_rs);
+
+/***********************************************************************
+ * Public API
+ **********************************************************************/
+bool uhd::trace::is_compiled_in(void)
+{
+#ifdef UHD_TRACE_ENABLE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void uhd::trace::set_enabled(const bool enable)
+{
+    trace_rs().enabled = enable;
+}
+
+bool uhd::trace::get_enabled(void)
+{
+    return trace_rs().enabled.load(std::memory_order_relaxed);
+}
+
+size_t uhd::trace::dump(const std::string &path)
+{
+    return trace_rs().dump(path);
+}
+
+void uhd::trace::clear(void)
+{
+    trace_rs().clear();
+}
+
+void uhd::trace::set_trigger_file(const std::string &path)
+{
+    trace_rs().set_trigger_file(path);
+}
+
+void uhd::trace::trigger(const char *reason)
+{
+    trace_rs().trigger(reason);
+}
+
+size_t uhd::trace::get_num_trigger_dumps(void)
+{
+    return trace_rs().get_num_trigger_dumps();
+}
+
+ring_t *uhd::trace::register_thread(void)
+{
+    return trace_rs().register_thread();
+}
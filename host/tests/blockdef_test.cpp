@@ -81,3 +81,16 @@ BOOST_AUTO_TEST_CASE(test_regs) {
     BOOST_CHECK_EQUAL(user_regs["RB_MAGNITUDE_OUT"], 1);
 }
 
+
+BOOST_AUTO_TEST_CASE(test_lookup_repeated) {
+    // Only the first lookup builds the index, the rest must agree with it
+    for (size_t i = 0; i < 3; i++) {
+        blockdef::sptr block_definition = blockdef::make_from_noc_id(0xFF70000000000000);
+        BOOST_REQUIRE(block_definition);
+        BOOST_CHECK_EQUAL(block_definition->get_name(), "FFT");
+        BOOST_CHECK_EQUAL(block_definition->noc_id(), 0xFF70000000000000);
+    }
+
+    // No block definition declares a prefix of this NoC ID
+    BOOST_CHECK(not blockdef::make_from_noc_id(0x0123456789ABCDEF));
+}
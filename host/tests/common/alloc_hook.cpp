@@ -0,0 +1,76 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "alloc_hook.hpp"
+#include <uhdlib/utils/no_alloc.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> violations(0);
+    std::atomic<size_t> allocations(0);
+
+    void *hooked_alloc(const size_t size)
+    {
+        allocations++;
+        if (uhd::no_alloc::in_scope()) violations++;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+}
+
+size_t alloc_hook::get_violations(void)
+{
+    return violations;
+}
+
+size_t alloc_hook::get_allocations(void)
+{
+    return allocations;
+}
+
+void alloc_hook::reset(void)
+{
+    violations = 0;
+    allocations = 0;
+}
+
+/***********************************************************************
+ * Replacements of the global allocation functions
+ **********************************************************************/
+void *operator new(size_t size)
+{
+    void *p = hooked_alloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    void *p = hooked_alloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return hooked_alloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return hooked_alloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
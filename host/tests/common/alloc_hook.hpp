@@ -0,0 +1,31 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_ALLOC_HOOK_HPP
+#define INCLUDED_ALLOC_HOOK_HPP
+
+#include <stddef.h>
+
+/*! Allocation hook for the no-allocation mode of the streamers
+ *
+ * Building a test with this hook replaces the global operator new. Every
+ * allocation a thread makes while it is in a uhd::no_alloc::scope counts as
+ * a violation, so a test can fail on it.
+ */
+namespace alloc_hook {
+
+    //! Get the number of allocations made in a scope since the last reset
+    size_t get_violations(void);
+
+    //! Get the number of allocations made since the last reset
+    size_t get_allocations(void);
+
+    //! Reset the counts
+    void reset(void);
+
+} // namespace alloc_hook
+
+#endif /* INCLUDED_ALLOC_HOOK_HPP */
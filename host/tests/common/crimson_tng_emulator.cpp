@@ -0,0 +1,709 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "crimson_tng_emulator.hpp"
+#include "crimson_tng_fw_common.h"
+#include "system_time.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/log.hpp>
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/bind.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace asio = boost::asio;
+using namespace uhd;
+using namespace uhd::transport;
+
+namespace {
+
+//! Rate of the timestamps in VITA packets and flow control packets
+constexpr double TICK_RATE = CRIMSON_TNG_MASTER_CLOCK_RATE / 2.0;
+//! How often the RX generators wake up to send the samples that are due
+constexpr std::chrono::microseconds RX_GEN_PERIOD(500);
+//! Longest backlog an RX generator catches up on in one wakeup, in seconds
+constexpr double RX_GEN_MAX_BACKLOG = 0.1;
+
+constexpr uint64_t TIME_DIFF_REQ_ID = 0x20002;
+constexpr uint64_t FIFO_LVL_REQ_ID  = 0x10001;
+constexpr uint64_t RX_STREAM_CMD_ID = 0x1;
+
+constexpr uint64_t INST_RELOAD = 0x8;
+constexpr uint64_t INST_CHAIN  = 0x4;
+constexpr uint64_t INST_SAMPS  = 0x2;
+constexpr uint64_t INST_STOP   = 0x1;
+
+std::string chan_prefix(const std::string &dir, const size_t chan)
+{
+    return dir + "_" + std::string(1, 'a' + chan);
+}
+
+//! Split a management request into its comma-separated fields. The value
+//  of a set request may contain commas itself, so there are at most 4.
+std::vector<std::string> split_request(const std::string &req)
+{
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    while (tokens.size() < 3) {
+        const size_t comma = req.find(',', pos);
+        if (comma == std::string::npos) {
+            break;
+        }
+        tokens.push_back(req.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    tokens.push_back(req.substr(pos));
+    return tokens;
+}
+
+//! The rate a DSP chain actually runs at, for a requested rate
+double coerce_rate(const double rate)
+{
+    if (rate <= 0) {
+        return 0;
+    }
+    const double decim = std::max(1.0,
+        std::min(65536.0, std::round(CRIMSON_TNG_MASTER_CLOCK_RATE / rate)));
+    return CRIMSON_TNG_MASTER_CLOCK_RATE / decim;
+}
+
+} // namespace
+
+crimson_tng_emulator::args_t::args_t(void):
+    addr("127.0.0.1"),
+    mgmt_port(CRIMSON_TNG_FW_COMMS_UDP_PORT),
+    flow_port(CRIMSON_TNG_FLOW_CNTRL_UDP_PORT),
+    tx_port(42820),
+    rx_port(42836),
+    clock_offset(0.0),
+    clock_drift_ppm(0.0),
+    tx_buff_size(CRIMSON_TNG_BUFF_SIZE),
+    rx_spp(1024)
+{
+    /* NOP */
+}
+
+/***********************************************************************
+ * Emulator implementation
+ **********************************************************************/
+class crimson_tng_emulator_impl : public crimson_tng_emulator
+{
+public:
+    crimson_tng_emulator_impl(const args_t &args):
+        _args(args),
+        _mgmt_sock(_io_service),
+        _flow_sock(_io_service),
+        _rx_sock(_io_service),
+        _rx_timer(_io_service),
+        _clock_rate(1.0 + args.clock_drift_ppm / 1e6),
+        _num_mgmt_requests(0)
+    {
+        UHD_ASSERT_THROW(_args.rx_spp > 0);
+        const asio::ip::address addr = asio::ip::address::from_string(_args.addr);
+
+        _host_ref = get_system_time();
+        _dev_ref = _host_ref + time_spec_t(_args.clock_offset);
+
+        _mgmt_sock.open(asio::ip::udp::v4());
+        _mgmt_sock.bind(asio::ip::udp::endpoint(addr, _args.mgmt_port));
+        _flow_sock.open(asio::ip::udp::v4());
+        _flow_sock.bind(asio::ip::udp::endpoint(addr, _args.flow_port));
+        _rx_sock.open(asio::ip::udp::v4());
+
+        for (size_t chan = 0; chan < CRIMSON_TNG_TX_CHANNELS; chan++) {
+            tx_chan_t tx;
+            tx.sock.reset(new asio::ip::udp::socket(_io_service));
+            tx.sock->open(asio::ip::udp::v4());
+            tx.sock->bind(asio::ip::udp::endpoint(
+                addr, _args.tx_port ? _args.tx_port + chan : 0));
+            tx.buff.resize(CRIMSON_TNG_MAX_MTU / sizeof(uint32_t));
+            _tx_chans.push_back(tx);
+        }
+        _rx_chans.resize(CRIMSON_TNG_RX_CHANNELS);
+        _rx_buff.resize(vrt::max_if_hdr_words32 + _args.rx_spp);
+
+        init_props();
+
+        start_mgmt_recv();
+        start_flow_recv();
+        for (size_t chan = 0; chan < _tx_chans.size(); chan++) {
+            start_tx_recv(chan);
+        }
+        start_rx_timer();
+        _thread = boost::thread(boost::bind(&asio::io_service::run, &_io_service));
+    }
+
+    ~crimson_tng_emulator_impl(void)
+    {
+        _io_service.stop();
+        _thread.join();
+    }
+
+    uint16_t get_mgmt_port(void)
+    {
+        return _mgmt_sock.local_endpoint().port();
+    }
+
+    uint16_t get_flow_port(void)
+    {
+        return _flow_sock.local_endpoint().port();
+    }
+
+    uint16_t get_tx_port(const size_t chan)
+    {
+        return _tx_chans.at(chan).sock->local_endpoint().port();
+    }
+
+    std::string get_prop(const std::string &path)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return get_prop_locked(path);
+    }
+
+    void set_prop(const std::string &path, const std::string &value)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        set_prop_locked(path, value);
+    }
+
+    time_spec_t get_time_now(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return device_time();
+    }
+
+    size_t get_tx_level(const size_t chan)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        tx_chan_t &tx = _tx_chans.at(chan);
+        update_tx_level(tx, device_time());
+        return size_t(tx.level);
+    }
+
+    uint64_t get_tx_underflows(const size_t chan)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        tx_chan_t &tx = _tx_chans.at(chan);
+        update_tx_level(tx, device_time());
+        return tx.uflow;
+    }
+
+    uint64_t get_tx_overflows(const size_t chan)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _tx_chans.at(chan).oflow;
+    }
+
+    uint64_t get_rx_samps_sent(const size_t chan)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _rx_chans.at(chan).samps_sent;
+    }
+
+    uint64_t get_num_mgmt_requests(void)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _num_mgmt_requests;
+    }
+
+private:
+    struct tx_chan_t
+    {
+        tx_chan_t(void):
+            rate(0), level(0), eob(true), uflow(0), oflow(0)
+        {
+            /* NOP */
+        }
+
+        boost::shared_ptr<asio::ip::udp::socket> sock;
+        asio::ip::udp::endpoint sender;
+        std::vector<uint32_t> buff;
+        double rate;
+        //! Samples in the buffer as of last_update
+        double level;
+        time_spec_t last_update;
+        //! The buffer does not drain before this time (timed bursts)
+        time_spec_t start_time;
+        //! The last packet received ended a burst
+        bool eob;
+        uint64_t uflow;
+        uint64_t oflow;
+    };
+
+    struct rx_chan_t
+    {
+        rx_chan_t(void):
+            rate(0), active(false), continuous(false),
+            num_samps(0), sent(0), samps_sent(0), seq(0)
+        {
+            /* NOP */
+        }
+
+        double rate;
+        bool active;
+        bool continuous;
+        time_spec_t start_time;
+        //! Samples requested by a finite stream command
+        uint64_t num_samps;
+        //! Samples sent since the last stream command
+        uint64_t sent;
+        //! Samples sent in total
+        uint64_t samps_sent;
+        size_t seq;
+    };
+
+    /*******************************************************************
+     * Property store and clock, call with _mutex held
+     ******************************************************************/
+    void init_props(void)
+    {
+        _props["fpga/about/name"] = "crimson_tng";
+        _props["fpga/about/serial"] = "001";
+        _props["fpga/link/sfpa/ip_addr"] = _args.addr;
+        _props["fpga/link/sfpb/ip_addr"] = _args.addr;
+        _props["fpga/board/flow_control/sfpa_port"] = std::to_string(get_flow_port());
+        _props["fpga/board/flow_control/sfpb_port"] = std::to_string(get_flow_port());
+        for (size_t chan = 0; chan < _tx_chans.size(); chan++) {
+            const std::string prefix = chan_prefix("tx", chan);
+            _props[prefix + "/link/port"] = std::to_string(get_tx_port(chan));
+            set_prop_locked(prefix + "/dsp/rate", "1e6");
+        }
+        for (size_t chan = 0; chan < _rx_chans.size(); chan++) {
+            const std::string prefix = chan_prefix("rx", chan);
+            _props[prefix + "/link/ip_dest"] = _args.addr;
+            _props[prefix + "/link/port"] = std::to_string(_args.rx_port + chan);
+            set_prop_locked(prefix + "/dsp/rate", "1e6");
+        }
+    }
+
+    std::string get_prop_locked(const std::string &path)
+    {
+        if (path == "time/clk/cur_time") {
+            return str(boost::format("%.9f") % device_time().get_real_secs());
+        }
+        // properties the emulator does not model read back as zero, like
+        // uninitialized properties on a unit do
+        const std::map<std::string, std::string>::const_iterator it = _props.find(path);
+        return it == _props.end() ? "0" : it->second;
+    }
+
+    void set_prop_locked(const std::string &path, const std::string &value)
+    {
+        if (path == "time/clk/cur_time") {
+            set_device_time(time_spec_t(boost::lexical_cast<double>(value)));
+            return;
+        }
+
+        for (size_t chan = 0; chan < _tx_chans.size(); chan++) {
+            if (path == chan_prefix("tx", chan) + "/dsp/rate") {
+                tx_chan_t &tx = _tx_chans[chan];
+                update_tx_level(tx, device_time());
+                tx.rate = coerce_rate(boost::lexical_cast<double>(value));
+                _props[path] = boost::lexical_cast<std::string>(tx.rate);
+                return;
+            }
+        }
+        for (size_t chan = 0; chan < _rx_chans.size(); chan++) {
+            if (path == chan_prefix("rx", chan) + "/dsp/rate") {
+                _rx_chans[chan].rate = coerce_rate(boost::lexical_cast<double>(value));
+                _props[path] = boost::lexical_cast<std::string>(_rx_chans[chan].rate);
+                return;
+            }
+        }
+        _props[path] = value;
+    }
+
+    time_spec_t device_time(void)
+    {
+        const double elapsed = (get_system_time() - _host_ref).get_real_secs();
+        return _dev_ref + time_spec_t(elapsed * _clock_rate);
+    }
+
+    void set_device_time(const time_spec_t &time)
+    {
+        _host_ref = get_system_time();
+        _dev_ref = time;
+    }
+
+    /*******************************************************************
+     * Management requests
+     ******************************************************************/
+    void start_mgmt_recv(void)
+    {
+        _mgmt_sock.async_receive_from(
+            asio::buffer(_mgmt_buff, sizeof(_mgmt_buff)), _mgmt_sender,
+            boost::bind(&crimson_tng_emulator_impl::handle_mgmt, this,
+                asio::placeholders::error, asio::placeholders::bytes_transferred));
+    }
+
+    void handle_mgmt(const boost::system::error_code &error, const size_t len)
+    {
+        if (error == asio::error::operation_aborted) {
+            return;
+        }
+        if (not error) {
+            // discovery requests are sent with their terminating null
+            const std::string req(_mgmt_buff, std::find(_mgmt_buff, _mgmt_buff + len, '\0'));
+            const std::string reply = process_mgmt(req);
+            boost::system::error_code send_error;
+            _mgmt_sock.send_to(asio::buffer(reply), _mgmt_sender, 0, send_error);
+        }
+        start_mgmt_recv();
+    }
+
+    std::string process_mgmt(const std::string &req)
+    {
+        const std::vector<std::string> tokens = split_request(req);
+        const std::string &seq = tokens[0];
+        boost::mutex::scoped_lock lock(_mutex);
+        _num_mgmt_requests++;
+        try {
+            if (tokens.size() == 3 and tokens[1] == "get") {
+                return seq + "," + CMD_SUCCESS + "," + get_prop_locked(tokens[2]);
+            }
+            if (tokens.size() == 4 and tokens[1] == "set") {
+                set_prop_locked(tokens[2], tokens[3]);
+                return seq + "," + CMD_SUCCESS + "," + get_prop_locked(tokens[2]);
+            }
+        } catch (const boost::bad_lexical_cast &) {
+            UHD_LOG_WARNING("CRIMSON_EMU", "Bad value in request: " << req);
+        }
+        return seq + "," + CMD_ERROR;
+    }
+
+    /*******************************************************************
+     * Flow control: time diff, FIFO levels, RX stream commands
+     ******************************************************************/
+    void start_flow_recv(void)
+    {
+        _flow_sock.async_receive_from(
+            asio::buffer(_flow_buff, sizeof(_flow_buff)), _flow_sender,
+            boost::bind(&crimson_tng_emulator_impl::handle_flow, this,
+                asio::placeholders::error, asio::placeholders::bytes_transferred));
+    }
+
+    void handle_flow(const boost::system::error_code &error, const size_t len)
+    {
+        if (error == asio::error::operation_aborted) {
+            return;
+        }
+        if (not error and len >= sizeof(uint64_t)) {
+            // requests are told apart by their length and header
+            const size_t num_words = len / sizeof(uint64_t);
+            uint64_t words[4] = {0, 0, 0, 0};
+            for (size_t i = 0; i < std::min<size_t>(num_words, 4); i++) {
+                words[i] = boost::endian::big_to_native(_flow_buff[i]);
+            }
+
+            const uint64_t header = words[0];
+            if (num_words == 3 and (header >> 16) == TIME_DIFF_REQ_ID) {
+                handle_time_diff(words[1], words[2]);
+            } else if (num_words == 1 and (header >> 16) == FIFO_LVL_REQ_ID) {
+                handle_fifo_lvl(header & 0xffff);
+            } else if (num_words == 4 and ((header >> 16) & 0xfffff) == RX_STREAM_CMD_ID) {
+                handle_rx_stream_cmd(header & 0xffff, (header >> 36) & 0xf,
+                    words[1], words[2], words[3]);
+            }
+        }
+        start_flow_recv();
+    }
+
+    void send_flow_reply(const uint64_t *words, const size_t num_words)
+    {
+        std::vector<uint64_t> reply(num_words);
+        for (size_t i = 0; i < num_words; i++) {
+            reply[i] = boost::endian::native_to_big(words[i]);
+        }
+        boost::system::error_code send_error;
+        _flow_sock.send_to(asio::buffer(reply), _flow_sender, 0, send_error);
+    }
+
+    /*! The reply to a time diff request is the request time minus the
+     * device time. The host drives it to zero with its PID controller.
+     */
+    void handle_time_diff(const uint64_t tv_sec, const uint64_t tv_tick)
+    {
+        const time_spec_t req_time(
+            time_t(int64_t(tv_sec)), double(int64_t(tv_tick)) / TICK_RATE);
+        time_spec_t diff;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            diff = req_time - device_time();
+        }
+        const uint64_t reply[2] = {
+            uint64_t(int64_t(diff.get_full_secs())),
+            uint64_t(int64_t(diff.get_frac_secs() * TICK_RATE))
+        };
+        send_flow_reply(reply, 2);
+    }
+
+    void handle_fifo_lvl(const size_t chan)
+    {
+        if (chan >= _tx_chans.size()) {
+            return;
+        }
+        uint64_t reply[5];
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            tx_chan_t &tx = _tx_chans[chan];
+            const time_spec_t now = device_time();
+            update_tx_level(tx, now);
+            const uint64_t level = std::min<uint64_t>(uint64_t(tx.level), 0xffff);
+            reply[0] = (uint64_t(chan) << 48) | level;
+            reply[1] = tx.oflow;
+            reply[2] = tx.uflow;
+            reply[3] = uint64_t(now.get_full_secs());
+            reply[4] = uint64_t(now.get_frac_secs() * TICK_RATE);
+        }
+        send_flow_reply(reply, 5);
+    }
+
+    void handle_rx_stream_cmd(
+        const size_t chan,
+        const uint64_t inst,
+        const uint64_t tv_sec,
+        const uint64_t tv_psec,
+        const uint64_t nsamples
+    ){
+        if (chan >= _rx_chans.size()) {
+            return;
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        rx_chan_t &rx = _rx_chans[chan];
+        if (inst & INST_STOP) {
+            rx.active = false;
+            return;
+        }
+        const time_spec_t now = device_time();
+        const time_spec_t start(time_t(int64_t(tv_sec)), double(int64_t(tv_psec)) / 1e12);
+        rx.active = true;
+        rx.continuous = (inst & INST_SAMPS) == 0;
+        rx.num_samps = nsamples;
+        rx.start_time = start < now ? now : start;
+        rx.sent = 0;
+        UHD_LOG_TRACE("CRIMSON_EMU", "RX " << chan
+            << (rx.continuous ? " continuous" : " finite")
+            << ((inst & (INST_RELOAD | INST_CHAIN)) ? " chained" : "")
+            << " at " << rx.start_time.get_real_secs());
+    }
+
+    /*******************************************************************
+     * TX buffer model
+     ******************************************************************/
+    void start_tx_recv(const size_t chan)
+    {
+        tx_chan_t &tx = _tx_chans[chan];
+        tx.sock->async_receive_from(
+            asio::buffer(tx.buff), tx.sender,
+            boost::bind(&crimson_tng_emulator_impl::handle_tx, this, chan,
+                asio::placeholders::error, asio::placeholders::bytes_transferred));
+    }
+
+    void handle_tx(const size_t chan, const boost::system::error_code &error, const size_t len)
+    {
+        if (error == asio::error::operation_aborted) {
+            return;
+        }
+        if (not error) {
+            tx_chan_t &tx = _tx_chans[chan];
+            vrt::if_packet_info_t info;
+            info.num_packet_words32 = len / sizeof(uint32_t);
+            try {
+                vrt::if_hdr_unpack_be(&tx.buff.front(), info);
+                boost::mutex::scoped_lock lock(_mutex);
+                push_tx_samps(tx, info);
+            } catch (const uhd::value_error &ex) {
+                UHD_LOG_WARNING("CRIMSON_EMU", "Bad TX packet: " << ex.what());
+            }
+        }
+        start_tx_recv(chan);
+    }
+
+    //! Drain the buffer at the sample rate, up to the given time
+    void update_tx_level(tx_chan_t &tx, const time_spec_t &now)
+    {
+        const time_spec_t from = tx.start_time > tx.last_update ? tx.start_time : tx.last_update;
+        if (now > tx.last_update) {
+            tx.last_update = now;
+        }
+        if (now <= from or tx.level <= 0) {
+            return;
+        }
+        const double drained = (now - from).get_real_secs() * tx.rate;
+        if (drained < tx.level) {
+            tx.level -= drained;
+            return;
+        }
+        tx.level = 0;
+        // running empty is only an underflow in the middle of a burst
+        if (not tx.eob) {
+            tx.uflow++;
+        }
+    }
+
+    void push_tx_samps(tx_chan_t &tx, const vrt::if_packet_info_t &info)
+    {
+        const time_spec_t now = device_time();
+        update_tx_level(tx, now);
+        // a timestamp on the first packet into an empty buffer holds it
+        // back until that time
+        if (tx.level <= 0) {
+            tx.start_time = info.has_tsf ?
+                time_spec_t::from_ticks(info.tsf, TICK_RATE) : now;
+            tx.last_update = now;
+        }
+        tx.eob = info.eob;
+        const size_t nsamps = info.num_payload_words32;
+        if (tx.level + nsamps > _args.tx_buff_size) {
+            tx.oflow++;
+            tx.level = _args.tx_buff_size;
+        } else {
+            tx.level += nsamps;
+        }
+    }
+
+    /*******************************************************************
+     * RX generators
+     ******************************************************************/
+    void start_rx_timer(void)
+    {
+        _rx_timer.expires_from_now(RX_GEN_PERIOD);
+        _rx_timer.async_wait(boost::bind(
+            &crimson_tng_emulator_impl::handle_rx_timer, this, asio::placeholders::error));
+    }
+
+    void handle_rx_timer(const boost::system::error_code &error)
+    {
+        if (error == asio::error::operation_aborted) {
+            return;
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        const time_spec_t now = device_time();
+        for (size_t chan = 0; chan < _rx_chans.size(); chan++) {
+            generate_rx(chan, now);
+        }
+        lock.unlock();
+        start_rx_timer();
+    }
+
+    //! Send the samples that are due on a channel, call with _mutex held
+    void generate_rx(const size_t chan, const time_spec_t &now)
+    {
+        rx_chan_t &rx = _rx_chans[chan];
+        if (not rx.active or now < rx.start_time or rx.rate <= 0) {
+            return;
+        }
+
+        uint64_t due = uint64_t((now - rx.start_time).get_real_secs() * rx.rate);
+        if (not rx.continuous) {
+            due = std::min(due, rx.num_samps);
+        }
+        // a stalled host loop must not turn into an unbounded burst
+        const uint64_t max_backlog = uint64_t(RX_GEN_MAX_BACKLOG * rx.rate);
+        if (due > rx.sent + max_backlog) {
+            rx.sent = due - max_backlog;
+        }
+
+        asio::ip::udp::endpoint dest;
+        try {
+            const std::string prefix = chan_prefix("rx", chan);
+            dest = asio::ip::udp::endpoint(
+                asio::ip::address::from_string(get_prop_locked(prefix + "/link/ip_dest")),
+                boost::lexical_cast<uint16_t>(get_prop_locked(prefix + "/link/port")));
+        } catch (const std::exception &) {
+            return;
+        }
+
+        while (due > rx.sent) {
+            const uint64_t nsamps = std::min<uint64_t>(due - rx.sent, _args.rx_spp);
+            const bool last = not rx.continuous and rx.sent + nsamps == rx.num_samps;
+            // continuous streams only send full packets
+            if (nsamps < _args.rx_spp and not last) {
+                break;
+            }
+
+            vrt::if_packet_info_t info;
+            info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+            info.num_payload_words32 = nsamps;
+            info.num_payload_bytes = nsamps * sizeof(uint32_t);
+            info.packet_count = rx.seq++;
+            info.has_sid = false;
+            info.has_cid = false;
+            info.has_tsi = false;
+            info.has_tsf = true;
+            info.tsf = (rx.start_time + time_spec_t::from_ticks(rx.sent, rx.rate)).to_ticks(TICK_RATE);
+            info.has_tlr = false;
+            info.sob = rx.sent == 0;
+            info.eob = last;
+            vrt::if_hdr_pack_be(&_rx_buff.front(), info);
+
+            // a ramp in I and Q, so receivers can check for gaps
+            uint32_t *payload = &_rx_buff.front() + info.num_header_words32;
+            for (size_t i = 0; i < nsamps; i++) {
+                const uint16_t val = uint16_t(rx.samps_sent + i);
+                payload[i] = uhd::htonx<uint32_t>((uint32_t(val) << 16) | uint16_t(~val));
+            }
+
+            boost::system::error_code send_error;
+            _rx_sock.send_to(asio::buffer(&_rx_buff.front(),
+                info.num_packet_words32 * sizeof(uint32_t)), dest, 0, send_error);
+            rx.sent += nsamps;
+            rx.samps_sent += nsamps;
+            if (last) {
+                rx.active = false;
+            }
+        }
+    }
+
+    const args_t _args;
+
+    asio::io_service _io_service;
+    boost::thread _thread;
+    //! Protects all state that the public methods can touch
+    boost::mutex _mutex;
+
+    asio::ip::udp::socket _mgmt_sock;
+    asio::ip::udp::endpoint _mgmt_sender;
+    char _mgmt_buff[CRIMSON_TNG_FW_COMMS_MTU];
+
+    asio::ip::udp::socket _flow_sock;
+    asio::ip::udp::endpoint _flow_sender;
+    uint64_t _flow_buff[CRIMSON_TNG_FW_COMMS_MTU / sizeof(uint64_t)];
+
+    asio::ip::udp::socket _rx_sock;
+    asio::steady_timer _rx_timer;
+    std::vector<uint32_t> _rx_buff;
+
+    std::map<std::string, std::string> _props;
+    std::vector<tx_chan_t> _tx_chans;
+    std::vector<rx_chan_t> _rx_chans;
+
+    //! Device time = _dev_ref + (host time - _host_ref) * _clock_rate
+    time_spec_t _host_ref;
+    time_spec_t _dev_ref;
+    const double _clock_rate;
+
+    uint64_t _num_mgmt_requests;
+};
+
+/***********************************************************************
+ * Make
+ **********************************************************************/
+crimson_tng_emulator::sptr crimson_tng_emulator::make(const args_t &args)
+{
+    return sptr(new crimson_tng_emulator_impl(args));
+}
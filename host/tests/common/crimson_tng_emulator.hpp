@@ -0,0 +1,108 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_CRIMSON_TNG_EMULATOR_HPP
+#define INCLUDED_CRIMSON_TNG_EMULATOR_HPP
+
+#include <uhd/types/time_spec.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <string>
+
+/*! Software model of a Crimson TNG unit on the loopback interface
+ *
+ * The emulator speaks the protocols that crimson_tng_impl uses to talk to
+ * a real unit, so the driver, the flow control loop and the clock sync can
+ * be exercised without hardware:
+ *
+ * - ASCII get/set requests on the management port
+ *   ("<seq>,get,<path>" and "<seq>,set,<path>,<value>"), answered from a
+ *   property store.
+ * - Time diff, FIFO level and RX stream command packets on the flow
+ *   control port, answered from a simulated device clock which may be
+ *   offset from, and drift against, the host clock.
+ * - VITA-49 TX data on one port per TX channel, which fills a sample buffer
+ *   that drains at the channel's sample rate, counting underflows and
+ *   overflows.
+ * - VITA-49 RX data, generated at the channel's sample rate after an RX
+ *   stream command and sent to the channel's link destination.
+ *
+ * All sockets are served by one thread which is started by make() and
+ * stopped by the destructor.
+ */
+class crimson_tng_emulator : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<crimson_tng_emulator> sptr;
+
+    struct args_t
+    {
+        args_t();
+
+        //! Address all sockets bind to
+        std::string addr;
+        //! Management port, CRIMSON_TNG_FW_COMMS_UDP_PORT by default. Use 0
+        //  to bind to any free port.
+        uint16_t mgmt_port;
+        //! Flow control port, CRIMSON_TNG_FLOW_CNTRL_UDP_PORT by default
+        uint16_t flow_port;
+        //! TX data port of channel 0, channel N uses tx_port + N. With 0,
+        //  each channel binds to any free port.
+        uint16_t tx_port;
+        //! Default RX destination port of channel 0, channel N uses
+        //  rx_port + N
+        uint16_t rx_port;
+        //! Device time minus host time at startup, in seconds
+        double clock_offset;
+        //! Device clock rate error against the host clock, in ppm
+        double clock_drift_ppm;
+        //! Depth of each TX sample buffer, in samples
+        size_t tx_buff_size;
+        //! Samples per generated RX packet
+        size_t rx_spp;
+    };
+
+    virtual ~crimson_tng_emulator(void) {}
+
+    //! Create an emulator and start serving its sockets
+    static sptr make(const args_t &args = args_t());
+
+    //! Get the port the management socket is bound to
+    virtual uint16_t get_mgmt_port(void) = 0;
+
+    //! Get the port the flow control socket is bound to
+    virtual uint16_t get_flow_port(void) = 0;
+
+    //! Get the port the TX data socket of a channel is bound to
+    virtual uint16_t get_tx_port(const size_t chan) = 0;
+
+    //! Read a value from the property store, as a get request would
+    virtual std::string get_prop(const std::string &path) = 0;
+
+    //! Write a value to the property store, as a set request would
+    virtual void set_prop(const std::string &path, const std::string &value) = 0;
+
+    //! Get the current time of the simulated device clock
+    virtual uhd::time_spec_t get_time_now(void) = 0;
+
+    //! Get the number of samples in the TX buffer of a channel
+    virtual size_t get_tx_level(const size_t chan) = 0;
+
+    //! Get the number of times the TX buffer of a channel ran empty
+    virtual uint64_t get_tx_underflows(const size_t chan) = 0;
+
+    //! Get the number of times the TX buffer of a channel overflowed
+    virtual uint64_t get_tx_overflows(const size_t chan) = 0;
+
+    //! Get the number of samples generated on an RX channel
+    virtual uint64_t get_rx_samps_sent(const size_t chan) = 0;
+
+    //! Get the number of management requests served
+    virtual uint64_t get_num_mgmt_requests(void) = 0;
+};
+
+#endif /* INCLUDED_CRIMSON_TNG_EMULATOR_HPP */
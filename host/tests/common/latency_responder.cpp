@@ -0,0 +1,191 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "latency_responder.hpp"
+#include <uhd/exception.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    void add_sample(uhd::duration_histogram_t &hist, const uint64_t ns)
+    {
+        hist.count++;
+        hist.total_ns += ns;
+        hist.max_ns = std::max(hist.max_ns, ns);
+        hist.buckets[uhd::duration_histogram_t::get_bucket(ns)]++;
+    }
+
+    //! Time a stage spent between two snapshots of its histogram
+    uint64_t delta_ns(
+        const uhd::duration_histogram_t &before,
+        const uhd::duration_histogram_t &after
+    ){
+        return after.total_ns - before.total_ns;
+    }
+
+    uint64_t sub_ns(const uint64_t a, const uint64_t b)
+    {
+        return (a > b) ? a - b : 0;
+    }
+
+    std::string stage_line(const std::string &name, const uhd::duration_histogram_t &hist)
+    {
+        return str(boost::format("  %-14s mean %9.1f us, p50 %9.1f us, p99 %9.1f us, max %9.1f us\n")
+            % name
+            % (hist.get_mean_ns() / 1e3)
+            % (hist.get_percentile_ns(50.0) / 1e3)
+            % (hist.get_percentile_ns(99.0) / 1e3)
+            % (hist.max_ns / 1e3));
+    }
+}
+
+std::string latency_responder::results_t::to_pp_string(void) const
+{
+    std::ostringstream ss;
+    ss << boost::format(
+        "Iterations: %u, RX errors: %u, late: %u, ACKs: %u, underflows: %u, other: %u\n")
+        % iterations % rx_errors % late % acks % underflows % other;
+    ss << stage_line("Turnaround", turnaround);
+    ss << stage_line("RX call", stages.rx_call);
+    ss << stage_line("RX convert", stages.rx_convert);
+    ss << stage_line("RX xport", stages.rx_xport);
+    ss << stage_line("RX handler", stages.rx_handler);
+    ss << stage_line("TX call", stages.tx_call);
+    ss << stage_line("TX convert", stages.tx_convert);
+    ss << stage_line("TX xport", stages.tx_xport);
+    ss << stage_line("TX fc wait", stages.tx_fc_wait);
+    ss << stage_line("TX handler", stages.tx_handler);
+    return ss.str();
+}
+
+latency_responder::latency_responder(
+    uhd::rx_streamer::sptr rx_stream,
+    uhd::tx_streamer::sptr tx_stream,
+    const time_now_type &get_time_now
+):
+    _rx_stream(rx_stream),
+    _tx_stream(tx_stream),
+    _get_time_now(get_time_now)
+{
+    UHD_ASSERT_THROW(_rx_stream and _tx_stream and _get_time_now);
+}
+
+latency_responder::results_t latency_responder::run(const options_t &options)
+{
+    if (options.nsamps == 0) {
+        throw uhd::value_error("latency_responder: nsamps must not be 0");
+    }
+
+    results_t results = results_t();
+    // large enough for a block in any CPU format
+    std::vector<std::complex<double>> buffer(options.nsamps);
+    const double block_secs = (options.rate > 0.0) ? options.nsamps / options.rate : 0.0;
+
+    for (size_t i = 0; i < options.iterations; i++) {
+        const uhd::stream_stats_t rx_before = _rx_stream->get_stats();
+        const uhd::stream_stats_t tx_before = _tx_stream->get_stats();
+
+        /***************************************************************
+         * Receive a block at a time in the near future
+         **************************************************************/
+        uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
+        stream_cmd.num_samps = options.nsamps;
+        stream_cmd.stream_now = false;
+        stream_cmd.time_spec = _get_time_now() + uhd::time_spec_t(options.rx_lead);
+        _rx_stream->issue_stream_cmd(stream_cmd);
+
+        uhd::rx_metadata_t rx_md;
+        uhd::time_spec_t rx_time;
+        size_t num_rx_samps = 0;
+        double timeout = options.rx_lead + block_secs + options.timeout;
+        while (num_rx_samps < options.nsamps) {
+            char *buff = reinterpret_cast<char *>(&buffer.front());
+            const size_t n = _rx_stream->recv(
+                buff, options.nsamps - num_rx_samps, rx_md, timeout, true);
+            if (rx_md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) break;
+            if (num_rx_samps == 0) rx_time = rx_md.time_spec;
+            num_rx_samps += n;
+            timeout = options.timeout;
+        }
+        if (num_rx_samps < options.nsamps) {
+            results.rx_errors++;
+            continue;
+        }
+        const auto rx_done = std::chrono::steady_clock::now();
+
+        /***************************************************************
+         * Respond with a burst at a delay after the received block
+         **************************************************************/
+        uhd::tx_metadata_t tx_md;
+        tx_md.start_of_burst = true;
+        tx_md.end_of_burst = true;
+        tx_md.has_time_spec = true;
+        tx_md.time_spec = rx_time + uhd::time_spec_t(options.delay);
+        const size_t num_tx_samps = _tx_stream->send(
+            &buffer.front(), options.nsamps, tx_md, options.timeout);
+        add_sample(results.turnaround, uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - rx_done).count()));
+        results.iterations++;
+        if (num_tx_samps < options.nsamps) results.other++;
+
+        /***************************************************************
+         * Check the async messages of the burst
+         **************************************************************/
+        bool late = false;
+        uhd::async_metadata_t async_md;
+        double async_timeout = options.async_timeout;
+        while (_tx_stream->recv_async_msg(async_md, async_timeout)) {
+            async_timeout = 0.0;
+            switch (async_md.event_code) {
+            case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+                late = true;
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_BURST_ACK:
+                results.acks++;
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
+                results.underflows++;
+                break;
+            default:
+                results.other++;
+                break;
+            }
+        }
+
+        /***************************************************************
+         * Attribute the host time of the iteration to the stages
+         **************************************************************/
+        const uhd::stream_stats_t rx_after = _rx_stream->get_stats();
+        const uhd::stream_stats_t tx_after = _tx_stream->get_stats();
+        // devices without time errors still let the streamer tell late bursts
+        if (tx_after.late > tx_before.late) late = true;
+        if (late) results.late++;
+
+        stage_times_t &stages = results.stages;
+        const uint64_t rx_call = delta_ns(rx_before.call_time, rx_after.call_time);
+        const uint64_t rx_convert = delta_ns(rx_before.convert_time, rx_after.convert_time);
+        const uint64_t rx_xport = delta_ns(rx_before.xport_time, rx_after.xport_time);
+        add_sample(stages.rx_call, rx_call);
+        add_sample(stages.rx_convert, rx_convert);
+        add_sample(stages.rx_xport, rx_xport);
+        add_sample(stages.rx_handler, sub_ns(rx_call, rx_convert + rx_xport));
+
+        const uint64_t tx_call = delta_ns(tx_before.call_time, tx_after.call_time);
+        const uint64_t tx_convert = delta_ns(tx_before.convert_time, tx_after.convert_time);
+        const uint64_t tx_xport = delta_ns(tx_before.xport_time, tx_after.xport_time);
+        const uint64_t tx_fc_wait = delta_ns(tx_before.fc_wait_time, tx_after.fc_wait_time);
+        add_sample(stages.tx_call, tx_call);
+        add_sample(stages.tx_convert, tx_convert);
+        add_sample(stages.tx_xport, tx_xport);
+        add_sample(stages.tx_fc_wait, tx_fc_wait);
+        add_sample(stages.tx_handler, sub_ns(tx_call, tx_convert + tx_xport + tx_fc_wait));
+    }
+    return results;
+}
@@ -0,0 +1,113 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LATENCY_RESPONDER_HPP
+#define INCLUDED_LATENCY_RESPONDER_HPP
+
+#include <uhd/stream.hpp>
+#include <uhd/types/stream_stats.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <boost/noncopyable.hpp>
+#include <functional>
+#include <string>
+
+/*!
+ * Measures the round trip of timed RX and TX through the streamers.
+ *
+ * This is the loop of the latency test and the Responder utility, without
+ * a terminal UI: each iteration receives a block of samples at a given time,
+ * and sends a burst at the receive time plus a delay. If the delay is too
+ * short, the burst comes too late to the device.
+ *
+ * Besides counting late bursts, the responder records the host-side time
+ * each iteration spent in the stages of the streamers, taken from their
+ * counters (see uhd::stream_stats_t). Run against mock streamers with a
+ * deterministic clock, the counts do not depend on how fast the host is,
+ * and the stage times can be compared across builds.
+ */
+class latency_responder : boost::noncopyable
+{
+public:
+    typedef std::function<uhd::time_spec_t(void)> time_now_type;
+
+    struct options_t
+    {
+        options_t(void):
+            rate(25e6), nsamps(100), delay(0.001), iterations(1000),
+            rx_lead(0.01), timeout(1.0), async_timeout(0.1)
+        {}
+
+        //! The sample rate of the streamers, for the duration of a block
+        double rate;
+        //! Samples received and sent per iteration
+        size_t nsamps;
+        //! Time from the receive time of a block to the send time of the
+        //! response, in seconds (the rtt of the latency test)
+        double delay;
+        size_t iterations;
+        //! Time from issuing the stream command to the receive time
+        double rx_lead;
+        //! Timeout of the recv() and send() calls
+        double timeout;
+        //! Time to wait for the async message of each burst
+        double async_timeout;
+    };
+
+    //! Host time per iteration spent in a stage of the streamers
+    struct stage_times_t
+    {
+        uhd::duration_histogram_t rx_call;
+        uhd::duration_histogram_t rx_convert;
+        uhd::duration_histogram_t rx_xport;
+        //! recv() calls less the converter and the transport
+        uhd::duration_histogram_t rx_handler;
+        uhd::duration_histogram_t tx_call;
+        uhd::duration_histogram_t tx_convert;
+        uhd::duration_histogram_t tx_xport;
+        uhd::duration_histogram_t tx_fc_wait;
+        //! send() calls less the converter, the transport and flow control
+        uhd::duration_histogram_t tx_handler;
+    };
+
+    struct results_t
+    {
+        size_t iterations;
+        //! Blocks not received in full
+        size_t rx_errors;
+        //! Bursts which came too late, from the streamer or a time error
+        size_t late;
+        size_t acks;
+        size_t underflows;
+        //! Other async messages, and bursts not sent in full
+        size_t other;
+        //! Host time from the return of recv() to the return of send()
+        uhd::duration_histogram_t turnaround;
+        stage_times_t stages;
+
+        std::string to_pp_string(void) const;
+    };
+
+    /*!
+     * \param rx_stream the streamer to receive the blocks from
+     * \param tx_stream the streamer to send the responses to
+     * \param get_time_now gets the device time of the streamers
+     */
+    latency_responder(
+        uhd::rx_streamer::sptr rx_stream,
+        uhd::tx_streamer::sptr tx_stream,
+        const time_now_type &get_time_now
+    );
+
+    //! Run the iterations and return the results
+    results_t run(const options_t &options);
+
+private:
+    uhd::rx_streamer::sptr _rx_stream;
+    uhd::tx_streamer::sptr _tx_stream;
+    const time_now_type _get_time_now;
+};
+
+#endif /* INCLUDED_LATENCY_RESPONDER_HPP */
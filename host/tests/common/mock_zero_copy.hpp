@@ -94,7 +94,8 @@ class mock_zero_copy : public uhd::transport::zero_copy_if {
 
     template <uhd::endianness_t endianness = uhd::ENDIANNESS_BIG>
     void pop_send_packet(
-        uhd::transport::vrt::if_packet_info_t &ifpi
+        uhd::transport::vrt::if_packet_info_t &ifpi,
+        std::vector<uint32_t> *payload = NULL
     );
 
     private:
@@ -171,7 +172,8 @@ void mock_zero_copy::push_back_inline_message_packet(
 
 template <uhd::endianness_t endianness>
 void mock_zero_copy::pop_send_packet(
-    uhd::transport::vrt::if_packet_info_t &ifpi
+    uhd::transport::vrt::if_packet_info_t &ifpi,
+    std::vector<uint32_t> *payload
 ) {
     using namespace uhd::transport;
 
@@ -195,6 +197,10 @@ void mock_zero_copy::pop_send_packet(
             uhd::transport::vrt::if_hdr_unpack_le(tx_buff_ptr, ifpi);
         }
     }
+    if (payload) {
+        const uint32_t *payload_ptr = tx_buff_ptr + ifpi.num_header_words32;
+        payload->assign(payload_ptr, payload_ptr + ifpi.num_payload_words32);
+    }
     _tx_mems.pop_front();
     _tx_lens.pop_front();
 }
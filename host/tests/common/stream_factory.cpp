@@ -0,0 +1,535 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "stream_factory.hpp"
+#include "../../lib/transport/super_recv_packet_handler.hpp"
+#include "../../lib/transport/super_send_packet_handler.hpp"
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/bounded_buffer.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+using namespace uhd::transport;
+
+namespace {
+    //! Frame size of the mock transports, in bytes
+    constexpr size_t MOCK_FRAME_SIZE = 8000;
+    //! Number of frames each mock transport cycles through
+    constexpr size_t MOCK_NUM_FRAMES = 8;
+    //! Packets a mock RX source buffers before it drops data
+    constexpr size_t MOCK_RX_BUFF_PACKETS = 64;
+    //! Packets a mock TX sink buffers before it applies back pressure
+    constexpr size_t MOCK_TX_BUFF_PACKETS = 32;
+    //! Tick rate of the mock transports when they are not paced
+    constexpr double MOCK_UNPACED_RATE = 1e6;
+    //! Depth of the async message queue of a mock TX streamer
+    constexpr size_t MOCK_ASYNC_QUEUE_SIZE = 1000;
+}
+
+/***********************************************************************
+ * Mock device clock
+ **********************************************************************/
+class mock_clock : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<mock_clock> sptr;
+
+    mock_clock(const bool deterministic):
+        _deterministic(deterministic),
+        _epoch(std::chrono::steady_clock::now()),
+        _virtual_now(0.0)
+    {}
+
+    //! Get the device time in seconds
+    double now(void)
+    {
+        if (not _deterministic) {
+            return std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - _epoch).count();
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _virtual_now;
+    }
+
+    //! Wait until a device time
+    void wait_until(const double time)
+    {
+        if (not _deterministic) {
+            const double left = time - now();
+            if (left > 0.0) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(left));
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _virtual_now = std::max(_virtual_now, time);
+    }
+
+    //! Wait for a duration in seconds
+    void wait(const double secs)
+    {
+        wait_until(now() + secs);
+    }
+
+private:
+    const bool _deterministic;
+    const std::chrono::steady_clock::time_point _epoch;
+    std::mutex _mutex;
+    double _virtual_now;
+};
+
+/***********************************************************************
+ * Mock transports
+ **********************************************************************/
+class mock_frame : public managed_recv_buffer
+{
+public:
+    void release(void) { /* NOP */ }
+
+    sptr get_new(void *mem, const size_t len)
+    {
+        return make(this, mem, len);
+    }
+};
+
+class mock_rx_source
+{
+public:
+    typedef boost::shared_ptr<mock_rx_source> sptr;
+
+    mock_rx_source(
+        mock_clock::sptr clock,
+        const double rate,
+        const double tick_rate,
+        const size_t spp,
+        const size_t bytes_per_item
+    ):
+        _clock(clock),
+        _rate(rate),
+        _tick_rate(tick_rate),
+        _spp(spp),
+        _bytes_per_item(bytes_per_item),
+        _mem(MOCK_NUM_FRAMES * MOCK_FRAME_SIZE, 0),
+        _frames(MOCK_NUM_FRAMES),
+        _streaming(false),
+        _start(0.0),
+        _first_tick(0),
+        _num_samps(0),
+        _eob_at_end(false),
+        _sent(0),
+        _seq(0),
+        _next_frame(0)
+    {
+        UHD_ASSERT_THROW(
+            _spp * _bytes_per_item + vrt::max_if_hdr_words32 * sizeof(uint32_t)
+            <= MOCK_FRAME_SIZE);
+    }
+
+    void issue_stream_cmd(const uhd::stream_cmd_t &cmd)
+    {
+        switch (cmd.stream_mode) {
+        case uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS:
+            _streaming = false;
+            return;
+        case uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS:
+            _num_samps = 0;
+            _eob_at_end = false;
+            break;
+        case uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE:
+            _num_samps = cmd.num_samps;
+            _eob_at_end = true;
+            break;
+        case uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_MORE:
+            _num_samps = cmd.num_samps;
+            _eob_at_end = false;
+            break;
+        }
+        _start = cmd.stream_now ? _clock->now() : cmd.time_spec.get_real_secs();
+        _first_tick = uint64_t(std::llround(_start * _tick_rate));
+        _sent = 0;
+        _streaming = _num_samps != 0
+            or cmd.stream_mode == uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS;
+    }
+
+    managed_recv_buffer::sptr get_recv_buff(const double timeout)
+    {
+        if (not _streaming) {
+            _clock->wait(timeout);
+            return managed_recv_buffer::sptr();
+        }
+
+        const size_t nsamps = (_num_samps == 0)
+            ? _spp : size_t(std::min<uint64_t>(_spp, _num_samps - _sent));
+        const bool last = (_num_samps != 0) and (_sent + nsamps == _num_samps);
+
+        // a packet is due once its last sample has been sampled
+        const double now = _clock->now();
+        const double due = _start + ((_rate > 0.0) ? (_sent + nsamps) / _rate : 0.0);
+        if (due > now + timeout) {
+            _clock->wait(timeout);
+            return managed_recv_buffer::sptr();
+        }
+        if (due > now) {
+            _clock->wait_until(due);
+        }
+        // the buffer of a real device overflows when the host falls
+        // behind, which shows up as a gap in the sequence numbers
+        const uint64_t behind = (_rate > 0.0 and _num_samps == 0)
+            ? uint64_t(std::max(0.0, now - due) * _rate / _spp) : 0;
+        if (behind > MOCK_RX_BUFF_PACKETS) {
+            _sent += behind * _spp;
+            _seq += behind;
+        }
+
+        vrt::if_packet_info_t ifpi;
+        ifpi.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+        ifpi.num_payload_bytes = nsamps * _bytes_per_item;
+        ifpi.num_payload_words32 = (ifpi.num_payload_bytes + 3) / sizeof(uint32_t);
+        ifpi.packet_count = _seq;
+        ifpi.sob = false;
+        ifpi.eob = last and _eob_at_end;
+        ifpi.has_sid = false;
+        ifpi.has_cid = false;
+        ifpi.has_tsi = false;
+        ifpi.has_tsf = true;
+        ifpi.tsf = _first_tick + _sent;
+        ifpi.has_tlr = false;
+
+        const size_t frame = _next_frame++ % MOCK_NUM_FRAMES;
+        uint8_t *mem = &_mem[frame * MOCK_FRAME_SIZE];
+        vrt::if_hdr_pack_be(reinterpret_cast<uint32_t *>(mem), ifpi);
+        _sent += nsamps;
+        _seq++;
+        if (last) {
+            _streaming = false;
+        }
+        return _frames[frame].get_new(mem, ifpi.num_packet_words32 * sizeof(uint32_t));
+    }
+
+private:
+    mock_clock::sptr _clock;
+    const double _rate;
+    const double _tick_rate;
+    const size_t _spp;
+    const size_t _bytes_per_item;
+    std::vector<uint8_t> _mem;
+    std::vector<mock_frame> _frames;
+    std::atomic<bool> _streaming;
+    double _start;
+    uint64_t _first_tick;
+    //! Samples to send for the current command, 0 for no limit
+    uint64_t _num_samps;
+    bool _eob_at_end;
+    uint64_t _sent;
+    uint64_t _seq;
+    size_t _next_frame;
+};
+
+class mock_tx_sink
+{
+public:
+    typedef boost::shared_ptr<mock_tx_sink> sptr;
+    typedef bounded_buffer<uhd::async_metadata_t> async_queue_type;
+
+    mock_tx_sink(
+        mock_clock::sptr clock,
+        const double rate,
+        const double tick_rate,
+        const size_t spp,
+        const size_t bytes_per_item,
+        const size_t chan,
+        boost::shared_ptr<async_queue_type> async_queue
+    ):
+        _clock(clock),
+        _rate(rate),
+        _tick_rate(tick_rate),
+        _capacity(double(spp * MOCK_TX_BUFF_PACKETS)),
+        _bytes_per_item(bytes_per_item),
+        _chan(chan),
+        _async_queue(async_queue),
+        _mem(MOCK_FRAME_SIZE),
+        _started(false),
+        _late(false),
+        _start(0.0),
+        _pushed(0.0)
+    {
+        _frame._sink = this;
+    }
+
+    managed_send_buffer::sptr get_send_buff(const double timeout)
+    {
+        // back pressure: wait until the buffer has room for a packet
+        if (_started) {
+            const double excess = get_level() + _capacity / MOCK_TX_BUFF_PACKETS - _capacity;
+            // the buffer does not drain before the burst starts
+            const double wait = (excess > 0.0)
+                ? std::max(0.0, _start - _clock->now())
+                    + ((_rate > 0.0) ? excess / _rate : 0.0)
+                : 0.0;
+            if (wait > timeout) {
+                _clock->wait(timeout);
+                return managed_send_buffer::sptr();
+            }
+            if (wait > 0.0) {
+                _clock->wait(wait);
+            }
+        }
+        return _frame.get_new(&_mem.front(), _mem.size());
+    }
+
+private:
+    //! Samples in the buffer that the device has not played yet
+    double get_level(void)
+    {
+        const double elapsed = _clock->now() - _start;
+        if (elapsed < 0.0) return _pushed;
+        // unpaced, the device plays out whatever it gets
+        if (_rate <= 0.0) return 0.0;
+        return _pushed - elapsed * _rate;
+    }
+
+    void push_async_msg(const uhd::async_metadata_t::event_code_t event_code)
+    {
+        uhd::async_metadata_t md;
+        md.channel = _chan;
+        md.has_time_spec = false;
+        md.event_code = event_code;
+        _async_queue->push_with_pop_on_full(md);
+    }
+
+    //! Consume a committed packet
+    void consume(const size_t len)
+    {
+        vrt::if_packet_info_t ifpi;
+        ifpi.num_packet_words32 = len / sizeof(uint32_t);
+        vrt::if_hdr_unpack_be(_frame.cast<const uint32_t *>(), ifpi);
+
+        if (not _started) {
+            // a timed burst waits in the buffer until its time, and a real
+            // device drops a burst whose time has passed
+            const double now = _clock->now();
+            _start = ifpi.has_tsf ? ifpi.tsf / _tick_rate : now;
+            _late = ifpi.has_tsf and _start < now;
+            _pushed = 0.0;
+            _started = true;
+            if (_late) {
+                push_async_msg(uhd::async_metadata_t::EVENT_CODE_TIME_ERROR);
+            }
+        }
+        else if (not _late and _rate > 0.0 and get_level() < 0.0) {
+            push_async_msg(uhd::async_metadata_t::EVENT_CODE_UNDERFLOW);
+            // the device starts playing again with this packet
+            _pushed = std::max(0.0, _clock->now() - _start) * _rate;
+        }
+        if (not _late) {
+            _pushed += double(ifpi.num_payload_bytes) / _bytes_per_item;
+        }
+        if (ifpi.eob) {
+            if (not _late) {
+                push_async_msg(uhd::async_metadata_t::EVENT_CODE_BURST_ACK);
+            }
+            _started = false;
+        }
+    }
+
+    class frame_type : public managed_send_buffer
+    {
+    public:
+        void release(void)
+        {
+            _sink->consume(size());
+        }
+
+        sptr get_new(void *mem, const size_t len)
+        {
+            return make(this, mem, len);
+        }
+
+        mock_tx_sink *_sink;
+    };
+
+    mock_clock::sptr _clock;
+    const double _rate;
+    const double _tick_rate;
+    const double _capacity;
+    const size_t _bytes_per_item;
+    const size_t _chan;
+    boost::shared_ptr<async_queue_type> _async_queue;
+    std::vector<uint8_t> _mem;
+    frame_type _frame;
+    bool _started;
+    //! The current burst came too late and is dropped
+    bool _late;
+    double _start;
+    double _pushed;
+};
+
+/***********************************************************************
+ * Stream factories
+ **********************************************************************/
+class device_stream_factory : public stream_factory
+{
+public:
+    device_stream_factory(uhd::usrp::multi_usrp::sptr usrp): _usrp(usrp)
+    {
+        _usrp->set_time_now(uhd::time_spec_t(0.0));
+    }
+
+    double set_rx_rate(const double rate, const std::vector<size_t> &chans)
+    {
+        for (const size_t chan : chans) _usrp->set_rx_rate(rate, chan);
+        return chans.empty() ? rate : _usrp->get_rx_rate(chans.front());
+    }
+
+    double set_tx_rate(const double rate, const std::vector<size_t> &chans)
+    {
+        for (const size_t chan : chans) _usrp->set_tx_rate(rate, chan);
+        return chans.empty() ? rate : _usrp->get_tx_rate(chans.front());
+    }
+
+    uhd::rx_streamer::sptr get_rx_stream(const uhd::stream_args_t &args)
+    {
+        return _usrp->get_rx_stream(args);
+    }
+
+    uhd::tx_streamer::sptr get_tx_stream(const uhd::stream_args_t &args)
+    {
+        return _usrp->get_tx_stream(args);
+    }
+
+    uhd::time_spec_t get_time_now(void)
+    {
+        return _usrp->get_time_now();
+    }
+
+private:
+    uhd::usrp::multi_usrp::sptr _usrp;
+};
+
+class mock_stream_factory : public stream_factory
+{
+public:
+    mock_stream_factory(const bool deterministic):
+        _clock(boost::make_shared<mock_clock>(deterministic)),
+        _rx_rate(0.0),
+        _tx_rate(0.0)
+    {}
+
+    double set_rx_rate(const double rate, const std::vector<size_t> &)
+    {
+        return _rx_rate = rate;
+    }
+
+    double set_tx_rate(const double rate, const std::vector<size_t> &)
+    {
+        return _tx_rate = rate;
+    }
+
+    uhd::rx_streamer::sptr get_rx_stream(const uhd::stream_args_t &args)
+    {
+        const size_t bytes_per_item = uhd::convert::get_bytes_per_item(args.otw_format);
+        const size_t spp = get_spp(args, bytes_per_item);
+        auto streamer = boost::make_shared<sph::recv_packet_streamer>(spp);
+        streamer->resize(args.channels.size());
+        streamer->set_vrt_unpacker(&vrt::if_hdr_unpack_be);
+        streamer->set_no_alloc(uhd::no_alloc::is_enabled(args));
+        streamer->set_tick_rate(get_tick_rate(_rx_rate));
+        streamer->set_samp_rate(get_tick_rate(_rx_rate));
+        for (size_t i = 0; i < args.channels.size(); i++) {
+            auto source = boost::make_shared<mock_rx_source>(
+                _clock, _rx_rate, get_tick_rate(_rx_rate), spp, bytes_per_item);
+            streamer->set_xport_chan_get_buff(i, [source](double timeout){
+                return source->get_recv_buff(timeout);
+            });
+            streamer->set_issue_stream_cmd(i, [source](const uhd::stream_cmd_t &cmd){
+                source->issue_stream_cmd(cmd);
+            });
+        }
+        uhd::convert::id_type id;
+        id.input_format = args.otw_format + "_item32_be";
+        id.num_inputs = 1;
+        id.output_format = args.cpu_format;
+        id.num_outputs = 1;
+        streamer->set_converter(id);
+        return streamer;
+    }
+
+    uhd::tx_streamer::sptr get_tx_stream(const uhd::stream_args_t &args)
+    {
+        const size_t bytes_per_item = uhd::convert::get_bytes_per_item(args.otw_format);
+        const size_t spp = get_spp(args, bytes_per_item);
+        auto streamer = boost::make_shared<sph::send_packet_streamer>(spp);
+        streamer->resize(args.channels.size());
+        streamer->set_vrt_packer(&vrt::if_hdr_pack_be);
+        streamer->set_enable_trailer(false);
+        streamer->set_no_alloc(uhd::no_alloc::is_enabled(args));
+        streamer->set_tick_rate(get_tick_rate(_tx_rate));
+        streamer->set_samp_rate(get_tick_rate(_tx_rate));
+        auto async_queue =
+            boost::make_shared<mock_tx_sink::async_queue_type>(MOCK_ASYNC_QUEUE_SIZE);
+        for (size_t i = 0; i < args.channels.size(); i++) {
+            auto sink = boost::make_shared<mock_tx_sink>(_clock, _tx_rate,
+                get_tick_rate(_tx_rate), spp, bytes_per_item, args.channels[i], async_queue);
+            streamer->set_xport_chan_get_buff(i, [sink](double timeout){
+                return sink->get_send_buff(timeout);
+            });
+        }
+        mock_clock::sptr clock = _clock;
+        streamer->set_time_source([clock](){
+            return uhd::time_spec_t(clock->now());
+        });
+        streamer->set_async_receiver(
+            [async_queue](uhd::async_metadata_t &md, const double timeout){
+                return async_queue->pop_with_timed_wait(md, timeout);
+            });
+        uhd::convert::id_type id;
+        id.input_format = args.cpu_format;
+        id.num_inputs = 1;
+        id.output_format = args.otw_format + "_item32_be";
+        id.num_outputs = 1;
+        streamer->set_converter(id);
+        return streamer;
+    }
+
+    uhd::time_spec_t get_time_now(void)
+    {
+        return uhd::time_spec_t(_clock->now());
+    }
+
+private:
+    static double get_tick_rate(const double rate)
+    {
+        return rate > 0.0 ? rate : MOCK_UNPACED_RATE;
+    }
+
+    static size_t get_spp(const uhd::stream_args_t &args, const size_t bytes_per_item)
+    {
+        const size_t max_spp =
+            (MOCK_FRAME_SIZE - vrt::max_if_hdr_words32 * sizeof(uint32_t)) / bytes_per_item;
+        const size_t spp = args.args.cast<size_t>("spp", max_spp);
+        return (spp == 0) ? max_spp : std::min(spp, max_spp);
+    }
+
+    mock_clock::sptr _clock;
+    double _rx_rate;
+    double _tx_rate;
+};
+
+stream_factory::sptr stream_factory::make_device(uhd::usrp::multi_usrp::sptr usrp)
+{
+    return boost::make_shared<device_stream_factory>(usrp);
+}
+
+stream_factory::sptr stream_factory::make_mock(const bool deterministic)
+{
+    return boost::make_shared<mock_stream_factory>(deterministic);
+}
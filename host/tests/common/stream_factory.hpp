@@ -0,0 +1,71 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_STREAM_FACTORY_HPP
+#define INCLUDED_STREAM_FACTORY_HPP
+
+#include <uhd/stream.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+/*! Source of RX and TX streamers for benchmarks and latency tests
+ *
+ * A factory hides whether the streamers come from a device (which may be an
+ * emulator on the loopback interface) or from in-memory mock transports, and
+ * gives access to the device time the streamers run on.
+ */
+class stream_factory : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<stream_factory> sptr;
+
+    virtual ~stream_factory(void) {}
+
+    //! Set the rate of the channels, and return the actual rate
+    virtual double set_rx_rate(const double rate, const std::vector<size_t> &chans) = 0;
+
+    //! Set the rate of the channels, and return the actual rate
+    virtual double set_tx_rate(const double rate, const std::vector<size_t> &chans) = 0;
+
+    virtual uhd::rx_streamer::sptr get_rx_stream(const uhd::stream_args_t &args) = 0;
+
+    virtual uhd::tx_streamer::sptr get_tx_stream(const uhd::stream_args_t &args) = 0;
+
+    //! Get the current device time
+    virtual uhd::time_spec_t get_time_now(void) = 0;
+
+    //! Make a factory for the streamers of a device, and reset its time to 0
+    static sptr make_device(uhd::usrp::multi_usrp::sptr usrp);
+
+    /*!
+     * Make a factory for streamers on in-memory mock transports.
+     *
+     * An RX source generates VRT packets (zero payload) at the sample rate,
+     * and a TX sink consumes them at the sample rate. Neither touches a
+     * socket, so a run measures the streamer and the converters alone. With
+     * a rate of 0, they run as fast as the streamer can go.
+     *
+     * The sources honor timed and num-samps stream commands, the sinks
+     * honor the time of bursts and report late bursts (time errors), ACKs
+     * and underflows as async messages.
+     *
+     * The device clock of the mock transports starts at 0. By default it
+     * follows the host clock. A deterministic clock only moves when a mock
+     * transport waits for it: where the host would sleep until a packet is
+     * due, the clock jumps ahead instead. Device times and time errors then
+     * depend on the sequence of calls alone, not on how fast the host is.
+     * This is meant for a single streaming thread; with several threads,
+     * the clock jumps to the furthest time any of them waits for.
+     *
+     * \param deterministic true for a clock which only moves on waits
+     */
+    static sptr make_mock(const bool deterministic = false);
+};
+
+#endif /* INCLUDED_STREAM_FACTORY_HPP */
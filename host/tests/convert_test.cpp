@@ -6,6 +6,7 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
 #include <boost/test/unit_test.hpp>
 #include <stdint.h>
 #include <complex>
@@ -630,3 +631,52 @@ BOOST_AUTO_TEST_CASE(test_convert_types_f32_and_f32){
         test_convert_types_f32(nsamps, id);
     }
 }
+
+/***********************************************************************
+ * Test the converter registry
+ **********************************************************************/
+static int last_made_prio = -1;
+
+static convert::converter::sptr make_dummy_converter(const int prio){
+    last_made_prio = prio;
+    return convert::converter::sptr();
+}
+
+BOOST_AUTO_TEST_CASE(test_convert_registry_lookup){
+    convert::id_type id;
+    id.input_format = "dummy_in";
+    id.num_inputs = 1;
+    id.output_format = "dummy_out";
+    id.num_outputs = 2;
+
+    //register out of order, the best prio must still win
+    convert::register_converter(id, std::bind(&make_dummy_converter, 3), 3);
+    convert::register_converter(id, std::bind(&make_dummy_converter, 7), 7);
+    convert::register_converter(id, std::bind(&make_dummy_converter, 0), 0);
+
+    auto get_prio = [](const convert::id_type &id, const int prio){
+        convert::get_converter(id, prio)();
+        return last_made_prio;
+    };
+    BOOST_CHECK_EQUAL(get_prio(id, -1), 7);
+    BOOST_CHECK_EQUAL(get_prio(id, 3), 3);
+    BOOST_CHECK_EQUAL(get_prio(id, 0), 0);
+    BOOST_CHECK_THROW(convert::get_converter(id, 5), uhd::key_error);
+
+    //same formats, different widths are different routines
+    convert::id_type other_id = id;
+    other_id.num_outputs = 1;
+    BOOST_CHECK_THROW(convert::get_converter(other_id), uhd::key_error);
+    other_id.output_format = "dummy_unknown";
+    other_id.num_outputs = 2;
+    BOOST_CHECK_THROW(convert::get_converter(other_id), uhd::key_error);
+
+    //equal IDs must hash equally
+    convert::id_type same_id;
+    same_id.input_format = std::string("dummy_") + "in";
+    same_id.num_inputs = 1;
+    same_id.output_format = std::string("dummy_") + "out";
+    same_id.num_outputs = 2;
+    BOOST_CHECK(same_id == id);
+    BOOST_CHECK_EQUAL(std::hash<convert::id_type>()(same_id), convert::hash_value(id));
+}
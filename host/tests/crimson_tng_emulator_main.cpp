@@ -0,0 +1,71 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// Runs a Crimson TNG emulator on the loopback interface until interrupted,
+// so the driver and the examples can be pointed at it, e.g.
+//   benchmark_rate --args="type=crimson_tng,addr=127.0.0.1" --tx_rate 1e6
+
+#include "crimson_tng_emulator.hpp"
+#include "crimson_tng_fw_common.h"
+#include <uhd/utils/safe_main.hpp>
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+namespace po = boost::program_options;
+
+static bool stop_signal_called = false;
+void sig_int_handler(int){stop_signal_called = true;}
+
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    crimson_tng_emulator::args_t args;
+    double stats_interval;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("addr", po::value<std::string>(&args.addr)->default_value(args.addr), "address to bind to")
+        ("clock-offset", po::value<double>(&args.clock_offset)->default_value(0.0), "device time minus host time at startup, in seconds")
+        ("clock-drift", po::value<double>(&args.clock_drift_ppm)->default_value(0.0), "device clock rate error, in ppm")
+        ("rx-spp", po::value<size_t>(&args.rx_spp)->default_value(args.rx_spp), "samples per RX packet")
+        ("stats-interval", po::value<double>(&stats_interval)->default_value(1.0), "seconds between buffer level prints, 0 to disable")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")){
+        std::cout << boost::format("Crimson TNG emulator %s") % desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    crimson_tng_emulator::sptr emu = crimson_tng_emulator::make(args);
+    std::cout << boost::format("Emulating a Crimson TNG on %s, management port %u, flow control port %u")
+        % args.addr % emu->get_mgmt_port() % emu->get_flow_port() << std::endl;
+    std::cout << "Press Ctrl + C to stop..." << std::endl;
+
+    std::signal(SIGINT, &sig_int_handler);
+    auto next_stats = std::chrono::steady_clock::now();
+    while (not stop_signal_called) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (stats_interval <= 0 or std::chrono::steady_clock::now() < next_stats) {
+            continue;
+        }
+        next_stats += std::chrono::microseconds(int64_t(stats_interval * 1e6));
+        std::cout << boost::format("t=%.6f requests=%u")
+            % emu->get_time_now().get_real_secs() % emu->get_num_mgmt_requests();
+        for (size_t chan = 0; chan < CRIMSON_TNG_TX_CHANNELS; chan++) {
+            std::cout << boost::format(" tx%u=%u/U%u/O%u rx%u=%u")
+                % chan % emu->get_tx_level(chan) % emu->get_tx_underflows(chan)
+                % emu->get_tx_overflows(chan) % chan % emu->get_rx_samps_sent(chan);
+        }
+        std::cout << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,348 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "crimson_tng_emulator.hpp"
+#include <uhd/transport/udp_simple.hpp>
+#include <uhd/transport/vrt_if_packet.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <boost/asio.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace uhd::transport;
+
+namespace {
+
+constexpr double TICK_RATE = 325e6 / 2;
+
+//! An emulator on free ports, so tests can run next to a real one
+crimson_tng_emulator::sptr make_emulator(
+    crimson_tng_emulator::args_t args = crimson_tng_emulator::args_t()
+){
+    args.mgmt_port = 0;
+    args.flow_port = 0;
+    args.tx_port = 0;
+    return crimson_tng_emulator::make(args);
+}
+
+udp_simple::sptr connect(const uint16_t port)
+{
+    return udp_simple::make_connected("127.0.0.1", std::to_string(port));
+}
+
+std::string mgmt_request(udp_simple::sptr mgmt, const std::string &req)
+{
+    mgmt->send(boost::asio::buffer(req));
+    char buff[1024] = {};
+    const size_t len = mgmt->recv(boost::asio::buffer(buff, sizeof(buff) - 1), 1.0);
+    return std::string(buff, len);
+}
+
+//! Send a flow control request and return the big-endian words of the reply
+std::vector<uint64_t> flow_request(
+    udp_simple::sptr flow,
+    const std::vector<uint64_t> &req,
+    const size_t reply_words
+){
+    std::vector<uint64_t> buff(req.size());
+    for (size_t i = 0; i < req.size(); i++) {
+        buff[i] = boost::endian::native_to_big(req[i]);
+    }
+    flow->send(boost::asio::buffer(buff));
+    if (reply_words == 0) {
+        return std::vector<uint64_t>();
+    }
+    std::vector<uint64_t> reply(reply_words);
+    const size_t len = flow->recv(boost::asio::buffer(reply), 1.0);
+    BOOST_REQUIRE_EQUAL(len, reply_words * sizeof(uint64_t));
+    for (uint64_t &word : reply) {
+        boost::endian::big_to_native_inplace(word);
+    }
+    return reply;
+}
+
+struct fifo_lvl_t
+{
+    size_t level;
+    uint64_t oflow;
+    uint64_t uflow;
+};
+
+fifo_lvl_t get_fifo_lvl(udp_simple::sptr flow, const size_t chan)
+{
+    const std::vector<uint64_t> reply = flow_request(
+        flow, std::vector<uint64_t>(1, (uint64_t(0x10001) << 16) | chan), 5);
+    BOOST_CHECK_EQUAL(reply[0] >> 48, chan);
+    fifo_lvl_t lvl;
+    lvl.level = reply[0] & 0xffff;
+    lvl.oflow = reply[1];
+    lvl.uflow = reply[2];
+    return lvl;
+}
+
+void send_tx_packet(
+    udp_simple::sptr tx,
+    const size_t nsamps,
+    const bool eob,
+    const bool has_tsf = false,
+    const uint64_t tsf = 0
+){
+    std::vector<uint32_t> buff(vrt::max_if_hdr_words32 + nsamps, 0);
+    vrt::if_packet_info_t info;
+    info.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    info.num_payload_words32 = nsamps;
+    info.num_payload_bytes = nsamps * sizeof(uint32_t);
+    info.has_sid = false;
+    info.has_cid = false;
+    info.has_tsi = false;
+    info.has_tsf = has_tsf;
+    info.tsf = tsf;
+    info.has_tlr = false;
+    info.eob = eob;
+    vrt::if_hdr_pack_be(&buff.front(), info);
+    tx->send(boost::asio::buffer(&buff.front(), info.num_packet_words32 * sizeof(uint32_t)));
+}
+
+//! Receive one packet from a bound socket, or return 0 after the timeout
+size_t recv_packet(
+    boost::asio::ip::udp::socket &sock,
+    std::vector<uint32_t> &buff,
+    const double timeout
+){
+    const auto exit_time = std::chrono::steady_clock::now()
+        + std::chrono::microseconds(int64_t(timeout * 1e6));
+    while (sock.available() == 0) {
+        if (std::chrono::steady_clock::now() > exit_time) {
+            return 0;
+        }
+        boost::this_thread::sleep(boost::posix_time::microseconds(100));
+    }
+    return sock.receive(boost::asio::buffer(buff));
+}
+
+double elapsed_us(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_crimson_emu_mgmt)
+{
+    crimson_tng_emulator::sptr emu = make_emulator();
+    udp_simple::sptr mgmt = connect(emu->get_mgmt_port());
+
+    // discovery request, including its null terminator
+    mgmt->send(boost::asio::buffer("1,get,fpga/about/name", sizeof("1,get,fpga/about/name")));
+    char buff[1024] = {};
+    const size_t len = mgmt->recv(boost::asio::buffer(buff), 1.0);
+    BOOST_CHECK_EQUAL(std::string(buff, len), "1,0,crimson_tng");
+
+    // rates are coerced to what the DSP chain can do
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "2,set,rx_a/dsp/rate,1e6"), "2,0,1000000");
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "3,set,tx_b/dsp/rate,80e6"), "3,0,81250000");
+    BOOST_CHECK_EQUAL(emu->get_prop("rx_a/dsp/rate"), "1000000");
+
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "4,set,rx_a/rf/freq/val,2.4e9"), "4,0,2.4e9");
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "5,get,rx_a/rf/freq/val"), "5,0,2.4e9");
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "6,get,no/such/prop"), "6,0,0");
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "7,set,rx_a/dsp/rate,fast"), "7,1");
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "8,poke"), "8,1");
+
+    // the links point back at the emulator
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "9,get,fpga/board/flow_control/sfpa_port"),
+        "9,0," + std::to_string(emu->get_flow_port()));
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "10,get,tx_c/link/port"),
+        "10,0," + std::to_string(emu->get_tx_port(2)));
+    BOOST_CHECK_EQUAL(emu->get_num_mgmt_requests(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_crimson_emu_clock)
+{
+    crimson_tng_emulator::args_t args;
+    args.clock_offset = 1000.0;
+    args.clock_drift_ppm = 10000;
+    crimson_tng_emulator::sptr emu = make_emulator(args);
+    udp_simple::sptr mgmt = connect(emu->get_mgmt_port());
+    udp_simple::sptr flow = connect(emu->get_flow_port());
+
+    // the device clock runs 1% fast
+    const auto host_start = std::chrono::steady_clock::now();
+    const uhd::time_spec_t dev_start = emu->get_time_now();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    const uhd::time_spec_t dev_end = emu->get_time_now();
+    const double host_elapsed = elapsed_us(host_start) / 1e6;
+    const double dev_elapsed = (dev_end - dev_start).get_real_secs();
+    std::cout << "Device clock ran " << dev_elapsed << " s in "
+              << host_elapsed << " s of host time" << std::endl;
+    BOOST_CHECK_CLOSE(dev_elapsed, host_elapsed * 1.01, 0.2);
+
+    // time diff replies are the request time minus the device time
+    const uhd::time_spec_t req_time = emu->get_time_now() + uhd::time_spec_t(0.5);
+    std::vector<uint64_t> req;
+    req.push_back(uint64_t(0x20002) << 16);
+    req.push_back(uint64_t(req_time.get_full_secs()));
+    req.push_back(uint64_t(req_time.get_frac_secs() * TICK_RATE));
+    const std::vector<uint64_t> reply = flow_request(flow, req, 2);
+    const double diff = double(int64_t(reply[0])) + double(int64_t(reply[1])) / TICK_RATE;
+    BOOST_CHECK(diff < 0.5 and diff > 0.49);
+
+    // setting the time moves the device clock
+    BOOST_CHECK_EQUAL(mgmt_request(mgmt, "1,set,time/clk/cur_time,10.0").substr(0, 4), "1,0,");
+    const double now = emu->get_time_now().get_real_secs();
+    BOOST_CHECK(now >= 10.0 and now < 10.1);
+}
+
+BOOST_AUTO_TEST_CASE(test_crimson_emu_tx_buffer)
+{
+    crimson_tng_emulator::sptr emu = make_emulator();
+    udp_simple::sptr flow = connect(emu->get_flow_port());
+    udp_simple::sptr tx = connect(emu->get_tx_port(0));
+    emu->set_prop("tx_a/dsp/rate", "100e3");
+
+    // a burst without an end of burst underflows once it has drained
+    for (size_t i = 0; i < 10; i++) {
+        send_tx_packet(tx, 1000, false);
+    }
+    fifo_lvl_t lvl = get_fifo_lvl(flow, 0);
+    BOOST_CHECK(lvl.level > 0 and lvl.level <= 10000);
+    BOOST_CHECK_EQUAL(lvl.uflow, 0);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    lvl = get_fifo_lvl(flow, 0);
+    BOOST_CHECK_EQUAL(lvl.level, 0);
+    BOOST_CHECK_EQUAL(lvl.uflow, 1);
+
+    // a burst with an end of burst does not
+    send_tx_packet(tx, 1000, false);
+    send_tx_packet(tx, 1000, true);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    BOOST_CHECK_EQUAL(emu->get_tx_level(0), 0);
+    BOOST_CHECK_EQUAL(emu->get_tx_underflows(0), 1);
+
+    // a timed burst waits for its start time
+    const uhd::time_spec_t start = emu->get_time_now() + uhd::time_spec_t(0.5);
+    send_tx_packet(tx, 1000, false, true, start.to_ticks(TICK_RATE));
+    for (size_t i = 1; i < 5; i++) {
+        send_tx_packet(tx, 1000, i == 4);
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    BOOST_CHECK_EQUAL(get_fifo_lvl(flow, 0).level, 5000);
+
+    // sending faster than the buffer drains overflows it
+    emu->set_prop("tx_a/dsp/rate", "0");
+    for (size_t i = 0; i < 70; i++) {
+        send_tx_packet(tx, 1000, false);
+        // don't overrun the socket buffer instead
+        if (i % 10 == 9) {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+        }
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    lvl = get_fifo_lvl(flow, 0);
+    BOOST_CHECK_EQUAL(lvl.level, 0xffff);
+    BOOST_CHECK(lvl.oflow > 0);
+    BOOST_CHECK_EQUAL(emu->get_tx_level(1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_crimson_emu_rx)
+{
+    crimson_tng_emulator::sptr emu = make_emulator();
+    udp_simple::sptr flow = connect(emu->get_flow_port());
+
+    boost::asio::io_service io_service;
+    boost::asio::ip::udp::socket sock(io_service, boost::asio::ip::udp::endpoint(
+        boost::asio::ip::address::from_string("127.0.0.1"), 0));
+    emu->set_prop("rx_b/link/port", std::to_string(sock.local_endpoint().port()));
+    emu->set_prop("rx_b/dsp/rate", "1e6");
+
+    // num samps and done, now
+    std::vector<uint64_t> cmd(4, 0);
+    cmd[0] = (uint64_t(1) << 16) | 1 | (uint64_t(0x2) << 36);
+    cmd[3] = 10000;
+    flow_request(flow, cmd, 0);
+
+    std::vector<uint32_t> buff(2048);
+    size_t num_samps = 0;
+    uint64_t last_tsf = 0;
+    bool eob = false;
+    while (not eob) {
+        const size_t len = recv_packet(sock, buff, 1.0);
+        BOOST_REQUIRE(len > 0);
+        vrt::if_packet_info_t info;
+        info.num_packet_words32 = len / sizeof(uint32_t);
+        vrt::if_hdr_unpack_be(&buff.front(), info);
+        BOOST_REQUIRE(info.has_tsf);
+        BOOST_CHECK_EQUAL(info.sob, num_samps == 0);
+        if (num_samps > 0) {
+            // 162.5 ticks per sample at 1 Msps
+            BOOST_CHECK_CLOSE(double(info.tsf - last_tsf), 162.5 * 1024, 0.01);
+        }
+        const uint32_t first = uhd::ntohx(buff[info.num_header_words32]);
+        BOOST_CHECK_EQUAL(first >> 16, num_samps & 0xffff);
+        last_tsf = info.tsf;
+        num_samps += info.num_payload_words32;
+        eob = info.eob;
+    }
+    BOOST_CHECK_EQUAL(num_samps, 10000);
+    BOOST_CHECK_EQUAL(emu->get_rx_samps_sent(1), 10000);
+
+    // continuous streaming until stopped
+    cmd[0] = (uint64_t(1) << 16) | 1 | (uint64_t(0xc) << 36);
+    cmd[3] = 0;
+    flow_request(flow, cmd, 0);
+    const auto start = std::chrono::steady_clock::now();
+    num_samps = 0;
+    while (elapsed_us(start) < 100e3) {
+        const size_t len = recv_packet(sock, buff, 1.0);
+        BOOST_REQUIRE(len > 0);
+        vrt::if_packet_info_t info;
+        info.num_packet_words32 = len / sizeof(uint32_t);
+        vrt::if_hdr_unpack_be(&buff.front(), info);
+        BOOST_CHECK_EQUAL(info.num_payload_words32, 1024);
+        num_samps += info.num_payload_words32;
+    }
+    cmd[0] = (uint64_t(1) << 16) | 1 | (uint64_t(0x1) << 36);
+    flow_request(flow, cmd, 0);
+    std::cout << "Received " << num_samps << " samples in 100 ms at 1 Msps" << std::endl;
+    BOOST_CHECK(num_samps > 50000 and num_samps < 150000);
+
+    // drain what was sent before the stop, then nothing more arrives
+    while (recv_packet(sock, buff, 0.05) > 0);
+    const uint64_t samps_sent = emu->get_rx_samps_sent(1);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    BOOST_CHECK_EQUAL(emu->get_rx_samps_sent(1), samps_sent);
+    BOOST_CHECK_EQUAL(emu->get_rx_samps_sent(0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_crimson_emu_round_trip_benchmark)
+{
+    crimson_tng_emulator::sptr emu = make_emulator();
+    udp_simple::sptr mgmt = connect(emu->get_mgmt_port());
+    udp_simple::sptr flow = connect(emu->get_flow_port());
+    static const size_t NUM_ITERS = 1000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++) {
+        const std::string seq = std::to_string(i);
+        BOOST_REQUIRE_EQUAL(mgmt_request(mgmt, seq + ",get,fpga/about/name"),
+            seq + ",0,crimson_tng");
+    }
+    std::cout << "Management round trip: "
+              << elapsed_us(start) / NUM_ITERS << " us" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++) {
+        get_fifo_lvl(flow, i % 4);
+    }
+    std::cout << "FIFO level round trip: "
+              << elapsed_us(start) / NUM_ITERS << " us" << std::endl;
+}
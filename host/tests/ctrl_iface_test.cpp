@@ -0,0 +1,104 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "mock_zero_copy.hpp"
+#include <uhdlib/rfnoc/ctrl_iface.hpp>
+#include <uhd/exception.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <string>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+using namespace uhd::transport::vrt;
+
+static const sid_t TEST_SID = 0x00000200; // 0.0.2.0
+
+struct ctrl_fixture
+{
+    ctrl_fixture()
+    {
+        send = boost::make_shared<mock_zero_copy>(if_packet_info_t::LINK_TYPE_CHDR);
+        recv = boost::make_shared<mock_zero_copy>(if_packet_info_t::LINK_TYPE_CHDR);
+        xports.send_sid = TEST_SID;
+        xports.recv_sid = TEST_SID.reversed();
+        xports.send_buff_size = SEND_BUFF_SIZE;
+        xports.recv_buff_size = RECV_BUFF_SIZE;
+        xports.endianness = uhd::ENDIANNESS_BIG;
+        xports.send = send;
+        xports.recv = recv;
+        ctrl = ctrl_iface::make(xports, "test");
+    }
+
+    //! Queue up the ACK the block would send for command number \p seq
+    void push_ack(const size_t seq)
+    {
+        if_packet_info_t ifpi;
+        ifpi.link_type = if_packet_info_t::LINK_TYPE_CHDR;
+        ifpi.packet_type = if_packet_info_t::PACKET_TYPE_RESP;
+        ifpi.packet_count = seq;
+        ifpi.has_sid = true;
+        ifpi.sid = xports.recv_sid.get();
+        ifpi.num_payload_words32 = 2;
+        ifpi.num_payload_bytes = 2*sizeof(uint32_t);
+        recv->push_back_recv_packet<uint32_t>(ifpi, std::vector<uint32_t>(2, 0));
+    }
+
+    mock_zero_copy::sptr send;
+    mock_zero_copy::sptr recv;
+    both_xports_t xports;
+    ctrl_iface::sptr ctrl;
+};
+
+BOOST_AUTO_TEST_CASE(test_ctrl_iface_batch)
+{
+    ctrl_fixture f;
+    ctrl_iface::cmd_list_t cmds;
+    for (size_t i = 0; i < 8; i++) {
+        cmds.push_back(ctrl_iface::cmd_t(0x10 + i, i));
+        f.push_ack(i);
+    }
+
+    f.ctrl->send_cmd_pkts(cmds);
+
+    // All commands went out in order, and all ACKs were consumed
+    for (size_t i = 0; i < cmds.size(); i++) {
+        if_packet_info_t ifpi;
+        ifpi.link_type = if_packet_info_t::LINK_TYPE_CHDR;
+        f.send->pop_send_packet(ifpi);
+        BOOST_CHECK_EQUAL(ifpi.packet_count, i);
+        BOOST_CHECK_EQUAL(ifpi.sid, TEST_SID.get());
+    }
+    BOOST_CHECK(not f.recv->get_recv_buff(0.0));
+
+    // Nothing outstanding, so this must not wait for anything
+    BOOST_CHECK_NO_THROW(f.ctrl->flush());
+}
+
+BOOST_AUTO_TEST_CASE(test_ctrl_iface_batch_bad_ack)
+{
+    ctrl_fixture f;
+    ctrl_iface::cmd_list_t cmds;
+    for (size_t i = 0; i < 4; i++) {
+        cmds.push_back(ctrl_iface::cmd_t(0x10 + i, 0xAB00 + i));
+    }
+    // The third ACK has the wrong sequence number
+    f.push_ack(0);
+    f.push_ack(1);
+    f.push_ack(5);
+    f.push_ack(3);
+
+    try {
+        f.ctrl->send_cmd_pkts(cmds);
+        BOOST_FAIL("Bad ACK was not detected");
+    } catch (const uhd::io_error &e) {
+        // The error must name the command the bad ACK belongs to
+        const std::string msg = e.what();
+        std::cout << msg << std::endl;
+        BOOST_CHECK(msg.find("0x12=0xAB02") != std::string::npos);
+    }
+}
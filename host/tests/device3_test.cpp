@@ -16,6 +16,8 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+#include <chrono>
 #include <exception>
 #include <iostream>
 
@@ -193,4 +195,64 @@ BOOST_AUTO_TEST_CASE(test_device3_fail) {
     );
 }
 
+// Control interface with a round trip time, like a real device has
+class slow_ctrl_iface_impl : public ctrl_iface
+{
+  public:
+    slow_ctrl_iface_impl() : _iface(new mock_ctrl_iface_impl()) {}
+
+    uint64_t send_cmd_pkt(
+            const size_t addr,
+            const size_t data,
+            const bool readback=false,
+            const uint64_t timestamp=0
+    ) {
+        if (readback) {
+            boost::this_thread::sleep(boost::posix_time::microseconds(500));
+        }
+        return _iface->send_cmd_pkt(addr, data, readback, timestamp);
+    }
+
+  private:
+    ctrl_iface::sptr _iface;
+};
+
+BOOST_AUTO_TEST_CASE(test_device3_parallel_init) {
+    // 8 different block types, 2 of each
+    static const size_t N_NAMES = 8;
+    static const size_t N_BLOCKS = 2 * N_NAMES;
+
+    double init_time[2];
+    const size_t max_threads[2] = {1, N_NAMES};
+    for (size_t run = 0; run < 2; run++) {
+        auto tree = uhd::property_tree::make();
+        std::vector<make_args_t> make_args(N_BLOCKS, make_args_t(DEFAULT_BLOCK_NAME));
+        std::vector<uint64_t> noc_ids(N_BLOCKS, ~0);
+        for (size_t i = 0; i < N_BLOCKS; i++) {
+            make_args[i].ctrl_ifaces[0] = ctrl_iface::sptr(new slow_ctrl_iface_impl());
+            make_args[i].base_address = TEST_SID0.get_dst() + (i << 4);
+            make_args[i].tree = tree;
+            make_args[i].block_name = str(boost::format("Test%d") % (i % N_NAMES));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto blocks =
+            block_ctrl_base::make_blocks(make_args, noc_ids, max_threads[run]);
+        init_time[run] = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // Blocks of the same type must still be numbered in order
+        BOOST_REQUIRE_EQUAL(blocks.size(), N_BLOCKS);
+        for (size_t i = 0; i < N_BLOCKS; i++) {
+            BOOST_CHECK_EQUAL(blocks[i]->get_block_id(),
+                str(boost::format("0/Test%d_%d") % (i % N_NAMES) % (i / N_NAMES)));
+        }
+    }
+
+    std::cout << "Block init, sequential: " << init_time[0] * 1e3 << " ms" << std::endl;
+    std::cout << "Block init, " << max_threads[1] << " threads: "
+              << init_time[1] * 1e3 << " ms" << std::endl;
+    BOOST_CHECK_LT(init_time[1], init_time[0]);
+}
+
 // vim: sw=4 et:
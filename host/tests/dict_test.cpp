@@ -7,7 +7,12 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/types/dict.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/format.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_dict_init){
     uhd::dict<int, int> d;
@@ -124,3 +129,98 @@ BOOST_AUTO_TEST_CASE(test_dict_equals)
     BOOST_CHECK(not (d0 == d2));
     BOOST_CHECK(not (d0 == d3));
 }
+
+namespace {
+    //! A key type without a hash function
+    struct plain_key_t{
+        int x;
+        bool operator==(const plain_key_t &rhs) const{ return x == rhs.x; }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(test_dict_large)
+{
+    //large enough for the hash index
+    static const int NUM_KEYS = 100;
+    uhd::dict<std::string, int> d;
+    for (int i = 0; i < NUM_KEYS; i++){
+        d[std::to_string(i)] = i;
+    }
+    BOOST_CHECK_EQUAL(d.size(), size_t(NUM_KEYS));
+    BOOST_CHECK_EQUAL(d["42"], 42);
+    BOOST_CHECK(not d.has_key("100"));
+    BOOST_CHECK_THROW(d.get("100"), uhd::key_error);
+
+    //insertion order is kept through pop and re-insert
+    BOOST_CHECK_EQUAL(d.pop("0"), 0);
+    BOOST_CHECK(not d.has_key("0"));
+    d["0"] = -1;
+    const std::vector<std::string> keys = d.keys();
+    BOOST_CHECK_EQUAL(keys.front(), "1");
+    BOOST_CHECK_EQUAL(keys.back(), "0");
+    BOOST_CHECK_EQUAL(d["0"], -1);
+
+    //copies are independent
+    uhd::dict<std::string, int> d2(d);
+    uhd::dict<std::string, int> d3;
+    d3 = d;
+    d2.pop("42");
+    d3["42"] = 0;
+    BOOST_CHECK_EQUAL(d["42"], 42);
+    BOOST_CHECK(not d2.has_key("42"));
+    BOOST_CHECK_EQUAL(d3["42"], 0);
+    BOOST_CHECK(d != d3);
+    d3["42"] = 42;
+    BOOST_CHECK(d == d3);
+
+    //keys that cannot be hashed use the linear search
+    uhd::dict<plain_key_t, int> d4;
+    for (int i = 0; i < NUM_KEYS; i++){
+        plain_key_t key = {i};
+        d4[key] = i;
+    }
+    plain_key_t key = {NUM_KEYS-1};
+    BOOST_CHECK_EQUAL(d4[key], NUM_KEYS-1);
+}
+
+BOOST_AUTO_TEST_CASE(test_dict_benchmark)
+{
+    static const size_t NUM_ITERS = 10000;
+
+    //device args as passed to a multi-channel device
+    std::string args_str = "type=crimson_tng,addr=192.168.10.2";
+    for (size_t i = 0; i < 24; i++){
+        args_str += str(boost::format(",key%d=val%d") % i % i);
+    }
+    const auto start_parse = std::chrono::steady_clock::now();
+    size_t num_keys = 0;
+    for (size_t i = 0; i < NUM_ITERS; i++){
+        const uhd::device_addr_t args(args_str);
+        num_keys += args.size();
+        if (args.has_key("key23")) num_keys++;
+    }
+    const auto stop_parse = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(num_keys, 27*NUM_ITERS);
+
+    //lookups in a dict the size of a property tree directory
+    uhd::dict<std::string, int> d;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; i++){
+        keys.push_back(str(boost::format("prop%d") % i));
+        d[keys.back()] = i;
+    }
+    const auto start_lookup = std::chrono::steady_clock::now();
+    int sum = 0;
+    for (size_t i = 0; i < NUM_ITERS; i++){
+        for (const std::string &key : keys){
+            sum += d[key];
+        }
+    }
+    const auto stop_lookup = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(sum, int(63*64/2*NUM_ITERS));
+
+    const double us_parse = std::chrono::duration<double, std::micro>(stop_parse - start_parse).count();
+    const double ns_lookup = std::chrono::duration<double, std::nano>(stop_lookup - start_lookup).count();
+    std::cout << boost::format("device_addr_t parse (26 keys): %.2f us, lookup (64 keys): %.1f ns")
+        % (us_parse/NUM_ITERS) % (ns_lookup/NUM_ITERS/64) << std::endl;
+}
@@ -12,6 +12,8 @@
 #include <uhdlib/experts/expert_container.hpp>
 #include <uhdlib/experts/expert_factory.hpp>
 #include <fstream>
+#include <chrono>
+#include <iostream>
 
 using namespace uhd::experts;
 
@@ -134,6 +136,34 @@ private:
 
 //=============================================================================
 
+class chain_worker_t : public worker_node_t {
+public:
+    chain_worker_t(
+        const node_retriever_t& db,
+        const std::string& in,
+        const std::string& out,
+        boost::shared_ptr<size_t> resolve_count
+    ) : worker_node_t(in + "->" + out), _in(db, in), _out(db, out),
+        _resolve_count(resolve_count)
+    {
+        bind_accessor(_in);
+        bind_accessor(_out);
+    }
+
+private:
+    void resolve() {
+        _out.set(_in.get() + 1);
+        (*_resolve_count)++;
+    }
+
+    data_reader_t<int> _in;
+    data_writer_t<int> _out;
+
+    boost::shared_ptr<size_t> _resolve_count;
+};
+
+//=============================================================================
+
 #define DUMP_VARS \
     BOOST_TEST_MESSAGE( str(boost::format("### State = {A=%d%s, B=%d%s, C=%d%s, D=%d%s, E=%d%s, F=%d%s, G=%d%s}\n") % \
     nodeA.get() % (nodeA.is_dirty()?"*":"") % \
@@ -244,3 +274,66 @@ BOOST_AUTO_TEST_CASE(test_experts){
     container->resolve_to("Consume_G");
     VALIDATE_ALL_DEPENDENCIES
 }
+
+BOOST_AUTO_TEST_CASE(test_experts_incremental){
+    //A wide graph of independent chains, like the per-channel
+    //subgraphs of a multi-channel daughterboard
+    static const size_t NUM_CHAINS = 64;
+    static const size_t CHAIN_LEN = 4;
+    static const size_t NUM_ITERS = 1000;
+
+    expert_container::sptr container = expert_factory::create_container("chains");
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    boost::shared_ptr<size_t> resolve_count = boost::make_shared<size_t>(0);
+
+    for (size_t chain = 0; chain < NUM_CHAINS; chain++) {
+        const std::string prefix = str(boost::format("chain%d/") % chain);
+        expert_factory::add_prop_node<int>(container, tree, prefix + "0", 0);
+        for (size_t i = 1; i <= CHAIN_LEN; i++) {
+            expert_factory::add_data_node<int>(container, prefix + std::to_string(i), 0);
+            expert_factory::add_worker_node<chain_worker_t>(container,
+                container->node_retriever(),
+                prefix + std::to_string(i - 1), prefix + std::to_string(i),
+                resolve_count);
+        }
+    }
+    container->resolve_all();
+    BOOST_CHECK_EQUAL(*resolve_count, NUM_CHAINS * CHAIN_LEN);
+
+    //Writing to one chain may only resolve the workers of that chain
+    const data_node_t<int>& tail = dynamic_cast<const data_node_t<int>&>(
+        container->node_retriever().lookup(str(boost::format("chain%d/%d") % 5 % CHAIN_LEN)));
+    *resolve_count = 0;
+    tree->access<int>("chain5/0").set(10);
+    container->resolve_from("chain5/0");
+    BOOST_CHECK_EQUAL(*resolve_count, CHAIN_LEN);
+    BOOST_CHECK_EQUAL(tail.get(), int(10 + CHAIN_LEN));
+
+    //resolve_to only needs the upstream part of a chain
+    *resolve_count = 0;
+    tree->access<int>("chain7/0").set(20);
+    container->resolve_to("chain7/2");
+    BOOST_CHECK_EQUAL(*resolve_count, size_t(2));
+    container->resolve_all();
+    BOOST_CHECK_EQUAL(*resolve_count, CHAIN_LEN);
+
+    //Compare the cost of a single-chain write with a full resolve
+    const auto start_all = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++) {
+        tree->access<int>("chain5/0").set(int(i));
+        container->resolve_all();
+    }
+    const auto start_from = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++) {
+        tree->access<int>("chain5/0").set(int(i));
+        container->resolve_from("chain5/0");
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(tail.get(), int(NUM_ITERS - 1 + CHAIN_LEN));
+
+    const double us_all = std::chrono::duration<double, std::micro>(start_from - start_all).count();
+    const double us_from = std::chrono::duration<double, std::micro>(stop - start_from).count();
+    std::cout << boost::format("Resolve after one write (%d nodes): resolve_all %.2f us, resolve_from %.2f us")
+        % (NUM_CHAINS * (2 * CHAIN_LEN + 1)) % (us_all / NUM_ITERS) % (us_from / NUM_ITERS)
+        << std::endl;
+}
@@ -0,0 +1,167 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// Round-trip latency benchmark of timed RX and TX. Runs the loop of the
+// latency test against a device, the Crimson TNG emulator or in-memory mock
+// transports, for each delay of a sweep, and writes the late bursts and the
+// host time spent per stage of the streamers as JSON, e.g.
+//   latency_benchmark --mock --deterministic --delays 0.0001,0.001
+
+#include "crimson_tng_emulator.hpp"
+#include "latency_responder.hpp"
+#include "stream_factory.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace po = boost::program_options;
+
+/***********************************************************************
+ * JSON output
+ **********************************************************************/
+static std::string json_histogram(const uhd::duration_histogram_t &h)
+{
+    return str(boost::format(
+        "{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}")
+        % (h.get_mean_ns() / 1e3) % (h.get_percentile_ns(50) / 1e3)
+        % (h.get_percentile_ns(90) / 1e3) % (h.get_percentile_ns(99) / 1e3)
+        % (h.max_ns / 1e3));
+}
+
+static std::string json_run(const double delay, const latency_responder::results_t &r)
+{
+    const latency_responder::stage_times_t &s = r.stages;
+    return str(boost::format(
+        "{\"delay_secs\":%g,\"iterations\":%u,\"rx_errors\":%u,\"late\":%u,"
+        "\"acks\":%u,\"underflows\":%u,\"other\":%u,\"turnaround_us\":%s,"
+        "\"stages_us\":{\"rx_call\":%s,\"rx_convert\":%s,\"rx_xport\":%s,\"rx_handler\":%s,"
+        "\"tx_call\":%s,\"tx_convert\":%s,\"tx_xport\":%s,\"tx_fc_wait\":%s,\"tx_handler\":%s}}")
+        % delay % r.iterations % r.rx_errors % r.late
+        % r.acks % r.underflows % r.other % json_histogram(r.turnaround)
+        % json_histogram(s.rx_call) % json_histogram(s.rx_convert)
+        % json_histogram(s.rx_xport) % json_histogram(s.rx_handler)
+        % json_histogram(s.tx_call) % json_histogram(s.tx_convert)
+        % json_histogram(s.tx_xport) % json_histogram(s.tx_fc_wait)
+        % json_histogram(s.tx_handler));
+}
+
+template <typename T>
+static std::vector<T> split_list(const std::string &list)
+{
+    std::vector<std::string> strs;
+    boost::split(strs, list, boost::is_any_of("\"', "), boost::token_compress_on);
+    std::vector<T> values;
+    for (const std::string &str : strs) {
+        if (not str.empty()) values.push_back(boost::lexical_cast<T>(str));
+    }
+    return values;
+}
+
+/***********************************************************************
+ * Main code
+ **********************************************************************/
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    uhd::set_thread_priority_safe();
+
+    std::string args, delay_list, cpu, otw, json_path;
+    latency_responder::options_t options;
+    size_t channel;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args)->default_value(""), "device address args")
+        ("emulate", "run against a Crimson TNG emulator on the loopback interface, in this process")
+        ("mock", "run against in-memory mock transports instead of a device")
+        ("deterministic", "with --mock, run on a clock which only moves when the transports wait")
+        ("channel", po::value<size_t>(&channel)->default_value(0), "channel to receive and send on")
+        ("rate", po::value<double>(&options.rate)->default_value(options.rate), "sample rate for receive and transmit (sps)")
+        ("nsamps", po::value<size_t>(&options.nsamps)->default_value(options.nsamps), "number of samples per iteration")
+        ("iterations", po::value<size_t>(&options.iterations)->default_value(options.iterations), "number of iterations per delay")
+        ("delays", po::value<std::string>(&delay_list)->default_value("0.001"), "delays between receive and transmit to sweep (seconds)")
+        ("async_timeout", po::value<double>(&options.async_timeout)->default_value(options.async_timeout), "time to wait for the async message of each burst (seconds)")
+        ("cpu", po::value<std::string>(&cpu)->default_value("fc32"), "CPU format")
+        ("otw", po::value<std::string>(&otw)->default_value("sc16"), "wire format")
+        ("json", po::value<std::string>(&json_path)->default_value("-"), "file to write the results to, - for stdout")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Latency Benchmark %s") % desc << std::endl;
+        std::cout <<
+            "    Each iteration receives a block at time t, and sends it back\n"
+            "    at t + delay. A delay shorter than the round trip through the\n"
+            "    host makes the burst late. Besides the late bursts, each run\n"
+            "    records the host time per iteration spent in the converters,\n"
+            "    the packet handlers, the transports and flow control.\n"
+            "    With --mock --deterministic, the late bursts do not depend on\n"
+            "    the speed of the host.\n"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (vm.count("deterministic") and not vm.count("mock")) {
+        throw uhd::value_error("--deterministic only works with --mock");
+    }
+
+    std::string mode = "device";
+    crimson_tng_emulator::sptr emulator;
+    stream_factory::sptr factory;
+    if (vm.count("mock")) {
+        mode = vm.count("deterministic") ? "mock_deterministic" : "mock";
+        factory = stream_factory::make_mock(vm.count("deterministic") != 0);
+    } else {
+        if (vm.count("emulate")) {
+            mode = "emulator";
+            emulator = crimson_tng_emulator::make();
+            if (args.empty()) args = "type=crimson_tng,addr=127.0.0.1";
+        }
+        factory = stream_factory::make_device(uhd::usrp::multi_usrp::make(args));
+    }
+
+    const std::vector<size_t> channels(1, channel);
+    options.rate = factory->set_rx_rate(options.rate, channels);
+    factory->set_tx_rate(options.rate, channels);
+    uhd::stream_args_t stream_args(cpu, otw);
+    stream_args.channels = channels;
+    latency_responder responder(
+        factory->get_rx_stream(stream_args),
+        factory->get_tx_stream(stream_args),
+        [factory](){ return factory->get_time_now(); });
+
+    std::vector<std::string> runs;
+    for (const double delay : split_list<double>(delay_list)) {
+        options.delay = delay;
+        const latency_responder::results_t results = responder.run(options);
+        std::cerr << boost::format("Delay %g s:\n%s") % delay % results.to_pp_string();
+        runs.push_back(json_run(delay, results));
+    }
+
+    const std::string json = str(boost::format(
+        "{\"mode\":\"%s\",\"rate\":%g,\"nsamps\":%u,\"cpu\":\"%s\",\"otw\":\"%s\","
+        "\"runs\":[\n  %s]}\n")
+        % mode % options.rate % options.nsamps % cpu % otw
+        % boost::algorithm::join(runs, ",\n  "));
+    if (json_path == "-") {
+        std::cout << json;
+    } else {
+        std::ofstream out(json_path.c_str());
+        out << json;
+        if (not out) {
+            throw uhd::runtime_error("Cannot write the results to " + json_path);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "latency_responder.hpp"
+#include "stream_factory.hpp"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+constexpr double RATE = 1e6;
+constexpr size_t NSAMPS = 100;
+constexpr size_t ITERATIONS = 20;
+
+//! Run the responder on mock streamers with a deterministic clock
+latency_responder::results_t run_mock(const double delay)
+{
+    stream_factory::sptr factory = stream_factory::make_mock(true);
+    const std::vector<size_t> channels(1, 0);
+    factory->set_rx_rate(RATE, channels);
+    factory->set_tx_rate(RATE, channels);
+    uhd::stream_args_t stream_args("fc32", "sc16");
+    stream_args.channels = channels;
+    latency_responder responder(
+        factory->get_rx_stream(stream_args),
+        factory->get_tx_stream(stream_args),
+        [factory](){ return factory->get_time_now(); });
+
+    latency_responder::options_t options;
+    options.rate = RATE;
+    options.nsamps = NSAMPS;
+    options.delay = delay;
+    options.iterations = ITERATIONS;
+    return responder.run(options);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_latency_responder_on_time)
+{
+    const latency_responder::results_t results = run_mock(0.001);
+    BOOST_CHECK_EQUAL(results.iterations, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.rx_errors, 0);
+    BOOST_CHECK_EQUAL(results.late, 0);
+    BOOST_CHECK_EQUAL(results.acks, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.underflows, 0);
+    BOOST_CHECK_EQUAL(results.other, 0);
+
+    // every iteration records every stage
+    BOOST_CHECK_EQUAL(results.turnaround.count, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.stages.rx_call.count, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.stages.rx_xport.count, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.stages.tx_convert.count, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.stages.tx_handler.count, ITERATIONS);
+    BOOST_CHECK(results.stages.rx_call.total_ns > 0);
+    BOOST_CHECK(results.stages.tx_call.total_ns > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_responder_late)
+{
+    const latency_responder::results_t results = run_mock(-0.001);
+    BOOST_CHECK_EQUAL(results.iterations, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.rx_errors, 0);
+    BOOST_CHECK_EQUAL(results.late, ITERATIONS);
+    BOOST_CHECK_EQUAL(results.acks, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_responder_threshold)
+{
+    // a block is only received once its last sample is in, so a response
+    // can be on time only after the duration of the block
+    const double block_secs = NSAMPS / RATE;
+    BOOST_CHECK_EQUAL(run_mock(block_secs / 2).late, ITERATIONS);
+    BOOST_CHECK_EQUAL(run_mock(block_secs * 2).late, 0);
+}
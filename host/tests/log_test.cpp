@@ -8,7 +8,12 @@
 #include <boost/test/unit_test.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/log_add.hpp>
+#include <uhdlib/utils/binary_log.hpp>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(test_messages){
     UHD_LOG_FASTPATH("foo");
@@ -37,3 +42,140 @@ BOOST_AUTO_TEST_CASE(test_messages){
     const int x = 42;
     UHD_VAR(x);
 }
+
+namespace {
+    std::mutex binary_msgs_mutex;
+    std::vector<uhd::log::logging_info> binary_msgs;
+
+    void add_binary_test_logger()
+    {
+        static bool added = false;
+        if (added) {
+            return;
+        }
+        uhd::log::add_logger("binary_test",
+            [](const uhd::log::logging_info &I){
+                if (I.component == "binary_test" or I.component == "LOGGING") {
+                    std::lock_guard<std::mutex> l(binary_msgs_mutex);
+                    binary_msgs.push_back(I);
+                }
+            }
+        );
+        uhd::log::set_logger_level("binary_test", uhd::log::trace);
+        added = true;
+    }
+
+    std::vector<uhd::log::logging_info> get_binary_msgs()
+    {
+        uhd::log::binary::flush();
+        std::lock_guard<std::mutex> l(binary_msgs_mutex);
+        std::vector<uhd::log::logging_info> msgs;
+        msgs.swap(binary_msgs);
+        return msgs;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_messages){
+    add_binary_test_logger();
+    uhd::log::set_log_level(uhd::log::debug);
+    get_binary_msgs();
+
+    const char *name = "rx_a";
+    UHD_LOG_BINARY_DEBUG("binary_test", "no arguments");
+    UHD_LOG_BINARY_INFO("binary_test", "%s: %d samples at %.1f Msps, mask 0x%x",
+        name, -5, 12.5, 0xbeefu);
+    UHD_LOG_BINARY_TRACE("binary_test", "below the log level");
+    UHD_LOG_BINARY_WARNING("binary_test", "too few arguments: %d %d", 1);
+    std::thread([](){
+        UHD_LOG_BINARY_ERROR("binary_test", "from another thread: %u", size_t(7));
+    }).join();
+
+    std::vector<uhd::log::logging_info> msgs = get_binary_msgs();
+    BOOST_REQUIRE_EQUAL(msgs.size(), 4);
+    BOOST_CHECK_EQUAL(msgs[0].message, "no arguments");
+    BOOST_CHECK_EQUAL(msgs[0].verbosity, uhd::log::debug);
+    BOOST_CHECK_EQUAL(msgs[1].message, "rx_a: -5 samples at 12.5 Msps, mask 0xbeef");
+    BOOST_CHECK_EQUAL(msgs[1].component, "binary_test");
+    BOOST_CHECK_EQUAL(msgs[1].thread_id, boost::this_thread::get_id());
+    BOOST_CHECK_EQUAL(msgs[2].message, "too few arguments: 1 ");
+    BOOST_CHECK_EQUAL(msgs[3].message, "from another thread: 7");
+    BOOST_CHECK(msgs[3].thread_id != boost::this_thread::get_id());
+    // timestamps follow the order of the calls
+    for (size_t i = 1; i < msgs.size(); i++) {
+        BOOST_CHECK(msgs[i].time >= msgs[i-1].time);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_drops){
+    add_binary_test_logger();
+    uhd::log::set_log_level(uhd::log::debug);
+    get_binary_msgs();
+
+    // a full ring drops records instead of waiting
+    static const size_t NUM_RECORDS = 3*uhd::log::binary::RING_SIZE;
+    std::thread([](){
+        for (size_t i = 0; i < NUM_RECORDS; i++) {
+            UHD_LOG_BINARY_DEBUG("binary_test", "record %u", i);
+        }
+    }).join();
+
+    const std::vector<uhd::log::logging_info> msgs = get_binary_msgs();
+    size_t num_records = 0;
+    size_t num_drop_msgs = 0;
+    for (const auto &msg : msgs) {
+        if (msg.component == "LOGGING") {
+            num_drop_msgs++;
+        } else {
+            num_records++;
+        }
+    }
+    std::cout << num_records << " of " << NUM_RECORDS << " records logged" << std::endl;
+    BOOST_CHECK(num_records >= uhd::log::binary::RING_SIZE);
+    BOOST_CHECK(num_records < NUM_RECORDS);
+    BOOST_CHECK(num_drop_msgs >= 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_benchmark){
+    // log at trace level, which the console and the other test loggers
+    // filter out, so the timing doesn't include printing
+    add_binary_test_logger();
+    uhd::log::set_log_level(uhd::log::trace);
+    get_binary_msgs();
+
+    // stay below the ring size, so no record is dropped
+    static const size_t NUM_CALLS = uhd::log::binary::RING_SIZE / 2;
+    static const size_t NUM_ROUNDS = 20;
+    auto time_calls = [](const std::function<void(size_t)> &fn){
+        double best_ns = 1e9;
+        for (size_t round = 0; round < NUM_ROUNDS; round++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < NUM_CALLS; i++) {
+                fn(i);
+            }
+            const double ns = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count() / NUM_CALLS;
+            best_ns = std::min(best_ns, ns);
+            get_binary_msgs();
+        }
+        return best_ns;
+    };
+
+    const double binary_ns = time_calls([](size_t i){
+        UHD_LOG_BINARY(uhd::log::trace, "binary_test",
+            "packet %u: %d samples, t=%f", i, 363, 1.5);
+    });
+    const double logger_ns = time_calls([](size_t i){
+        UHD_LOGGER_TRACE("binary_test") << "packet " << i << ": " << 363 << " samples, t=" << 1.5;
+    });
+    uhd::log::set_log_level(uhd::log::debug);
+    const double disabled_ns = time_calls([](size_t i){
+        UHD_LOG_BINARY(uhd::log::trace, "binary_test",
+            "packet %u: %d samples, t=%f", i, 363, 1.5);
+    });
+
+    std::cout << "Per-call cost of a log statement:" << std::endl
+              << "  binary:            " << binary_ns << " ns" << std::endl
+              << "  stream:            " << logger_ns << " ns" << std::endl
+              << "  binary, level off: " << disabled_ns << " ns" << std::endl;
+    BOOST_CHECK(binary_ns < logger_ns);
+}
@@ -0,0 +1,133 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "alloc_hook.hpp"
+#include "stream_factory.hpp"
+#include <uhdlib/utils/no_alloc.hpp>
+#include <boost/test/unit_test.hpp>
+#include <complex>
+#include <vector>
+
+namespace {
+
+constexpr double RATE = 1e6;
+constexpr size_t NUM_CALLS = 100;
+
+stream_factory::sptr make_factory(void)
+{
+    stream_factory::sptr factory = stream_factory::make_mock(true);
+    const std::vector<size_t> channels(1, 0);
+    factory->set_rx_rate(RATE, channels);
+    factory->set_tx_rate(RATE, channels);
+    return factory;
+}
+
+uhd::stream_args_t make_stream_args(void)
+{
+    uhd::stream_args_t stream_args("fc32", "sc16");
+    stream_args.channels = std::vector<size_t>(1, 0);
+    stream_args.args["no_alloc"] = "1";
+    stream_args.args["spp"] = "100";
+    return stream_args;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_no_alloc_hook)
+{
+    // volatile, so the compiler cannot elide the allocations
+    int * volatile p = nullptr;
+    alloc_hook::reset();
+    {
+        uhd::no_alloc::scope scope(false);
+        p = new int(1);
+        delete p;
+    }
+    BOOST_CHECK_EQUAL(alloc_hook::get_violations(), 0);
+    {
+        uhd::no_alloc::scope scope(true);
+        {
+            uhd::no_alloc::scope nested(true);
+        }
+        BOOST_CHECK(uhd::no_alloc::in_scope());
+        p = new int(1);
+        delete p;
+    }
+    BOOST_CHECK(not uhd::no_alloc::in_scope());
+    BOOST_CHECK_EQUAL(alloc_hook::get_violations(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_no_alloc_stream_arg)
+{
+    uhd::stream_args_t stream_args("fc32", "sc16");
+    BOOST_CHECK(not uhd::no_alloc::is_enabled(stream_args));
+    stream_args.args["no_alloc"] = "0";
+    BOOST_CHECK(not uhd::no_alloc::is_enabled(stream_args));
+    stream_args.args["no_alloc"] = "1";
+    BOOST_CHECK(uhd::no_alloc::is_enabled(stream_args));
+    stream_args.args["no_alloc"] = "true";
+    BOOST_CHECK(uhd::no_alloc::is_enabled(stream_args));
+}
+
+BOOST_AUTO_TEST_CASE(test_no_alloc_recv)
+{
+    stream_factory::sptr factory = make_factory();
+    uhd::rx_streamer::sptr rx_stream = factory->get_rx_stream(make_stream_args());
+    std::vector<std::complex<float>> buff(1000);
+    uhd::rx_metadata_t md;
+
+    uhd::stream_cmd_t stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+    stream_cmd.stream_now = true;
+    rx_stream->issue_stream_cmd(stream_cmd);
+    BOOST_CHECK_EQUAL(rx_stream->recv(&buff.front(), buff.size(), md, 1.0), buff.size());
+
+    alloc_hook::reset();
+    for (size_t i = 0; i < NUM_CALLS; i++) {
+        BOOST_REQUIRE_EQUAL(rx_stream->recv(&buff.front(), buff.size(), md, 1.0), buff.size());
+        BOOST_REQUIRE_EQUAL(md.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_REQUIRE_EQUAL(rx_stream->recv(&buff.front(), buff.size(), md, 1.0, true), 100);
+    }
+    BOOST_CHECK_EQUAL(alloc_hook::get_violations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_no_alloc_send)
+{
+    stream_factory::sptr factory = make_factory();
+    uhd::tx_streamer::sptr tx_stream = factory->get_tx_stream(make_stream_args());
+    std::vector<std::complex<float>> buff(1000);
+    uhd::async_metadata_t async_md;
+
+    uhd::tx_metadata_t md;
+    md.start_of_burst = true;
+    md.has_time_spec = true;
+    md.time_spec = factory->get_time_now() + uhd::time_spec_t(0.01);
+    BOOST_CHECK_EQUAL(tx_stream->send(&buff.front(), buff.size(), md, 1.0), buff.size());
+
+    alloc_hook::reset();
+    md.start_of_burst = false;
+    md.has_time_spec = false;
+    for (size_t i = 0; i < NUM_CALLS; i++) {
+        BOOST_REQUIRE_EQUAL(tx_stream->send(&buff.front(), buff.size(), md, 1.0), buff.size());
+    }
+    md.end_of_burst = true;
+    BOOST_CHECK_EQUAL(tx_stream->send(&buff.front(), 0, md, 1.0), 0);
+    // bursts after the first one, and their async messages
+    for (size_t i = 0; i < NUM_CALLS; i++) {
+        uhd::tx_metadata_t burst_md;
+        burst_md.start_of_burst = true;
+        burst_md.end_of_burst = true;
+        burst_md.has_time_spec = true;
+        burst_md.time_spec = factory->get_time_now() + uhd::time_spec_t(0.001);
+        BOOST_REQUIRE_EQUAL(tx_stream->send(&buff.front(), buff.size(), burst_md, 1.0), buff.size());
+    }
+    BOOST_CHECK_EQUAL(alloc_hook::get_violations(), 0);
+
+    size_t acks = 0;
+    while (tx_stream->recv_async_msg(async_md, 0.0)) {
+        if (async_md.event_code == uhd::async_metadata_t::EVENT_CODE_BURST_ACK) acks++;
+    }
+    BOOST_CHECK_EQUAL(acks, NUM_CALLS + 1);
+}
@@ -14,6 +14,7 @@
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #include "nocscript_common.hpp"
@@ -154,3 +155,46 @@ BOOST_AUTO_TEST_CASE(test_multi_commmand)
     BOOST_CHECK_EQUAL(dummy_false_counter, 3);
 }
 
+
+// Quiet variable getters, so the benchmark doesn't time the logging
+expression::type_t quiet_get_type(const std::string &)
+{
+    return expression::TYPE_INT;
+}
+
+expression_literal quiet_get_value(const std::string &)
+{
+    return expression_literal(SPP_VALUE);
+}
+
+BOOST_AUTO_TEST_CASE(test_compiled_benchmark)
+{
+    function_table::sptr ft = function_table::make();
+    parser::sptr p = parser::make(
+            ft,
+            boost::bind(&quiet_get_type, _1),
+            boost::bind(&quiet_get_value, _1)
+    );
+    const std::string line("GE($spp, 16) AND LE($spp, 4096) AND IS_PWR_OF_2($spp)");
+    const size_t num_evals = 2000;
+
+    // Old behaviour: parse the code on every evaluation
+    const auto parse_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_evals; i++) {
+        BOOST_REQUIRE(p->create_expr_tree(line)->eval().get_bool());
+    }
+    const auto parse_end = std::chrono::steady_clock::now();
+
+    // Compile once, evaluate many times
+    expression::sptr e = p->create_expr_tree(line);
+    const auto eval_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_evals; i++) {
+        BOOST_REQUIRE(e->eval().get_bool());
+    }
+    const auto eval_end = std::chrono::steady_clock::now();
+
+    const double parse_ns = std::chrono::duration<double, std::nano>(parse_end - parse_start).count();
+    const double eval_ns = std::chrono::duration<double, std::nano>(eval_end - eval_start).count();
+    std::cout << "Parse and evaluate: " << parse_ns / num_evals << " ns/eval" << std::endl;
+    std::cout << "Evaluate compiled:  " << eval_ns / num_evals << " ns/eval" << std::endl;
+}
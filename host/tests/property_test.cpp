@@ -8,6 +8,8 @@
 #include <boost/test/unit_test.hpp>
 #include <uhd/property_tree.hpp>
 #include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <chrono>
 #include <exception>
 #include <iostream>
 
@@ -215,6 +217,159 @@ BOOST_AUTO_TEST_CASE(test_prop_subtree){
 
 }
 
+BOOST_AUTO_TEST_CASE(test_prop_tree_paths){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    tree->create<int>("/mboards/0/tick_rate").set(1);
+    tree->create<int>("mboards/1/tick_rate").set(2);
+
+    //different spellings of the same path
+    BOOST_CHECK_EQUAL(tree->access<int>("mboards/0/tick_rate").get(), 1);
+    BOOST_CHECK_EQUAL(tree->access<int>("//mboards/1//tick_rate/").get(), 2);
+    BOOST_CHECK(tree->exists("/mboards/0/"));
+    BOOST_CHECK_THROW(tree->create<int>("/mboards//0/tick_rate"), uhd::runtime_error);
+    BOOST_CHECK_THROW(tree->access<int>("/mboards/0/tick"), uhd::lookup_error);
+    BOOST_CHECK_THROW(tree->list("/mboards/2"), uhd::lookup_error);
+
+    //list keeps the insertion order
+    tree->create<int>("/mboards/0/a");
+    tree->create<int>("/mboards/0/b");
+    const std::vector<std::string> dirs = tree->list("/mboards/0");
+    BOOST_REQUIRE_EQUAL(dirs.size(), size_t(3));
+    BOOST_CHECK_EQUAL(dirs[0], "tick_rate");
+    BOOST_CHECK_EQUAL(dirs[2], "b");
+
+    //handles outlive removal, new properties at the same path are distinct
+    boost::shared_ptr<uhd::property<int> > handle = tree->handle<int>("/mboards/0/tick_rate");
+    BOOST_CHECK_EQUAL(handle.get(), &tree->access<int>("/mboards/0/tick_rate"));
+    tree->remove("/mboards/0");
+    BOOST_CHECK(not tree->exists("/mboards/0/tick_rate"));
+    BOOST_CHECK(not tree->exists("/mboards/0"));
+    BOOST_CHECK(tree->exists("/mboards/1/tick_rate"));
+    BOOST_CHECK_EQUAL(handle->get(), 1);
+    tree->create<int>("/mboards/0/tick_rate").set(3);
+    BOOST_CHECK_EQUAL(tree->access<int>("/mboards/0/tick_rate").get(), 3);
+    BOOST_CHECK_EQUAL(handle->get(), 1);
+
+    //subtrees share the index
+    uhd::property_tree::sptr subtree = tree->subtree("/mboards/1");
+    BOOST_CHECK_EQUAL(subtree->access<int>("tick_rate").get(), 2);
+    subtree->create<int>("/new/prop");
+    BOOST_CHECK(tree->exists("/mboards/1/new/prop"));
+    BOOST_CHECK_THROW(tree->remove("/"), uhd::runtime_error);
+}
+
+struct batch_setter_type{
+    void doit(const std::vector<uhd::fs_path> &paths){
+        _calls++;
+        _paths.insert(_paths.end(), paths.begin(), paths.end());
+    }
+
+    batch_setter_type() : _calls(0) {}
+    int _calls;
+    std::vector<uhd::fs_path> _paths;
+};
+
+BOOST_AUTO_TEST_CASE(test_prop_tree_transaction){
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    setter_type setter, coerced_setter;
+    coercer_type coercer;
+    tree->create<int>("/rx/freq")
+        .add_desired_subscriber(boost::bind(&setter_type::doit, &setter, _1))
+        .set_coercer(boost::bind(&coercer_type::doit, &coercer, _1))
+        .add_coerced_subscriber(boost::bind(&setter_type::doit, &coerced_setter, _1));
+
+    //nothing is notified until the commit, and only once per property
+    tree->begin_transaction();
+    tree->access<int>("/rx/freq").set(33);
+    tree->begin_transaction();
+    tree->access<int>("/rx/freq").set(35);
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(tree->access<int>("/rx/freq").get_desired(), 35);
+    BOOST_CHECK_EQUAL(setter._count, 0);
+    BOOST_CHECK_EQUAL(coerced_setter._count, 0);
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(setter._count, 1);
+    BOOST_CHECK_EQUAL(setter._x, 35);
+    BOOST_CHECK_EQUAL(coerced_setter._x, 32);
+    BOOST_CHECK_EQUAL(tree->access<int>("/rx/freq").get(), 32);
+    BOOST_CHECK_THROW(tree->commit_transaction(), uhd::runtime_error);
+
+    //batch subscribers replace the desired subscribers in a transaction
+    setter_type gain_setter;
+    tree->create<int>("/rx/gain").add_desired_subscriber(boost::bind(&setter_type::doit, &gain_setter, _1));
+    tree->create<int>("/rx/rate");
+    batch_setter_type batch_setter;
+    tree->add_batch_subscriber(
+        std::vector<uhd::fs_path>{"/rx/freq", "rx/gain"},
+        boost::bind(&batch_setter_type::doit, &batch_setter, _1));
+    BOOST_CHECK_THROW(tree->add_batch_subscriber(
+        std::vector<uhd::fs_path>{"/rx/gain"},
+        boost::bind(&batch_setter_type::doit, &batch_setter, _1)), uhd::runtime_error);
+    BOOST_CHECK_THROW(tree->add_batch_subscriber(
+        std::vector<uhd::fs_path>{"/rx/bw"},
+        boost::bind(&batch_setter_type::doit, &batch_setter, _1)), uhd::lookup_error);
+
+    tree->begin_transaction();
+    tree->access<int>("/rx/gain").set(10);
+    tree->access<int>("/rx/rate").set(1000);
+    tree->access<int>("/rx/freq").set(41);
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(batch_setter._calls, 1);
+    BOOST_REQUIRE_EQUAL(batch_setter._paths.size(), size_t(2));
+    BOOST_CHECK_EQUAL(batch_setter._paths[0], "/rx/gain");
+    BOOST_CHECK_EQUAL(batch_setter._paths[1], "/rx/freq");
+    BOOST_CHECK_EQUAL(setter._count, 1);
+    BOOST_CHECK_EQUAL(gain_setter._count, 0);
+    BOOST_CHECK_EQUAL(coerced_setter._x, 40);
+    BOOST_CHECK_EQUAL(tree->access<int>("/rx/rate").get(), 1000);
+
+    //outside of a transaction, everything is immediate
+    tree->access<int>("/rx/gain").set(11);
+    BOOST_CHECK_EQUAL(gain_setter._count, 1);
+    BOOST_CHECK_EQUAL(batch_setter._calls, 1);
+
+    //removed properties are dropped from the transaction
+    tree->begin_transaction();
+    tree->access<int>("/rx/gain").set(12);
+    tree->remove("/rx/gain");
+    tree->commit_transaction();
+    BOOST_CHECK_EQUAL(batch_setter._calls, 1);
+    BOOST_CHECK_EQUAL(gain_setter._count, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_prop_tree_benchmark){
+    //A tree with the shape and size of a multi-channel device
+    uhd::property_tree::sptr tree = uhd::property_tree::make();
+    for (size_t mb = 0; mb < 4; mb++){
+        for (size_t ch = 0; ch < 16; ch++){
+            const uhd::fs_path path = uhd::fs_path("/mboards") / mb / "dboards/A/rx_frontends" / ch;
+            for (size_t i = 0; i < 32; i++){
+                tree->create<double>(path / str(boost::format("prop%d") % i)).set(double(i));
+            }
+        }
+    }
+
+    static const size_t NUM_ITERS = 100000;
+    const uhd::fs_path path("/mboards/3/dboards/A/rx_frontends/15/prop31");
+    boost::shared_ptr<uhd::property<double> > handle = tree->handle<double>(path);
+    double sum = 0.0;
+
+    const auto start_access = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++){
+        sum += tree->access<double>(path).get();
+    }
+    const auto start_handle = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_ITERS; i++){
+        sum += handle->get();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(sum, 2*31.0*NUM_ITERS);
+
+    const double ns_access = std::chrono::duration<double, std::nano>(start_handle - start_access).count();
+    const double ns_handle = std::chrono::duration<double, std::nano>(stop - start_handle).count();
+    std::cout << boost::format("access<T>(path).get(): %.1f ns, handle->get(): %.1f ns")
+        % (ns_access/NUM_ITERS) % (ns_handle/NUM_ITERS) << std::endl;
+}
 
 BOOST_AUTO_TEST_CASE(test_prop_operators)
 {
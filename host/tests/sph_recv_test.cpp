@@ -201,6 +201,20 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_sequence_error){
         BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
     }
 
+    //the counters saw every packet but the lost one
+    const uhd::stream_stats_t stats = handler.get_stats();
+    size_t num_recvd_samps = 0;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        if (i != NUM_PKTS_TO_TEST/2) num_recvd_samps += 10 + i%10;
+    }
+    BOOST_CHECK_EQUAL(stats.packets, NUM_PKTS_TO_TEST - 1);
+    BOOST_CHECK_EQUAL(stats.samples, num_recvd_samps);
+    BOOST_CHECK_EQUAL(stats.sequence_errors, 1);
+    BOOST_CHECK_EQUAL(stats.timeouts, 3);
+    BOOST_CHECK_EQUAL(stats.overflows, 0);
+    BOOST_CHECK_EQUAL(stats.call_time.count, NUM_PKTS_TO_TEST + 3);
+    BOOST_CHECK_EQUAL(stats.convert_time.count, NUM_PKTS_TO_TEST + 3);
+
     //simulate the transport failing
     xport.set_simulate_io_error(true);
     BOOST_REQUIRE_THROW(handler.recv(&buff.front(), buff.size(), metadata, 1.0, true), uhd::io_error);
@@ -816,3 +830,181 @@ BOOST_AUTO_TEST_CASE(test_sph_recv_multi_channel_fragment){
 
     BOOST_REQUIRE_THROW(handler.recv(buffs, NUM_SAMPS_PER_BUFF, metadata, 1.0, true), uhd::io_error);
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_borrowed){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "sc16";
+    id.num_outputs = 1;
+
+    mock_zero_copy xport(vrt::if_packet_info_t::LINK_TYPE_VRLP);
+
+    vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 0;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //generate a bunch of packets with a known payload (copied as-is)
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        ifpi.num_payload_words32 = 10 + i%10;
+        std::vector<uint32_t> data(ifpi.num_payload_words32);
+        for (size_t j = 0; j < data.size(); j++){
+            data[j] = uint32_t((i << 16) | j);
+        }
+        xport.push_back_recv_packet(ifpi, data);
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(
+        0,
+        [&xport](double timeout) {
+            return xport.get_recv_buff(timeout);
+        });
+    handler.set_converter(id);
+
+    //check the borrowed packets, interleaved with a fragmented recv()
+    size_t num_accum_samps = 0;
+    std::vector<std::complex<int16_t> > buff(5);
+    uhd::rx_streamer::borrowed_buffs_type borrowed;
+    uhd::rx_metadata_t metadata;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        size_t offset = 0;
+        if (i % 2){
+            offset = handler.recv(
+                &buff.front(), buff.size(), metadata, 1.0, true
+            );
+            BOOST_CHECK(metadata.more_fragments);
+            BOOST_CHECK_EQUAL(offset, buff.size());
+            num_accum_samps += offset;
+        }
+        size_t num_items_ret = handler.recv_borrowed(borrowed, metadata, 1.0);
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK(not metadata.more_fragments);
+        BOOST_CHECK_EQUAL(metadata.fragment_offset, offset);
+        BOOST_CHECK(metadata.has_time_spec);
+        BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(num_accum_samps, SAMP_RATE));
+        BOOST_REQUIRE_EQUAL(borrowed.size(), 1UL);
+        BOOST_CHECK_EQUAL(num_items_ret, 10 + i%10 - offset);
+        const uint32_t *wire = reinterpret_cast<const uint32_t *>(borrowed[0]);
+        for (size_t j = 0; j < num_items_ret; j++){
+            BOOST_CHECK_EQUAL(wire[j], uint32_t((i << 16) | (j + offset)));
+        }
+        handler.release_borrowed();
+        num_accum_samps += num_items_ret;
+    }
+
+    //subsequent receives should be a timeout
+    BOOST_CHECK_EQUAL(handler.recv_borrowed(borrowed, metadata, 1.0), 0UL);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_recv_one_channel_batched){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16_item32_be";
+    id.num_inputs = 1;
+    id.output_format = "fc32";
+    id.num_outputs = 1;
+
+    mock_zero_copy xport(vrt::if_packet_info_t::LINK_TYPE_VRLP);
+
+    vrt::if_packet_info_t ifpi;
+    ifpi.packet_type = vrt::if_packet_info_t::PACKET_TYPE_DATA;
+    ifpi.num_payload_words32 = 10;
+    ifpi.packet_count = 0;
+    ifpi.sob = true;
+    ifpi.eob = false;
+    ifpi.has_sid = false;
+    ifpi.has_cid = false;
+    ifpi.has_tsi = true;
+    ifpi.has_tsf = true;
+    ifpi.tsi = 0;
+    ifpi.tsf = 0;
+    ifpi.has_tlr = false;
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+    static const size_t GAP_PKT = 20;
+
+    //generate contiguous packets, with a gap in time before GAP_PKT
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        if (i == GAP_PKT) ifpi.tsf += 1000;
+        std::vector<uint32_t> data(ifpi.num_payload_words32, 0);
+        xport.push_back_recv_packet(ifpi, data);
+        ifpi.sob = false;
+        ifpi.packet_count++;
+        ifpi.tsf += ifpi.num_payload_words32*size_t(TICK_RATE/SAMP_RATE);
+    }
+
+    //create the super receive packet handler
+    uhd::transport::sph::recv_packet_handler handler(1);
+    handler.set_vrt_unpacker(&uhd::transport::vrt::if_hdr_unpack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(
+        0,
+        [&xport](double timeout) {
+            return xport.get_recv_buff(timeout);
+        });
+    handler.set_converter(id);
+    handler.set_batch_recv(true);
+
+    //the first call may span packets up to the gap, ending on a fragment
+    std::vector<std::complex<float> > buff(155);
+    uhd::rx_metadata_t metadata;
+    size_t num_samps_ret = handler.recv(
+        &buff.front(), buff.size(), metadata, 1.0, false
+    );
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK(metadata.start_of_burst);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t(0.0));
+    BOOST_CHECK_EQUAL(num_samps_ret, 155UL);
+
+    //the remainder stops at the gap
+    num_samps_ret = handler.recv(
+        &buff.front(), buff.size(), metadata, 1.0, false
+    );
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(metadata.fragment_offset, 5UL);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec, uhd::time_spec_t::from_ticks(155, SAMP_RATE));
+    BOOST_CHECK_EQUAL(num_samps_ret, GAP_PKT*10 - 155);
+
+    //the packet after the gap reports its own time
+    num_samps_ret = handler.recv(
+        &buff.front(), buff.size(), metadata, 1.0, false
+    );
+    BOOST_CHECK_EQUAL(metadata.fragment_offset, 0UL);
+    BOOST_CHECK_TS_CLOSE(metadata.time_spec,
+        uhd::time_spec_t::from_ticks(GAP_PKT*100 + 1000, TICK_RATE));
+    BOOST_CHECK_EQUAL(num_samps_ret, (NUM_PKTS_TO_TEST - GAP_PKT)*10);
+    //the loop ran into the end of the data, which is queued for next time
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+
+    handler.recv(&buff.front(), buff.size(), metadata, 1.0, false);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
@@ -137,3 +137,74 @@ BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_full_buffer_mode){
         num_accum_samps += ifpi.num_payload_words32;
     }
 }
+
+////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(test_sph_send_one_channel_borrowed){
+////////////////////////////////////////////////////////////////////////
+    uhd::convert::id_type id;
+    id.input_format = "sc16";
+    id.num_inputs = 1;
+    id.output_format = "sc16_item32_be";
+    id.num_outputs = 1;
+
+    mock_zero_copy xport(vrt::if_packet_info_t::LINK_TYPE_VRLP);
+
+    static const double TICK_RATE = 100e6;
+    static const double SAMP_RATE = 10e6;
+    static const size_t NUM_PKTS_TO_TEST = 30;
+
+    //create the super send packet handler
+    sph::send_packet_streamer handler(20);
+    handler.set_vrt_packer(&vrt::if_hdr_pack_be);
+    handler.set_tick_rate(TICK_RATE);
+    handler.set_samp_rate(SAMP_RATE);
+    handler.set_xport_chan_get_buff(
+        0,
+        [&xport](double timeout) {
+            return xport.get_send_buff(timeout);
+        }
+    );
+    handler.set_converter(id);
+
+    //nothing borrowed yet
+    BOOST_CHECK_THROW(handler.send_borrowed(1), uhd::runtime_error);
+
+    //write the wire items straight into the transport buffers
+    uhd::tx_streamer::borrowed_buffs_type borrowed;
+    uhd::tx_metadata_t metadata;
+    metadata.has_time_spec = true;
+    metadata.time_spec = uhd::time_spec_t(0.0);
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        metadata.start_of_burst = (i == 0);
+        metadata.end_of_burst = (i == NUM_PKTS_TO_TEST-1);
+        const size_t num_items = handler.borrow_send_buffs(borrowed, metadata, 1.0);
+        BOOST_REQUIRE_EQUAL(num_items, 20UL);
+        BOOST_REQUIRE_EQUAL(borrowed.size(), 1UL);
+        uint32_t *wire = reinterpret_cast<uint32_t *>(borrowed[0]);
+        for (size_t j = 0; j < 10 + i%10; j++){
+            wire[j] = uint32_t(i*100 + j);
+        }
+        const size_t num_sent = handler.send_borrowed(10 + i%10);
+        BOOST_CHECK_EQUAL(num_sent, 10 + i%10);
+        metadata.time_spec += uhd::time_spec_t(0, num_sent, SAMP_RATE);
+    }
+
+    //check the sent packets
+    size_t num_accum_samps = 0;
+    vrt::if_packet_info_t ifpi;
+    std::vector<uint32_t> payload;
+    for (size_t i = 0; i < NUM_PKTS_TO_TEST; i++){
+        std::cout << "data check " << i << std::endl;
+        xport.pop_send_packet(ifpi, &payload);
+        BOOST_CHECK_EQUAL(ifpi.num_payload_words32, 10+i%10);
+        BOOST_CHECK(ifpi.has_tsf);
+        BOOST_CHECK_EQUAL(ifpi.tsf, num_accum_samps*TICK_RATE/SAMP_RATE);
+        BOOST_CHECK_EQUAL(ifpi.sob, i == 0);
+        BOOST_CHECK_EQUAL(ifpi.eob, i == NUM_PKTS_TO_TEST-1);
+        BOOST_CHECK_EQUAL(ifpi.packet_count, i & 0xf);
+        for (size_t j = 0; j < payload.size(); j++){
+            BOOST_CHECK_EQUAL(payload[j], uint32_t(i*100 + j));
+        }
+        num_accum_samps += ifpi.num_payload_words32;
+    }
+}
@@ -0,0 +1,497 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// Streaming benchmark harness. Runs one thread per channel (or per streamer)
+// against a device, the Crimson TNG emulator or in-memory mock transports,
+// sweeps rates, samples per packet, CPU and wire formats, and writes the
+// results of every run as JSON, e.g.
+//   stream_benchmark --mock --rx_channels 0,1 --rates 0,10e6 --cpu fc32,sc16
+
+#include "crimson_tng_emulator.hpp"
+#include "stream_factory.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/types/stream_stats.hpp>
+#include <uhd/usrp/multi_usrp.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/thread.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/chrono/process_cpu_clocks.hpp>
+#include <boost/chrono/thread_clock.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace po = boost::program_options;
+
+namespace {
+    //! Time between setting up the streamers and the first sample
+    constexpr double INIT_DELAY = 1.10;
+
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(const clock_type::time_point &t)
+    {
+        return std::chrono::duration<double>(clock_type::now() - t).count();
+    }
+
+    clock_type::time_point add_seconds(const clock_type::time_point &t, const double secs)
+    {
+        return t + std::chrono::duration_cast<clock_type::duration>(
+            std::chrono::duration<double>(secs));
+    }
+
+    void sleep_seconds(const double secs)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(secs));
+    }
+}
+
+/***********************************************************************
+ * Benchmark threads
+ **********************************************************************/
+struct thread_result_t{
+    thread_result_t(void):
+        cpu_affinity(-1), samples(0), calls(0), active_secs(0.0), cpu_secs(0.0),
+        overflows(0), drops(0), dropped_samples(0), underflows(0),
+        seq_errors(0), timeouts(0), late(0), errors(0)
+    {}
+
+    std::string direction;
+    std::vector<size_t> channels;
+    int cpu_affinity;
+    uint64_t samples;
+    uint64_t calls;
+    //! Time from the start of streaming to the last sample
+    double active_secs;
+    double cpu_secs;
+    uint64_t overflows;
+    uint64_t drops;
+    uint64_t dropped_samples;
+    uint64_t underflows;
+    uint64_t seq_errors;
+    uint64_t timeouts;
+    uint64_t late;
+    uint64_t errors;
+    uhd::duration_histogram_t latency;
+};
+
+//! Account for a recv() or send() call that moved samples
+static void add_call(
+    thread_result_t &result,
+    const clock_type::time_point &t0,
+    const clock_type::time_point &t1,
+    const clock_type::time_point &stream_start,
+    const size_t nsamps
+){
+    result.samples += nsamps;
+    result.calls++;
+    // calls before the start wait for it, their latency means nothing
+    if (t0 < stream_start) return;
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    uhd::duration_histogram_t &hist = result.latency;
+    hist.buckets[uhd::duration_histogram_t::get_bucket(ns)]++;
+    hist.count++;
+    hist.total_ns += ns;
+    hist.max_ns = std::max(hist.max_ns, ns);
+}
+
+static void benchmark_rx(
+    uhd::rx_streamer::sptr rx_stream,
+    const std::string &cpu_format,
+    const uhd::time_spec_t &start_time,
+    const clock_type::time_point &stream_start,
+    const double rate,
+    const std::atomic<bool> &stop,
+    thread_result_t &result
+){
+    uhd::set_thread_priority_safe();
+    const boost::chrono::thread_clock::time_point cpu_start =
+        boost::chrono::thread_clock::now();
+
+    const size_t spp = rx_stream->get_max_num_samps();
+    std::vector<std::vector<char>> buffs(rx_stream->get_num_channels(),
+        std::vector<char>(spp * uhd::convert::get_bytes_per_item(cpu_format)));
+    std::vector<void *> buff_ptrs;
+    for (auto &buff : buffs) buff_ptrs.push_back(&buff.front());
+
+    uhd::stream_cmd_t cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+    cmd.stream_now = false;
+    cmd.time_spec = start_time;
+    rx_stream->issue_stream_cmd(cmd);
+
+    uhd::rx_metadata_t md;
+    double timeout = INIT_DELAY + 0.5;
+    bool stop_called = false;
+    bool had_an_overflow = false;
+    uhd::time_spec_t last_time;
+    clock_type::time_point last_sample;
+    while (true) {
+        if (stop and not stop_called) {
+            rx_stream->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS);
+            stop_called = true;
+            timeout = 0.1;
+        }
+        const auto t0 = clock_type::now();
+        const size_t nsamps = rx_stream->recv(buff_ptrs, spp, md, timeout);
+        const auto t1 = clock_type::now();
+        if (nsamps > 0) {
+            add_call(result, t0, t1, stream_start, nsamps);
+            last_sample = t1;
+            timeout = 0.1;
+        }
+
+        switch (md.error_code) {
+        case uhd::rx_metadata_t::ERROR_CODE_NONE:
+            if (had_an_overflow and rate > 0.0) {
+                had_an_overflow = false;
+                result.dropped_samples += std::max<int64_t>(1,
+                    (md.time_spec - last_time).to_ticks(rate));
+            }
+            if (stop_called and md.end_of_burst) goto done;
+            break;
+        case uhd::rx_metadata_t::ERROR_CODE_OVERFLOW:
+            last_time = md.time_spec;
+            had_an_overflow = true;
+            if (md.out_of_sequence) result.drops++;
+            else result.overflows++;
+            break;
+        case uhd::rx_metadata_t::ERROR_CODE_LATE_COMMAND:
+            result.late++;
+            break;
+        case uhd::rx_metadata_t::ERROR_CODE_TIMEOUT:
+            if (stop_called) goto done;
+            result.timeouts++;
+            break;
+        default:
+            result.errors++;
+            break;
+        }
+    }
+done:
+    if (result.samples > 0 and last_sample > stream_start) {
+        result.active_secs = std::chrono::duration<double>(last_sample - stream_start).count();
+    }
+    result.cpu_secs = boost::chrono::duration<double>(
+        boost::chrono::thread_clock::now() - cpu_start).count();
+}
+
+static void benchmark_tx(
+    uhd::tx_streamer::sptr tx_stream,
+    const std::string &cpu_format,
+    const uhd::time_spec_t &start_time,
+    const clock_type::time_point &stream_start,
+    const std::atomic<bool> &stop,
+    thread_result_t &result
+){
+    uhd::set_thread_priority_safe();
+    const boost::chrono::thread_clock::time_point cpu_start =
+        boost::chrono::thread_clock::now();
+
+    const size_t spp = tx_stream->get_max_num_samps();
+    std::vector<std::vector<char>> buffs(tx_stream->get_num_channels(),
+        std::vector<char>(spp * uhd::convert::get_bytes_per_item(cpu_format)));
+    std::vector<const void *> buff_ptrs;
+    for (auto &buff : buffs) buff_ptrs.push_back(&buff.front());
+
+    uhd::tx_metadata_t md;
+    md.start_of_burst = true;
+    md.has_time_spec = true;
+    md.time_spec = start_time;
+
+    uhd::async_metadata_t async_md;
+    auto count_async_msgs = [&](const double timeout){
+        while (tx_stream->recv_async_msg(async_md, timeout)) {
+            switch (async_md.event_code) {
+            case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
+            case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
+                result.underflows++;
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR:
+            case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR_IN_BURST:
+                result.seq_errors++;
+                break;
+            case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+                result.late++;
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    clock_type::time_point last_sample;
+    double timeout = INIT_DELAY + 0.5;
+    while (not stop) {
+        const auto t0 = clock_type::now();
+        const size_t nsamps = tx_stream->send(buff_ptrs, spp, md, timeout);
+        const auto t1 = clock_type::now();
+        if (nsamps == 0) {
+            result.timeouts++;
+        } else {
+            add_call(result, t0, t1, stream_start, nsamps);
+            last_sample = t1;
+            // before the start, send() blocks until the device buffer drains
+            if (t1 > stream_start) timeout = 0.1;
+        }
+        md.start_of_burst = false;
+        md.has_time_spec = false;
+        count_async_msgs(0.0);
+    }
+
+    md.end_of_burst = true;
+    tx_stream->send(buff_ptrs, 0, md, 0.1);
+    count_async_msgs(0.1);
+    if (result.samples > 0 and last_sample > stream_start) {
+        result.active_secs = std::chrono::duration<double>(last_sample - stream_start).count();
+    }
+    result.cpu_secs = boost::chrono::duration<double>(
+        boost::chrono::thread_clock::now() - cpu_start).count();
+}
+
+static void set_thread_affinity(std::thread &thread, const int cpu)
+{
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) != 0) {
+        std::cerr << boost::format("Cannot pin a thread to CPU %d") % cpu << std::endl;
+    }
+#else
+    std::cerr << boost::format("Cannot pin a thread to CPU %d on this platform") % cpu
+              << std::endl;
+#endif
+}
+
+/***********************************************************************
+ * JSON output
+ **********************************************************************/
+static std::string json_channels(const std::vector<size_t> &channels)
+{
+    std::vector<std::string> strs;
+    for (const size_t chan : channels) strs.push_back(std::to_string(chan));
+    return "[" + boost::algorithm::join(strs, ",") + "]";
+}
+
+static std::string json_thread(const thread_result_t &r, const double bytes_per_sample)
+{
+    const double msps = r.active_secs > 0.0 ? r.samples / r.active_secs / 1e6 : 0.0;
+    const uhd::duration_histogram_t &l = r.latency;
+    return str(boost::format(
+        "{\"direction\":\"%s\",\"channels\":%s,\"cpu_affinity\":%d,"
+        "\"samples\":%u,\"calls\":%u,\"active_secs\":%.6f,"
+        "\"throughput_msps\":%.6f,\"throughput_mbytes_per_sec\":%.6f,"
+        "\"overflows\":%u,\"drops\":%u,\"dropped_samples\":%u,"
+        "\"underflows\":%u,\"seq_errors\":%u,\"timeouts\":%u,\"late\":%u,\"errors\":%u,"
+        "\"latency_us\":{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,"
+        "\"p999\":%.3f,\"max\":%.3f},"
+        "\"cpu_percent\":%.2f}")
+        % r.direction % json_channels(r.channels) % r.cpu_affinity
+        % r.samples % r.calls % r.active_secs
+        % msps % (msps * bytes_per_sample * r.channels.size())
+        % r.overflows % r.drops % r.dropped_samples
+        % r.underflows % r.seq_errors % r.timeouts % r.late % r.errors
+        % (l.get_mean_ns() / 1e3) % (l.get_percentile_ns(50) / 1e3)
+        % (l.get_percentile_ns(90) / 1e3) % (l.get_percentile_ns(99) / 1e3)
+        % (l.get_percentile_ns(99.9) / 1e3) % (l.max_ns / 1e3)
+        % (r.active_secs > 0.0 ? 100.0 * r.cpu_secs / r.active_secs : 0.0));
+}
+
+template <typename T>
+static std::vector<T> split_list(const std::string &list)
+{
+    std::vector<std::string> strs;
+    boost::split(strs, list, boost::is_any_of("\"', "), boost::token_compress_on);
+    std::vector<T> values;
+    for (const std::string &str : strs) {
+        if (not str.empty()) values.push_back(boost::lexical_cast<T>(str));
+    }
+    return values;
+}
+
+/***********************************************************************
+ * Main code
+ **********************************************************************/
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string args, json_path;
+    std::string rx_channel_list, tx_channel_list, thread_per, affinity_list;
+    std::string rate_list, spp_list, cpu_list, otw_list;
+    double duration;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("args", po::value<std::string>(&args)->default_value(""), "device address args")
+        ("emulate", "run against a Crimson TNG emulator on the loopback interface, in this process")
+        ("mock", "run against in-memory mock transports instead of a device")
+        ("rx_channels", po::value<std::string>(&rx_channel_list)->default_value(""), "RX channels to benchmark, e.g. \"0,1\"")
+        ("tx_channels", po::value<std::string>(&tx_channel_list)->default_value(""), "TX channels to benchmark, e.g. \"0,1\"")
+        ("thread_per", po::value<std::string>(&thread_per)->default_value("channel"), "one thread per \"channel\", or one for all channels of a direction (\"streamer\")")
+        ("affinity", po::value<std::string>(&affinity_list)->default_value(""), "CPUs to pin the streaming threads to, in turn, e.g. \"2,3\"")
+        ("rates", po::value<std::string>(&rate_list)->default_value("1e6"), "sample rates to sweep (0 runs the mock transports unpaced)")
+        ("spp", po::value<std::string>(&spp_list)->default_value("0"), "samples per packet to sweep (0 for the maximum)")
+        ("cpu", po::value<std::string>(&cpu_list)->default_value("fc32"), "CPU formats to sweep")
+        ("otw", po::value<std::string>(&otw_list)->default_value("sc16"), "wire formats to sweep")
+        ("duration", po::value<double>(&duration)->default_value(5.0), "duration of each run, in seconds")
+        ("json", po::value<std::string>(&json_path)->default_value("-"), "file to write the results to, - for stdout")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    const std::vector<size_t> rx_channels = split_list<size_t>(rx_channel_list);
+    const std::vector<size_t> tx_channels = split_list<size_t>(tx_channel_list);
+    if (vm.count("help") or (rx_channels.empty() and tx_channels.empty())) {
+        std::cout << boost::format("UHD Stream Benchmark %s") % desc << std::endl;
+        std::cout <<
+            "    Specify --rx_channels and/or --tx_channels. Each combination of\n"
+            "    rate, spp, CPU and wire format is one run, which streams in both\n"
+            "    directions at once. The results are written as JSON.\n"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (thread_per != "channel" and thread_per != "streamer") {
+        throw uhd::value_error("--thread_per must be \"channel\" or \"streamer\"");
+    }
+    const std::vector<int> affinity = split_list<int>(affinity_list);
+
+    std::string mode = "device";
+    crimson_tng_emulator::sptr emulator;
+    stream_factory::sptr factory;
+    if (vm.count("mock")) {
+        mode = "mock";
+        factory = stream_factory::make_mock();
+    } else {
+        if (vm.count("emulate")) {
+            mode = "emulator";
+            emulator = crimson_tng_emulator::make();
+            if (args.empty()) args = "type=crimson_tng,addr=127.0.0.1";
+        }
+        factory = stream_factory::make_device(uhd::usrp::multi_usrp::make(args));
+    }
+
+    // one streamer per thread
+    std::vector<std::vector<size_t>> rx_groups, tx_groups;
+    for (const auto &dir : {std::make_pair(&rx_channels, &rx_groups),
+                            std::make_pair(&tx_channels, &tx_groups)}) {
+        if (dir.first->empty()) continue;
+        if (thread_per == "streamer") {
+            dir.second->push_back(*dir.first);
+        } else {
+            for (const size_t chan : *dir.first) {
+                dir.second->push_back(std::vector<size_t>(1, chan));
+            }
+        }
+    }
+
+    std::vector<std::string> runs;
+    for (const double rate : split_list<double>(rate_list))
+    for (const size_t spp : split_list<size_t>(spp_list))
+    for (const std::string &cpu : split_list<std::string>(cpu_list))
+    for (const std::string &otw : split_list<std::string>(otw_list)) {
+        if (rate <= 0.0 and mode != "mock") {
+            throw uhd::value_error("Only the mock transports can run unpaced (rate 0)");
+        }
+        std::cerr << boost::format("Running %s at %g sps, spp=%u, %s/%s...")
+            % mode % rate % spp % cpu % otw << std::endl;
+
+        const double rx_rate = factory->set_rx_rate(rate, rx_channels);
+        const double tx_rate = factory->set_tx_rate(rate, tx_channels);
+
+        std::vector<thread_result_t> results(rx_groups.size() + tx_groups.size());
+        std::vector<uhd::rx_streamer::sptr> rx_streams;
+        std::vector<uhd::tx_streamer::sptr> tx_streams;
+        for (size_t i = 0; i < rx_groups.size(); i++) {
+            uhd::stream_args_t stream_args(cpu, otw);
+            stream_args.channels = rx_groups[i];
+            if (spp != 0) stream_args.args["spp"] = std::to_string(spp);
+            rx_streams.push_back(factory->get_rx_stream(stream_args));
+            results[i].direction = "rx";
+            results[i].channels = rx_groups[i];
+        }
+        for (size_t i = 0; i < tx_groups.size(); i++) {
+            uhd::stream_args_t stream_args(cpu, otw);
+            stream_args.channels = tx_groups[i];
+            if (spp != 0) stream_args.args["spp"] = std::to_string(spp);
+            tx_streams.push_back(factory->get_tx_stream(stream_args));
+            results[rx_groups.size() + i].direction = "tx";
+            results[rx_groups.size() + i].channels = tx_groups[i];
+        }
+
+        std::atomic<bool> stop(false);
+        const uhd::time_spec_t start_time =
+            factory->get_time_now() + uhd::time_spec_t(INIT_DELAY);
+        const auto wall_start = clock_type::now();
+        const auto stream_start = add_seconds(wall_start, INIT_DELAY);
+        const boost::chrono::process_cpu_clock::time_point cpu_start =
+            boost::chrono::process_cpu_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < rx_streams.size(); i++) {
+            threads.push_back(std::thread(benchmark_rx, rx_streams[i], cpu,
+                start_time, stream_start, rx_rate, std::cref(stop), std::ref(results[i])));
+        }
+        for (size_t i = 0; i < tx_streams.size(); i++) {
+            threads.push_back(std::thread(benchmark_tx, tx_streams[i], cpu,
+                start_time, stream_start, std::cref(stop), std::ref(results[rx_streams.size() + i])));
+        }
+        for (size_t i = 0; i < threads.size() and not affinity.empty(); i++) {
+            results[i].cpu_affinity = affinity[i % affinity.size()];
+            set_thread_affinity(threads[i], results[i].cpu_affinity);
+        }
+
+        sleep_seconds(INIT_DELAY + duration);
+        stop = true;
+        for (auto &thread : threads) thread.join();
+
+        const double wall_secs = seconds_since(wall_start);
+        const boost::chrono::process_cpu_clock::duration cpu_time =
+            boost::chrono::process_cpu_clock::now() - cpu_start;
+        const double cpu_secs = (cpu_time.count().user + cpu_time.count().system) / 1e9;
+
+        const double bytes_per_sample = uhd::convert::get_bytes_per_item(cpu);
+        std::vector<std::string> thread_jsons;
+        uint64_t rx_samples = 0, tx_samples = 0;
+        for (const thread_result_t &result : results) {
+            thread_jsons.push_back(json_thread(result, bytes_per_sample));
+            (result.direction == "rx" ? rx_samples : tx_samples) +=
+                result.samples * result.channels.size();
+        }
+        runs.push_back(str(boost::format(
+            "{\"rx_rate\":%g,\"tx_rate\":%g,\"spp\":%u,\"cpu\":\"%s\",\"otw\":\"%s\","
+            "\"rx_samples\":%u,\"tx_samples\":%u,\"wall_secs\":%.6f,"
+            "\"process_cpu_percent\":%.2f,\n   \"threads\":[\n    %s]}")
+            % rx_rate % tx_rate % spp % cpu % otw
+            % rx_samples % tx_samples % wall_secs
+            % (100.0 * cpu_secs / wall_secs)
+            % boost::algorithm::join(thread_jsons, ",\n    ")));
+    }
+
+    const std::string json = str(boost::format(
+        "{\"mode\":\"%s\",\"args\":\"%s\",\"duration\":%g,\"thread_per\":\"%s\","
+        "\"runs\":[\n  %s]}\n")
+        % mode % args % duration % thread_per
+        % boost::algorithm::join(runs, ",\n  "));
+    if (json_path == "-") {
+        std::cout << json;
+    } else {
+        std::ofstream out(json_path.c_str());
+        out << json;
+        if (not out) {
+            throw uhd::runtime_error("Cannot write the results to " + json_path);
+        }
+    }
+    return EXIT_SUCCESS;
+}
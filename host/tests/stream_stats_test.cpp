@@ -0,0 +1,141 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/types/stream_stats.hpp>
+#include <uhd/utils/stream_stats_exporter.hpp>
+#include <uhd/exception.hpp>
+#include <uhdlib/utils/stream_stats.hpp>
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE(test_duration_histogram){
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(0), 0);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(1), 0);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(2), 1);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(3), 1);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(1000), 9);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(1024), 10);
+    BOOST_CHECK_EQUAL(uhd::duration_histogram_t::get_bucket(uint64_t(-1)),
+        uhd::duration_histogram_t::NUM_BUCKETS - 1);
+
+    uhd::stream_stats_collector::histogram_t hist;
+    uhd::duration_histogram_t snapshot;
+    hist.get(snapshot);
+    BOOST_CHECK_EQUAL(snapshot.count, 0);
+    BOOST_CHECK_EQUAL(snapshot.get_mean_ns(), 0.0);
+    BOOST_CHECK_EQUAL(snapshot.get_percentile_ns(50), 0);
+
+    // 90 short durations, 10 long ones
+    for (size_t i = 0; i < 90; i++) {
+        hist.add(1000);
+    }
+    for (size_t i = 0; i < 10; i++) {
+        hist.add(100000);
+    }
+    hist.get(snapshot);
+    std::cout << snapshot.to_pp_string() << std::endl;
+    BOOST_CHECK_EQUAL(snapshot.count, 100);
+    BOOST_CHECK_EQUAL(snapshot.total_ns, 90 * 1000 + 10 * 100000);
+    BOOST_CHECK_EQUAL(snapshot.max_ns, 100000);
+    BOOST_CHECK_EQUAL(snapshot.buckets[9], 90);
+    BOOST_CHECK_EQUAL(snapshot.buckets[16], 10);
+    BOOST_CHECK_CLOSE(snapshot.get_mean_ns(), 10900.0, 1e-6);
+    // percentiles are the end of their bucket, clamped to the maximum
+    BOOST_CHECK_EQUAL(snapshot.get_percentile_ns(50), 1024);
+    BOOST_CHECK_EQUAL(snapshot.get_percentile_ns(90), 1024);
+    BOOST_CHECK_EQUAL(snapshot.get_percentile_ns(91), 100000);
+    BOOST_CHECK_EQUAL(snapshot.get_percentile_ns(100), 100000);
+}
+
+BOOST_AUTO_TEST_CASE(test_stats_collector){
+    uhd::stream_stats_collector collector;
+    collector.packets.add(3);
+    collector.bytes.add(3 * 1500);
+    collector.samples.add(1000);
+
+    uhd::async_metadata_t md;
+    md.event_code = uhd::async_metadata_t::EVENT_CODE_UNDERFLOW;
+    collector.count_async_msg(md);
+    md.event_code = uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET;
+    collector.count_async_msg(md);
+    md.event_code = uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR;
+    collector.count_async_msg(md);
+    md.event_code = uhd::async_metadata_t::EVENT_CODE_TIME_ERROR;
+    collector.count_async_msg(md);
+    md.event_code = uhd::async_metadata_t::EVENT_CODE_BURST_ACK;
+    collector.count_async_msg(md);
+
+    const uhd::stream_stats_t stats = collector.get();
+    std::cout << stats.to_pp_string();
+    BOOST_CHECK_EQUAL(stats.packets, 3);
+    BOOST_CHECK_EQUAL(stats.bytes, 4500);
+    BOOST_CHECK_EQUAL(stats.samples, 1000);
+    BOOST_CHECK_EQUAL(stats.underflows, 2);
+    BOOST_CHECK_EQUAL(stats.sequence_errors, 1);
+    BOOST_CHECK_EQUAL(stats.late, 1);
+    BOOST_CHECK_EQUAL(stats.overflows, 0);
+}
+
+/***********************************************************************
+ * A streamer which only has counters
+ **********************************************************************/
+class stats_only_rx_streamer : public uhd::rx_streamer{
+public:
+    size_t get_num_channels(void) const{ return 1; }
+    size_t get_max_num_samps(void) const{ return 0; }
+    size_t recv(const buffs_type &, const size_t, uhd::rx_metadata_t &,
+        const double, const bool){ return 0; }
+    void issue_stream_cmd(const uhd::stream_cmd_t &){}
+    uhd::stream_stats_t get_stats(void) const{ return collector.get(); }
+
+    uhd::stream_stats_collector collector;
+};
+
+BOOST_AUTO_TEST_CASE(test_stats_exporter){
+    const std::string name = str(boost::format("uhd_stream_stats_test_%u")
+        % std::chrono::steady_clock::now().time_since_epoch().count());
+    auto streamer = boost::make_shared<stats_only_rx_streamer>();
+
+    uhd::stream_stats_t stats;
+    BOOST_CHECK_EQUAL(uhd::stream_stats_exporter::read(name, stats), 0);
+    BOOST_CHECK_THROW(
+        uhd::stream_stats_exporter::make(
+            uhd::rx_streamer::sptr(streamer), name, 0.0),
+        uhd::value_error);
+
+    {
+        uhd::stream_stats_exporter::sptr exporter =
+            uhd::stream_stats_exporter::make(
+                uhd::rx_streamer::sptr(streamer), name, 0.05);
+
+        // wait for a few updates while the counters are moving
+        for (size_t i = 0; i < 100 and exporter->get_num_updates() < 3; i++) {
+            streamer->collector.packets.add(1);
+            streamer->collector.call_time.add(2000);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        streamer->collector.overflows.add(1);
+        const uint64_t num_updates = exporter->get_num_updates();
+        BOOST_REQUIRE_GE(num_updates, 3);
+        while (exporter->get_num_updates() == num_updates) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        const uint64_t update = uhd::stream_stats_exporter::read(name, stats);
+        BOOST_CHECK_GT(update, num_updates);
+        BOOST_CHECK_EQUAL(stats.packets, streamer->collector.packets.get());
+        BOOST_CHECK_EQUAL(stats.call_time.count, stats.packets);
+        BOOST_CHECK_EQUAL(stats.call_time.max_ns, 2000);
+        BOOST_CHECK_EQUAL(stats.overflows, 1);
+    }
+
+    // the segment goes away with the exporter
+    BOOST_CHECK_EQUAL(uhd::stream_stats_exporter::read(name, stats), 0);
+}
@@ -7,6 +7,9 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhd/exception.hpp>
+#include <uhdlib/utils/parallel.hpp>
+#include <atomic>
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -26,3 +29,65 @@ BOOST_AUTO_TEST_CASE(tasks_test) {
         test_vec.push_back(uhd::task::make([i](){ test_tasks_sleep(i); }));
     }
 }
+
+BOOST_AUTO_TEST_CASE(run_parallel_test) {
+    static const size_t N_TASKS = 20;
+    static const size_t MAX_THREADS = 4;
+
+    std::vector<size_t> calls(N_TASKS, 0);
+    std::atomic<size_t> running(0), max_running(0);
+    uhd::run_parallel(N_TASKS, MAX_THREADS, [&](const size_t i){
+        const size_t now_running = ++running;
+        size_t prev_max = max_running;
+        while (now_running > prev_max and
+               not max_running.compare_exchange_weak(prev_max, now_running));
+        test_tasks_sleep(2);
+        calls[i]++;
+        running--;
+    });
+    for (size_t i = 0; i < N_TASKS; i++) {
+        BOOST_CHECK_EQUAL(calls[i], 1);
+    }
+    BOOST_CHECK_LE(max_running, MAX_THREADS);
+    BOOST_CHECK_GT(max_running, 1);
+
+    // The first error is passed on to the caller
+    BOOST_CHECK_THROW(
+        uhd::run_parallel(N_TASKS, MAX_THREADS, [](const size_t i){
+            if (i == 3) {
+                throw uhd::value_error("task failed");
+            }
+        }),
+        uhd::value_error
+    );
+    BOOST_CHECK_THROW(
+        uhd::run_parallel(N_TASKS, 1, [](const size_t i){
+            if (i == 3) {
+                throw uhd::value_error("task failed");
+            }
+        }),
+        uhd::value_error
+    );
+}
+
+BOOST_AUTO_TEST_CASE(run_parallel_scaling_test) {
+    // Tasks that mostly wait for a device (like a motherboard setup waiting
+    // for register readbacks) should scale with the number of threads.
+    static const size_t N_TASKS = 8;
+    const auto run_time = [](const size_t max_threads){
+        const auto start = std::chrono::steady_clock::now();
+        uhd::run_parallel(N_TASKS, max_threads, [](const size_t){
+            test_tasks_sleep(20);
+        });
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    };
+
+    const double t_sequential = run_time(1);
+    for (const size_t max_threads : {2, 4, 8}) {
+        const double t_parallel = run_time(max_threads);
+        std::cout << max_threads << " threads: speedup "
+                  << t_sequential / t_parallel << std::endl;
+        BOOST_CHECK_GT(t_sequential / t_parallel, max_threads * 0.5);
+    }
+}
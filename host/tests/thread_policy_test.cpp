@@ -0,0 +1,151 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/utils/thread_policy.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace uhd;
+
+BOOST_AUTO_TEST_CASE(test_thread_policy_args)
+{
+    device_addr_t args;
+    args["thread_args_test_cpus"] = "0-2;5";
+    args["thread_args_test_sched"] = "FIFO";
+    args["thread_args_test_priority"] = "0.5";
+    args["thread_args_other_sched"] = "batch";
+    args["not_a_thread_args_test_cpus"] = "7";
+    thread_policy::update(args);
+
+    const thread_policy::policy_t policy = thread_policy::get_policy("args_test");
+    const std::vector<size_t> cpus = {0, 1, 2, 5};
+    BOOST_CHECK(policy.cpus == cpus);
+    BOOST_CHECK_EQUAL(policy.sched, thread_policy::policy_t::POLICY_FIFO);
+    BOOST_CHECK_EQUAL(policy.priority, 0.5);
+    BOOST_CHECK(thread_policy::get_policy("args_other").cpus.empty());
+    BOOST_CHECK_EQUAL(
+        thread_policy::get_policy("args_other").sched,
+        thread_policy::policy_t::POLICY_BATCH);
+
+    // Malformed values are rejected, and change nothing
+    device_addr_t bad_args;
+    bad_args["thread_args_test_sched"] = "other";
+    bad_args["thread_args_test_cpus"] = "3-1";
+    BOOST_CHECK_THROW(thread_policy::update(bad_args), uhd::value_error);
+    BOOST_CHECK_EQUAL(
+        thread_policy::get_policy("args_test").sched,
+        thread_policy::policy_t::POLICY_FIFO);
+    BOOST_CHECK_THROW(
+        thread_policy::update(device_addr_t("thread_args_test_sched=fast")),
+        uhd::value_error);
+    BOOST_CHECK_THROW(
+        thread_policy::update(device_addr_t("thread_args_test_priority=2")),
+        uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_policy_default)
+{
+    // The default applies to the threads of this process too, keep it harmless
+    thread_policy::policy_t def;
+    def.sched = thread_policy::policy_t::POLICY_OTHER;
+    thread_policy::set_policy("default", def);
+
+    thread_policy::policy_t own;
+    own.cpus = {1};
+    thread_policy::set_policy("default_test", own);
+
+    const thread_policy::policy_t policy = thread_policy::get_policy("default_test");
+    BOOST_CHECK(policy.cpus == own.cpus);
+    BOOST_CHECK_EQUAL(policy.sched, thread_policy::policy_t::POLICY_OTHER);
+    BOOST_CHECK_EQUAL(
+        thread_policy::get_policy("default_unset").sched,
+        thread_policy::policy_t::POLICY_OTHER);
+
+    thread_policy::set_policy("default", thread_policy::policy_t());
+    BOOST_CHECK_EQUAL(
+        thread_policy::get_policy("default_unset").sched,
+        thread_policy::policy_t::POLICY_INHERIT);
+}
+
+#ifdef __linux__
+namespace {
+    size_t get_allowed_cpu(void)
+    {
+        cpu_set_t cpu_set;
+        sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+        size_t cpu = 0;
+        while (not CPU_ISSET(cpu, &cpu_set)) cpu++;
+        return cpu;
+    }
+
+    bool is_pinned_to(const size_t cpu)
+    {
+        cpu_set_t cpu_set;
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        return CPU_COUNT(&cpu_set) == 1 and CPU_ISSET(cpu, &cpu_set);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_policy_apply)
+{
+    const size_t cpu = get_allowed_cpu();
+    thread_policy::policy_t policy;
+    policy.cpus = {cpu};
+    // Lowering the priority needs no privileges
+    policy.sched = thread_policy::policy_t::POLICY_BATCH;
+    policy.priority = -1.0;
+    thread_policy::set_policy("apply_test", policy);
+
+    bool pinned = false;
+    int sched = -1;
+    int nice = 0;
+    std::thread thread([&](){
+        const thread_policy::scope policy_scope("apply_test");
+        pinned = is_pinned_to(cpu);
+        sched = sched_getscheduler(0);
+        nice = getpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)));
+    });
+    thread.join();
+    BOOST_CHECK(pinned);
+    BOOST_CHECK_EQUAL(sched, SCHED_BATCH);
+    BOOST_CHECK_EQUAL(nice, 19);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_policy_running)
+{
+    const size_t cpu = get_allowed_cpu();
+    std::atomic<bool> entered(false);
+    std::atomic<bool> placed(false);
+    std::atomic<bool> pinned(false);
+    std::thread thread([&](){
+        const thread_policy::scope policy_scope("running_test");
+        entered = true;
+        while (not placed) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pinned = is_pinned_to(cpu);
+    });
+
+    while (not entered) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // A running thread moves when the device args set the policy of its class
+    device_addr_t args;
+    args["thread_running_test_cpus"] = std::to_string(cpu);
+    thread_policy::update(args);
+    placed = true;
+    thread.join();
+    BOOST_CHECK(pinned);
+}
+#endif /* __linux__ */
@@ -7,6 +7,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <uhd/types/time_spec.hpp>
+#include <uhdlib/utils/tick_time.hpp>
 #include <boost/thread.hpp> //sleep
 #include <iostream>
 #include <iomanip>
@@ -101,3 +102,43 @@ BOOST_AUTO_TEST_CASE(test_time_error_irrational_rate)
 
     BOOST_CHECK_EQUAL(err, (long long)(0));
 }
+
+BOOST_AUTO_TEST_CASE(test_tick_time_round_trip)
+{
+    std::cout << "Testing tick time conversions..." << std::endl;
+
+    //integer and irrational rates, with large absolute times
+    const double rates[] = {100e6, 322.265625e6, 1625e3/6.0};
+    for (const double rate : rates){
+        const int64_t ticks_in = int64_t(rate*1360217663.0) + 12345;
+        const uhd::tick_time_t t0(ticks_in, rate);
+        const uhd::time_spec_t ts = t0.to_time_spec();
+        const uhd::tick_time_t t1 = uhd::tick_time_t::from_time_spec(ts, rate);
+        BOOST_CHECK_EQUAL(t1.get_ticks(), ticks_in);
+        BOOST_CHECK(t0 == t1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_tick_time_arithmetic)
+{
+    std::cout << "Testing tick time arithmetic..." << std::endl;
+
+    static const double rate = 322.265625e6;
+    const uhd::tick_time_t start = uhd::tick_time_t::from_time_spec(
+        uhd::time_spec_t(1360217663, 0.25), rate);
+
+    //accumulate many small offsets, no drift allowed
+    uhd::tick_time_t t = start;
+    for (size_t i = 0; i < 100000; i++){
+        t += 363;
+    }
+    BOOST_CHECK_EQUAL(t - start, int64_t(363*100000));
+    BOOST_CHECK(t > start);
+    BOOST_CHECK(start < t);
+    BOOST_CHECK((t - int64_t(363*100000)) == start);
+
+    //the same through time_spec_t round trips
+    const uhd::time_spec_t ts = t.to_time_spec();
+    BOOST_CHECK_EQUAL(
+        uhd::tick_time_t::from_time_spec(ts, rate) - start, int64_t(363*100000));
+}
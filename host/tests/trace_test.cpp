@@ -0,0 +1,166 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <boost/test/unit_test.hpp>
+#include <uhd/utils/trace.hpp>
+#include <uhdlib/utils/trace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace pt = boost::property_tree;
+namespace fs = boost::filesystem;
+
+// The trace points are compiled out unless UHD_TRACE_ENABLE is set, so these
+// tests record through the API behind the macros.
+static const uhd::trace::site_t scope_site =
+    {"test", "scope", uhd::trace::PHASE_COMPLETE};
+static const uhd::trace::site_t instant_site =
+    {"test", "instant", uhd::trace::PHASE_INSTANT};
+static const uhd::trace::site_t counter_site =
+    {"test", "level", uhd::trace::PHASE_COUNTER};
+
+static std::string get_temp_path(void)
+{
+    return (fs::temp_directory_path()
+        / fs::unique_path("uhd_trace_test_%%%%%%%%.json")).string();
+}
+
+//! Load a dump and count its events by name
+static std::map<std::string, size_t> load_trace(
+    const std::string &path, pt::ptree &trace
+){
+    pt::read_json(path, trace);
+    std::map<std::string, size_t> counts;
+    for (const auto &event : trace.get_child("traceEvents")) {
+        if (event.second.get<std::string>("ph") != "M") {
+            counts[event.second.get<std::string>("name")]++;
+        }
+    }
+    return counts;
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_disabled){
+    std::cout << "Trace points compiled in: "
+              << (uhd::trace::is_compiled_in() ? "yes" : "no") << std::endl;
+    uhd::trace::set_enabled(false);
+    uhd::trace::clear();
+    uhd::trace::record(&instant_site, 0, 0);
+    {
+        uhd::trace::scope_t scope(&scope_site);
+    }
+
+    const std::string path = get_temp_path();
+    BOOST_CHECK_EQUAL(uhd::trace::dump(path), 0);
+    pt::ptree trace;
+    BOOST_CHECK(load_trace(path, trace).empty());
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_dump){
+    uhd::trace::set_enabled(true);
+    uhd::trace::clear();
+    {
+        uhd::trace::scope_t scope(&scope_site, 1.5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    uhd::trace::record(&counter_site, 2, 1234, 1.75);
+    uhd::trace::record(&instant_site, 1, 0);
+    std::thread other([](){
+        for (size_t i = 0; i < 10; i++) {
+            uhd::trace::scope_t scope(&scope_site);
+        }
+    });
+    other.join();
+    uhd::trace::set_enabled(false);
+
+    const std::string path = get_temp_path();
+    BOOST_CHECK_EQUAL(uhd::trace::dump(path), 13);
+    pt::ptree trace;
+    std::map<std::string, size_t> counts = load_trace(path, trace);
+    BOOST_CHECK_EQUAL(counts["scope"], 11);
+    BOOST_CHECK_EQUAL(counts["instant"], 1);
+    BOOST_CHECK_EQUAL(counts["level 2"], 1);
+
+    bool found_device_time = false;
+    for (const auto &item : trace.get_child("traceEvents")) {
+        const pt::ptree &event = item.second;
+        const std::string name = event.get<std::string>("name");
+        if (name == "level 2") {
+            BOOST_CHECK_EQUAL(event.get<std::string>("ph"), "C");
+            BOOST_CHECK_EQUAL(event.get<int>("args.value"), 1234);
+            BOOST_CHECK_CLOSE(event.get<double>("args.device_time"), 1.75, 1e-9);
+        }
+        else if (name == "instant") {
+            BOOST_CHECK_EQUAL(event.get<std::string>("ph"), "i");
+            BOOST_CHECK_EQUAL(event.get<int>("args.chan"), 1);
+            BOOST_CHECK(not event.get_child_optional("args.device_time"));
+        }
+        else if (name == "scope" and event.get_child_optional("args.device_time")) {
+            BOOST_CHECK_EQUAL(event.get<std::string>("ph"), "X");
+            BOOST_CHECK_CLOSE(event.get<double>("args.device_time"), 1.5, 1e-9);
+            BOOST_CHECK_GE(event.get<double>("dur"), 1000.0);
+            found_device_time = true;
+        }
+    }
+    BOOST_CHECK(found_device_time);
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_ring_overwrite){
+    uhd::trace::set_enabled(true);
+    uhd::trace::clear();
+    // a new thread gets a new ring, which keeps only the newest events
+    std::thread writer([](){
+        for (size_t i = 0; i < uhd::trace::RING_SIZE + 100; i++) {
+            uhd::trace::record(&counter_site, 0, int64_t(i));
+        }
+    });
+    writer.join();
+    uhd::trace::set_enabled(false);
+
+    const std::string path = get_temp_path();
+    BOOST_CHECK_EQUAL(uhd::trace::dump(path), uhd::trace::RING_SIZE);
+    pt::ptree trace;
+    load_trace(path, trace);
+    int64_t oldest = -1;
+    for (const auto &item : trace.get_child("traceEvents")) {
+        if (item.second.get<std::string>("name") == "level 0") {
+            oldest = item.second.get<int64_t>("args.value");
+            break;
+        }
+    }
+    BOOST_CHECK_EQUAL(oldest, 100);
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_trace_trigger){
+    const std::string path = get_temp_path();
+    uhd::trace::set_enabled(true);
+    uhd::trace::clear();
+    uhd::trace::record(&instant_site, 0, 0);
+
+    const size_t num_dumps = uhd::trace::get_num_trigger_dumps();
+    uhd::trace::trigger("test"); // not armed yet
+    uhd::trace::set_trigger_file(path);
+    uhd::trace::trigger("test");
+    uhd::trace::trigger("test"); // only the first trigger dumps
+    for (size_t i = 0; i < 200 and uhd::trace::get_num_trigger_dumps() == num_dumps; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    BOOST_CHECK_EQUAL(uhd::trace::get_num_trigger_dumps(), num_dumps + 1);
+    uhd::trace::set_trigger_file("");
+    uhd::trace::set_enabled(false);
+
+    pt::ptree trace;
+    BOOST_CHECK_EQUAL(load_trace(path, trace)["instant"], 1);
+    fs::remove(path);
+}
@@ -6,11 +6,13 @@
 //
 
 #include <boost/test/unit_test.hpp>
+#include <uhd/exception.hpp>
 #include <uhd/transport/vrt_if_packet.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <boost/format.hpp>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
 using namespace uhd::transport;
 
@@ -172,3 +174,70 @@ BOOST_AUTO_TEST_CASE(test_with_chdr){
     if_packet_info.num_payload_words32 = 24;
     pack_and_unpack(if_packet_info);
 }
+
+BOOST_AUTO_TEST_CASE(test_batch_with_chdr){
+    static const size_t num_packets = 16;
+    static const size_t max_packet_words32 = 64;
+
+    vrt::if_packet_batch_t tx_batch;
+    tx_batch.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+    tx_batch.resize(num_packets);
+    std::vector<uint32_t> mem(num_packets*max_packet_words32);
+    std::vector<uint32_t *> buffs(num_packets);
+    for (size_t i = 0; i < num_packets; i++){
+        buffs[i] = &mem[i*max_packet_words32];
+        vrt::if_packet_info_t &info = tx_batch.info[i];
+        info.packet_count = (4090 + i) & 0xfff; //wraps in the middle
+        info.has_sid = true;
+        info.sid = 0xabcd0000 | i;
+        info.has_tsf = true;
+        info.tsf = 1000000 + i*24;
+        info.num_payload_words32 = 24;
+        info.num_payload_bytes = 24*sizeof(uint32_t);
+    }
+    vrt::if_hdr_pack_batch_be(&buffs.front(), tx_batch);
+
+    vrt::if_packet_batch_t rx_batch;
+    rx_batch.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+    rx_batch.resize(num_packets);
+    for (size_t i = 0; i < num_packets; i++){
+        rx_batch.info[i].num_packet_words32 = tx_batch.info[i].num_packet_words32;
+    }
+    std::vector<const uint32_t *> const_buffs(buffs.begin(), buffs.end());
+    vrt::if_hdr_unpack_batch_be(&const_buffs.front(), rx_batch);
+
+    for (size_t i = 0; i < num_packets; i++){
+        //batch unpack must agree with the single packet unpacker
+        vrt::if_packet_info_t single;
+        single.link_type = vrt::if_packet_info_t::LINK_TYPE_CHDR;
+        single.num_packet_words32 = tx_batch.info[i].num_packet_words32;
+        vrt::if_hdr_unpack_be(buffs[i], single);
+
+        BOOST_CHECK_EQUAL(rx_batch.info[i].num_payload_words32, single.num_payload_words32);
+        BOOST_CHECK_EQUAL(rx_batch.info[i].num_header_words32, single.num_header_words32);
+        BOOST_CHECK_EQUAL(rx_batch.sid[i], tx_batch.info[i].sid);
+        BOOST_CHECK_EQUAL(rx_batch.tsf[i], tx_batch.info[i].tsf);
+        BOOST_CHECK_EQUAL(rx_batch.packet_count[i], tx_batch.info[i].packet_count);
+    }
+
+    //sequence checks over the unpacked batch
+    BOOST_CHECK_EQUAL(vrt::find_sequence_error(rx_batch, 4090), num_packets);
+    BOOST_CHECK_EQUAL(vrt::find_sequence_error(rx_batch, 4089), size_t(0));
+    rx_batch.packet_count[11] += 1;
+    BOOST_CHECK_EQUAL(vrt::find_sequence_error(rx_batch, 4090), size_t(11));
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_bad_header){
+    vrt::if_packet_info_t if_packet_info;
+    if_packet_info.num_payload_words32 = 10;
+    if_packet_info.num_payload_bytes = 40;
+    uint32_t packet_buff[64];
+    vrt::if_hdr_pack_be(packet_buff, if_packet_info);
+
+    vrt::if_packet_batch_t batch;
+    batch.resize(2);
+    batch.info[0].num_packet_words32 = if_packet_info.num_packet_words32;
+    batch.info[1].num_packet_words32 = 2; //truncated packet
+    const uint32_t *buffs[] = {packet_buff, packet_buff};
+    BOOST_CHECK_THROW(vrt::if_hdr_unpack_batch_be(buffs, batch), uhd::value_error);
+}
@@ -0,0 +1,322 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+// Loopback benchmark of the zero-copy transports. Each transport sends CHDR
+// packets to an echo peer on the loopback interface, which plays the device
+// and sends them straight back. Sweeps frame sizes and frame counts, and
+// writes packets/s, Gbit/s, latency percentiles and the transport's system
+// calls per packet of every run as JSON, e.g.
+//   xport_benchmark --xports udp,tcp --frame_sizes 1472,8000 --num_frames 32
+
+#include "udp_common.hpp"
+#include "xport_benchmarker.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/transport/muxed_zero_copy_if.hpp>
+#include <uhd/transport/tcp_zero_copy.hpp>
+#include <uhd/transport/udp_stream_zero_copy.hpp>
+#include <uhd/transport/udp_zero_copy.hpp>
+#include <uhd/transport/zero_copy_recv_offload.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+using namespace uhd::transport;
+
+namespace {
+    //! Stream ID of the packets, the muxed transport classifies by it
+    constexpr uint32_t BENCHMARK_SID = 0x00100020;
+    //! Largest datagram or read of the echo peers
+    constexpr size_t ECHO_BUFF_SIZE = 65536;
+    //! Time the echo peers wait for data before they check for the end
+    constexpr double ECHO_TIMEOUT = 0.1;
+    //! Timeout of the receive offload thread
+    constexpr double OFFLOAD_TIMEOUT = 0.1;
+}
+
+/***********************************************************************
+ * Echo peers, which stand in for the device
+ **********************************************************************/
+class echo_peer : boost::noncopyable {
+public:
+    typedef std::shared_ptr<echo_peer> sptr;
+
+    //! The peers stop their thread before their sockets go away
+    virtual ~echo_peer(void) {}
+
+    //! The port the transport under test sends to
+    virtual uint16_t get_port(void) const = 0;
+
+protected:
+    echo_peer(void): _stop(false) {}
+
+    asio::io_service _io_service;
+    std::atomic<bool> _stop;
+    std::thread _thread;
+};
+
+//! Sends every datagram back to where it came from
+class udp_echo_peer : public echo_peer {
+public:
+    udp_echo_peer(void): _socket(_io_service)
+    {
+        _socket.open(asio::ip::udp::v4());
+        _socket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+        _thread = std::thread([this](){ this->run(); });
+    }
+
+    ~udp_echo_peer(void)
+    {
+        _stop = true;
+        if (_thread.joinable()) _thread.join();
+    }
+
+    uint16_t get_port(void) const
+    {
+        return _socket.local_endpoint().port();
+    }
+
+private:
+    void run(void)
+    {
+        std::vector<char> buff(ECHO_BUFF_SIZE);
+        asio::ip::udp::endpoint sender;
+        while (not _stop) {
+            if (not wait_for_recv_ready(_socket.native_handle(), ECHO_TIMEOUT)) continue;
+            boost::system::error_code ec;
+            const size_t len = _socket.receive_from(asio::buffer(buff), sender, 0, ec);
+            if (ec) continue;
+            _socket.send_to(asio::buffer(buff.data(), len), sender, 0, ec);
+        }
+    }
+
+    asio::ip::udp::socket _socket;
+};
+
+//! Accepts one connection and writes back all the bytes it reads
+class tcp_echo_peer : public echo_peer {
+public:
+    tcp_echo_peer(void): _acceptor(_io_service), _socket(_io_service)
+    {
+        _acceptor.open(asio::ip::tcp::v4());
+        _acceptor.bind(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        _acceptor.listen();
+        _thread = std::thread([this](){ this->run(); });
+    }
+
+    ~tcp_echo_peer(void)
+    {
+        _stop = true;
+        if (_thread.joinable()) _thread.join();
+    }
+
+    uint16_t get_port(void) const
+    {
+        return _acceptor.local_endpoint().port();
+    }
+
+private:
+    void run(void)
+    {
+        while (not _stop and not wait_for_recv_ready(_acceptor.native_handle(), ECHO_TIMEOUT));
+        if (_stop) return;
+        _acceptor.accept(_socket);
+        _socket.set_option(asio::ip::tcp::no_delay(true));
+
+        std::vector<char> buff(ECHO_BUFF_SIZE);
+        while (not _stop) {
+            if (not wait_for_recv_ready(_socket.native_handle(), ECHO_TIMEOUT)) continue;
+            boost::system::error_code ec;
+            const size_t len = _socket.read_some(asio::buffer(buff), ec);
+            if (ec) return;
+            asio::write(_socket, asio::buffer(buff.data(), len), ec);
+            if (ec) return;
+        }
+    }
+
+    asio::ip::tcp::acceptor _acceptor;
+    asio::ip::tcp::socket _socket;
+};
+
+/***********************************************************************
+ * Transports under test
+ **********************************************************************/
+//! A transport under test, with the peer and wrappers it depends on
+struct xport_setup_t {
+    echo_peer::sptr peer;
+    muxed_zero_copy_if::sptr muxer;
+    zero_copy_if::sptr xport;
+};
+
+static uint32_t classify_chdr_sid(void *buff, size_t size)
+{
+    if (size < 2*sizeof(uint32_t)) return 0;
+    return uhd::wtohx(static_cast<const uint32_t *>(buff)[1]);
+}
+
+static xport_setup_t make_xport(
+    const std::string &name,
+    const size_t frame_size,
+    const size_t num_frames
+){
+    zero_copy_xport_params params;
+    params.recv_frame_size = frame_size;
+    params.send_frame_size = frame_size;
+    params.num_recv_frames = num_frames;
+    params.num_send_frames = num_frames;
+    udp_zero_copy::buff_params buff_params;
+
+    xport_setup_t setup;
+    if (name == "tcp") {
+        setup.peer = std::make_shared<tcp_echo_peer>();
+        uhd::device_addr_t hints;
+        hints["recv_frame_size"] = std::to_string(frame_size);
+        hints["send_frame_size"] = std::to_string(frame_size);
+        hints["num_recv_frames"] = std::to_string(num_frames);
+        hints["num_send_frames"] = std::to_string(num_frames);
+        setup.xport = tcp_zero_copy::make(
+            "127.0.0.1", std::to_string(setup.peer->get_port()), hints);
+        return setup;
+    }
+
+    setup.peer = std::make_shared<udp_echo_peer>();
+    if (name == "udp_stream") {
+        setup.xport = udp_stream_zero_copy::make(
+            "127.0.0.1", 0, "127.0.0.1", setup.peer->get_port(), params, buff_params);
+        return setup;
+    }
+    zero_copy_if::sptr udp = udp_zero_copy::make(
+        "127.0.0.1", std::to_string(setup.peer->get_port()), params, buff_params);
+    if (name == "udp") {
+        setup.xport = udp;
+    } else if (name == "muxed") {
+        setup.muxer = muxed_zero_copy_if::make(udp, &classify_chdr_sid, 1);
+        setup.xport = setup.muxer->make_stream(BENCHMARK_SID);
+    } else if (name == "recv_offload") {
+        setup.xport = zero_copy_recv_offload::make(udp, OFFLOAD_TIMEOUT);
+    } else {
+        throw uhd::value_error("Unknown transport " + name
+            + ", expected udp, udp_stream, tcp, muxed or recv_offload");
+    }
+    return setup;
+}
+
+/***********************************************************************
+ * JSON output
+ **********************************************************************/
+static std::string json_run(
+    const std::string &name,
+    const size_t frame_size,
+    const size_t num_frames,
+    const size_t window,
+    const xport_benchmarker::results_t &r
+){
+    const uhd::duration_histogram_t &l = r.latency;
+    const double pkts_per_sec = r.rx_packets / r.duration_s;
+    return str(boost::format(
+        "{\"xport\":\"%s\",\"frame_size\":%u,\"num_frames\":%u,\"window\":%u,"
+        "\"duration_secs\":%.6f,\"tx_packets\":%u,\"rx_packets\":%u,"
+        "\"not_received\":%u,\"tx_timeouts\":%u,\"rx_timeouts\":%u,\"data_errors\":%u,"
+        "\"packets_per_sec\":%.1f,\"gbits_per_sec\":%.6f,"
+        "\"latency_us\":{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,"
+        "\"p999\":%.3f,\"max\":%.3f},"
+        "\"syscalls\":{\"send\":%u,\"recv\":%u,\"poll\":%u},"
+        "\"syscalls_per_packet\":{\"tx\":%.3f,\"rx\":%.3f}}")
+        % name % frame_size % num_frames % window
+        % r.duration_s % r.tx_packets % r.rx_packets
+        % (r.tx_packets > r.rx_packets ? r.tx_packets - r.rx_packets : 0)
+        % r.tx_timeouts % r.rx_timeouts % r.data_errors
+        % pkts_per_sec % (r.rx_bytes * 8.0 / r.duration_s / 1e9)
+        % (l.get_mean_ns() / 1e3) % (l.get_percentile_ns(50) / 1e3)
+        % (l.get_percentile_ns(90) / 1e3) % (l.get_percentile_ns(99) / 1e3)
+        % (l.get_percentile_ns(99.9) / 1e3) % (l.max_ns / 1e3)
+        % r.syscalls.send % r.syscalls.recv % r.syscalls.poll
+        % (r.tx_packets ? double(r.syscalls.send) / r.tx_packets : 0.0)
+        % (r.rx_packets ? double(r.syscalls.recv + r.syscalls.poll) / r.rx_packets : 0.0));
+}
+
+template <typename T>
+static std::vector<T> split_list(const std::string &list)
+{
+    std::vector<std::string> strs;
+    boost::split(strs, list, boost::is_any_of("\"', "), boost::token_compress_on);
+    std::vector<T> values;
+    for (const std::string &str : strs) {
+        if (not str.empty()) values.push_back(boost::lexical_cast<T>(str));
+    }
+    return values;
+}
+
+/***********************************************************************
+ * Main code
+ **********************************************************************/
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string xport_list, frame_size_list, num_frames_list, json_path;
+    double duration;
+    size_t window;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("xports", po::value<std::string>(&xport_list)->default_value("udp,udp_stream,tcp,muxed,recv_offload"), "transports to benchmark")
+        ("frame_sizes", po::value<std::string>(&frame_size_list)->default_value("1472,8000"), "frame sizes to sweep, in bytes; each packet fills a frame")
+        ("num_frames", po::value<std::string>(&num_frames_list)->default_value("32"), "numbers of send and receive frames to sweep")
+        ("duration", po::value<double>(&duration)->default_value(2.0), "duration of each run, in seconds")
+        ("window", po::value<size_t>(&window)->default_value(0), "packets in flight at which sending pauses, 0 for no limit")
+        ("json", po::value<std::string>(&json_path)->default_value("-"), "file to write the results to, - for stdout")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Transport Benchmark %s") % desc << std::endl;
+        std::cout <<
+            "    Each combination of transport, frame size and frame count is\n"
+            "    one run. The system calls are those of the transport under test,\n"
+            "    the echo peer is not counted. The results are written as JSON.\n"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> runs;
+    for (const std::string &name : split_list<std::string>(xport_list))
+    for (const size_t frame_size : split_list<size_t>(frame_size_list))
+    for (const size_t num_frames : split_list<size_t>(num_frames_list)) {
+        std::cerr << boost::format("Running %s with %u frames of %u bytes...")
+            % name % num_frames % frame_size << std::endl;
+        xport_setup_t setup = make_xport(name, frame_size, num_frames);
+        xport_benchmarker benchmarker;
+        const xport_benchmarker::results_t &results = benchmarker.benchmark_chdr(
+            setup.xport, setup.xport, BENCHMARK_SID, false,
+            uint32_t(duration*1000), frame_size, window);
+        runs.push_back(json_run(name, frame_size, num_frames, window, results));
+    }
+
+    const std::string json = str(boost::format(
+        "{\"duration\":%g,\"window\":%u,\"runs\":[\n  %s]}\n")
+        % duration % window % boost::algorithm::join(runs, ",\n  "));
+    if (json_path == "-") {
+        std::cout << json;
+    } else {
+        std::ofstream out(json_path.c_str());
+        out << json;
+        if (not out) {
+            throw uhd::runtime_error("Cannot write the results to " + json_path);
+        }
+    }
+    return EXIT_SUCCESS;
+}
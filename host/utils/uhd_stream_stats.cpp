@@ -0,0 +1,79 @@
+//
+// Copyright 2018 Ettus Research, a National Instruments Company
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/stream_stats_exporter.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+namespace po = boost::program_options;
+
+static bool stop_signal_called = false;
+void sig_int_handler(int){stop_signal_called = true;}
+
+int UHD_SAFE_MAIN(int argc, char *argv[]){
+    std::string name;
+    double interval;
+
+    // Program Options
+    po::options_description desc("Allowed Options");
+    desc.add_options()
+        ("help", "help message")
+        ("name", po::value<std::string>(&name), "name of the shared memory segment the application exports to")
+        ("interval", po::value<double>(&interval)->default_value(1.0), "seconds between prints")
+        ("once", "print the counters once and exit")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    // Print the help message
+    if (vm.count("help") or not vm.count("name")){
+        std::cout << boost::format("UHD Stream Stats - %s") % desc << std::endl;
+        std::cout
+            << "Prints the performance counters of a streamer, as exported by"
+            << std::endl
+            << "a uhd::stream_stats_exporter in another process."
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, &sig_int_handler);
+    uint64_t last_update = 0;
+    uhd::stream_stats_t last_stats;
+    auto last_time = std::chrono::steady_clock::now();
+    while (not stop_signal_called){
+        uhd::stream_stats_t stats;
+        const uint64_t update = uhd::stream_stats_exporter::read(name, stats);
+        const auto now = std::chrono::steady_clock::now();
+        if (update == 0){
+            std::cerr << boost::format("No stream stats found in %s.") % name << std::endl;
+        }
+        else if (update != last_update){
+            std::cout << boost::format("-- update %u") % update;
+            if (last_update != 0){
+                const double elapsed = std::chrono::duration<double>(now - last_time).count();
+                std::cout << boost::format(", %.3f kpackets/s, %.3f MB/s")
+                    % ((stats.packets - last_stats.packets) / elapsed / 1e3)
+                    % ((stats.bytes - last_stats.bytes) / elapsed / 1e6);
+            }
+            std::cout << std::endl << stats.to_pp_string() << std::flush;
+            last_update = update;
+            last_stats = stats;
+            last_time = now;
+        }
+        if (vm.count("once")){
+            return update == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(int64_t(interval * 1e6)));
+    }
+    return EXIT_SUCCESS;
+}